@@ -0,0 +1,255 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace SnowEditor
+{
+	static const char* LatencyModeName(const SnowEngine::LatencyMode mode)
+	{
+		switch (mode)
+		{
+		case SnowEngine::LatencyMode::Fifo: return "fifo";
+		case SnowEngine::LatencyMode::Mailbox: return "mailbox";
+		case SnowEngine::LatencyMode::FifoRelaxed: return "fifo relaxed";
+		case SnowEngine::LatencyMode::JustInTime: return "just in time";
+		}
+
+		return "";
+	}
+
+	Benchmark::Benchmark(std::shared_ptr<SnowEngine::Scene> scene, std::shared_ptr<SnowEngine::SceneRenderer> renderer, std::shared_ptr<SnowEngine::Surface> surface, const u32 entityCount, const u32 frameCount)
+		: mScene{ std::move(scene) }, mRenderer{ std::move(renderer) }, mSurface{ std::move(surface) }, mFrameCount{ frameCount }, mInitialLatencyMode{ mSurface->GetLatencyMode() }
+	{
+		MeasurePipelines();
+		MeasureBindings();
+		Populate(entityCount);
+
+		mRenderer->SetDepthPrePass(false);
+		mRenderer->SetSkyboxLast(false);
+	}
+
+	/**
+	 * \brief Collects the renderer statistics of the last frame.
+	 * \return True once every benchmark frame has been recorded.
+	 */
+	b8 Benchmark::Update()
+	{
+		mCurrentFrame++;
+		if (mCurrentFrame <= sWarmupFrames)
+			return false;
+
+		if (mCurrentFrame > sWarmupFrames + mFrameCount)
+		{
+			if (MeasureLatency(mCurrentFrame - sWarmupFrames - mFrameCount - 1))
+				return false;
+
+			mSurface->SetLatencyMode(mInitialLatencyMode);
+			Report();
+			return true;
+		}
+
+		const auto& stats{ mRenderer->Stats() };
+		mTotalDraws += stats.DrawCount;
+		mTotalStateChanges += stats.StateChanges;
+		mTotalRecordTime += stats.RecordTime;
+		mMaxRecordThreads = std::max(mMaxRecordThreads, stats.RecordThreads);
+		mMaxLights = std::max(mMaxLights, stats.Lights);
+		mStaticShadowCascades += stats.StaticShadowCascades;
+		mTotalRenderScale += stats.RenderScale;
+		mMinRenderScale = std::min(mMinRenderScale, stats.RenderScale);
+		mTotalGpuTime += stats.GpuTime;
+		mTotalComputeTime += stats.ComputeTime;
+		mTotalComputeOverlap += stats.ComputeOverlap;
+
+		const u32 measured{ mCurrentFrame - sWarmupFrames };
+		const b8 prePass{ measured > mFrameCount / 2 };
+		if (measured == mFrameCount / 2)
+		{
+			mRenderer->SetDepthPrePass(true);
+			mRenderer->SetSkyboxLast(true);
+		}
+
+		if (FragmentWork& work{ prePass ? mPrePassWork : mBaselineWork }; stats.FragmentInvocations && (!prePass || measured > mFrameCount / 2 + sStatisticsLatency))
+		{
+			work.Invocations += stats.FragmentInvocations;
+			work.Overdraw += stats.Overdraw;
+			work.Frames++;
+		}
+
+		return false;
+	}
+
+	/**
+	 * \brief Creates the renderer pipelines twice, first through an empty cache and then through the persistent one,
+	 * which already holds them from startup. Drivers with their own shader cache may still warm the first round.
+	 */
+	void Benchmark::MeasurePipelines()
+	{
+		const auto measure = [this](PipelineStartup& startup)
+		{
+			const auto before{ SnowEngine::GraphicsCore::PipelineCacheStatistics() };
+			mRenderer->CreatePipelines();
+			const auto after{ SnowEngine::GraphicsCore::PipelineCacheStatistics() };
+
+			startup.Time = after.CreationTime - before.CreationTime;
+			startup.Pipelines = after.Pipelines - before.Pipelines;
+			startup.Hits = after.Hits - before.Hits;
+			mPipelineFeedback = after.Feedback;
+		};
+
+		SnowEngine::GraphicsCore::WaitIdle();
+
+		SnowEngine::GraphicsCore::SetColdPipelineCache(true);
+		measure(mColdPipelines);
+		SnowEngine::GraphicsCore::SetColdPipelineCache(false);
+
+		measure(mWarmPipelines);
+	}
+
+	/**
+	 * \brief Updates the uniforms of a set laid out as the global one, first by name as before handles existed and then
+	 * through handles resolved up front. The copy into the uniform allocator is part of both.
+	 */
+	void Benchmark::MeasureBindings()
+	{
+		std::shared_ptr<SnowEngine::Shader> shader{};
+		if (!SnowEngine::Shader::GetShader("default", shader))
+			return;
+
+		const auto set{ SnowEngine::DescriptorSet::Create(shader, 0, 1) };
+		const std::array<std::string, 3> names{ "Camera", "LightGrid", "DirectionalLight" };
+		std::array<SnowEngine::bindingHandle, names.size()> handles{};
+		for (u32 i{ 0 }; i < names.size(); i++)
+			handles[i] = set->Resolve(names[i]);
+
+		const std::vector<u8> data(4096, 0); //larger than any of the uniforms
+		const auto measure = [](const auto& update)
+		{
+			const auto begin{ std::chrono::steady_clock::now() };
+			for (u32 i{ 0 }; i < sBindingUpdates; i++)
+				update(i);
+
+			return std::chrono::duration<f64, std::nano>(std::chrono::steady_clock::now() - begin).count() / sBindingUpdates;
+		};
+
+		mNamedUpdateTime = measure([&](const u32 i) { set->SetUniform(names[i % names.size()], data.data(), 0); });
+		mHandleUpdateTime = measure([&](const u32 i) { set->SetUniform(handles[i % handles.size()], data.data(), 0); });
+	}
+
+	/**
+	 * \brief Runs every latency mode in turn, the frames queued with the previous mode are left out of the statistics.
+	 * \return False once every mode has been measured.
+	 */
+	b8 Benchmark::MeasureLatency(const u32 frame)
+	{
+		const u32 mode{ frame / sLatencyFrames };
+		if (mode >= sLatencyModes.size())
+			return false;
+
+		const u32 modeFrame{ frame % sLatencyFrames };
+		if (modeFrame == 0)
+		{
+			if (mSurface->SetLatencyMode(sLatencyModes[mode]))
+				mLatency[mode] = SnowEngine::LatencyStats{};
+		}
+		else if (mLatency[mode] && modeFrame == SnowEngine::Surface::sMaxFramesInFlight)
+		{
+			mSurface->ResetLatency();
+		}
+		else if (mLatency[mode] && modeFrame == sLatencyFrames - 1)
+		{
+			mLatency[mode] = mSurface->Latency();
+		}
+
+		return true;
+	}
+
+	void Benchmark::Populate(const u32 entityCount) const
+	{
+		const u32 side{ static_cast<u32>(std::ceil(std::sqrt(static_cast<f32>(entityCount)))) };
+
+		for (u32 i{ 0 }; i < entityCount; i++)
+		{
+			SnowEngine::Entity e = mScene->CreateEntity();
+			e.AddComponent<SnowEngine::Component::Tag>("Benchmark " + std::to_string(i));
+			auto& transform = e.AddComponent<SnowEngine::Component::Transform>();
+			transform.Position = { static_cast<f32>(i % side), 0.0f, static_cast<f32>(i / side) };
+			e.AddComponent<SnowEngine::Component::Mesh>().Static = true;
+
+			//one dynamic light per entity, so the clustered culling works with thousands of lights
+			auto& light = e.AddComponent<SnowEngine::Component::Light>();
+			light.Source.Type = i % 4 ? SnowEngine::LightType::Point : SnowEngine::LightType::Spot;
+			light.Source.Color = { static_cast<f32>(i % 3 == 0), static_cast<f32>(i % 3 == 1), static_cast<f32>(i % 3 == 2) };
+			light.Source.Range = 2.0f;
+		}
+
+		SnowEngine::Entity sun = mScene->CreateEntity();
+		sun.AddComponent<SnowEngine::Component::Tag>("Benchmark sun");
+		sun.AddComponent<SnowEngine::Component::Transform>().Rotation = { glm::radians(-60.0f), glm::radians(30.0f), 0.0f };
+		sun.AddComponent<SnowEngine::Component::Light>().Source.Type = SnowEngine::LightType::Directional;
+	}
+
+	void Benchmark::Report() const
+	{
+		const f64 drawsPerMs{ mTotalRecordTime > 0.0 ? static_cast<f64>(mTotalDraws) / mTotalRecordTime : 0.0 };
+
+		const f64 stateChangesPerFrame{ static_cast<f64>(mTotalStateChanges) / mFrameCount };
+		const f64 renderScale{ mTotalRenderScale / mFrameCount };
+		const f64 gpuTime{ mTotalGpuTime / mFrameCount };
+		const f64 computeTime{ mTotalComputeTime / mFrameCount };
+		const f64 computeOverlap{ mTotalComputeOverlap / mFrameCount };
+		const f64 overlapShare{ mTotalComputeTime > 0.0 ? 100.0 * mTotalComputeOverlap / mTotalComputeTime : 0.0 };
+
+		const auto perFrame = [](const FragmentWork& work, const f64 value) { return work.Frames ? value / work.Frames : 0.0; };
+		const f64 baselineFragments{ perFrame(mBaselineWork, static_cast<f64>(mBaselineWork.Invocations)) };
+		const f64 baselineOverdraw{ perFrame(mBaselineWork, mBaselineWork.Overdraw) };
+		const f64 prePassFragments{ perFrame(mPrePassWork, static_cast<f64>(mPrePassWork.Invocations)) };
+		const f64 prePassOverdraw{ perFrame(mPrePassWork, mPrePassWork.Overdraw) };
+
+		LOG_DEBUG("Benchmark: %u frames, %llu draws, %.3f ms recording, %.1f draws/ms, %.1f state changes/frame, %u recording threads, %u lights, %llu/%llu static shadow cascades rendered, %.3f ms gpu/frame, %.2f render scale (min %.2f)", mFrameCount, mTotalDraws, mTotalRecordTime, drawsPerMs, stateChangesPerFrame, mMaxRecordThreads, mMaxLights, mStaticShadowCascades, static_cast<u64>(mFrameCount) * SnowEngine::CascadedShadowMaps::sCascadeCount, gpuTime, renderScale, mMinRenderScale);
+		LOG_DEBUG("Benchmark: fragments/frame %.0f (%.2f per pixel) skybox first, %.0f (%.2f per pixel) with depth pre-pass and skybox last", baselineFragments, baselineOverdraw, prePassFragments, prePassOverdraw);
+		std::cout << "[Benchmark]: " << mFrameCount << " frames, " << mTotalDraws << " draws, "
+				  << mTotalRecordTime << " ms recording, " << drawsPerMs << " draws/ms, "
+				  << stateChangesPerFrame << " state changes/frame, "
+				  << mMaxRecordThreads << " recording threads, "
+				  << mMaxLights << " lights, "
+				  << mStaticShadowCascades << "/" << mFrameCount * SnowEngine::CascadedShadowMaps::sCascadeCount << " static shadow cascades rendered, "
+				  << gpuTime << " ms gpu/frame, "
+				  << renderScale << " render scale (min " << mMinRenderScale << ")" << std::endl;
+		std::cout << "[Benchmark]: fragments/frame " << baselineFragments << " (" << baselineOverdraw << " per pixel) skybox first, "
+				  << prePassFragments << " (" << prePassOverdraw << " per pixel) with depth pre-pass and skybox last" << std::endl;
+
+		LOG_DEBUG("Benchmark: async compute %.3f ms/frame, %.3f ms/frame (%.1f%%) overlapped with the graphics of the previous frame", computeTime, computeOverlap, overlapShare);
+		std::cout << "[Benchmark]: async compute " << computeTime << " ms/frame, " << computeOverlap << " ms/frame ("
+				  << overlapShare << "%) overlapped with the graphics of the previous frame" << std::endl;
+
+		LOG_DEBUG("Benchmark: %u pipelines, %.3f ms cold (%u cache hits), %.3f ms warm (%u cache hits)%s", mColdPipelines.Pipelines, mColdPipelines.Time, mColdPipelines.Hits, mWarmPipelines.Time, mWarmPipelines.Hits, mPipelineFeedback ? "" : ", hits not reported by the device");
+		std::cout << "[Benchmark]: " << mColdPipelines.Pipelines << " pipelines, " << mColdPipelines.Time << " ms cold ("
+				  << mColdPipelines.Hits << " cache hits), " << mWarmPipelines.Time << " ms warm (" << mWarmPipelines.Hits << " cache hits)"
+				  << (mPipelineFeedback ? "" : ", hits not reported by the device") << std::endl;
+
+		LOG_DEBUG("Benchmark: uniform update %.1f ns by name, %.1f ns by handle", mNamedUpdateTime, mHandleUpdateTime);
+		std::cout << "[Benchmark]: uniform update " << mNamedUpdateTime << " ns by name, " << mHandleUpdateTime << " ns by handle" << std::endl;
+
+		for (u32 i{ 0 }; i < sLatencyModes.size(); i++)
+		{
+			const char* name{ LatencyModeName(sLatencyModes[i]) };
+			if (!mLatency[i])
+			{
+				LOG_DEBUG("Benchmark: latency %s unsupported", name);
+				std::cout << "[Benchmark]: latency " << name << " unsupported" << std::endl;
+				continue;
+			}
+
+			//there is no input without a user, the sample to present latency is measured every frame regardless
+			const auto& latency{ *mLatency[i] };
+			LOG_DEBUG("Benchmark: latency %s, %.3f ms sample to present, %.3f ms input to present (max %.3f, %u frames with input)", name, latency.SampleToPresent, latency.InputToPresent, latency.MaxInputToPresent, latency.InputFrames);
+			std::cout << "[Benchmark]: latency " << name << ", " << latency.SampleToPresent << " ms sample to present, "
+					  << latency.InputToPresent << " ms input to present (max " << latency.MaxInputToPresent << ", "
+					  << latency.InputFrames << " frames with input)" << std::endl;
+		}
+	}
+}
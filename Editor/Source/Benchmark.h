@@ -0,0 +1,75 @@
+#pragma once
+#include <array>
+#include <optional>
+#include <SnowEngine.h>
+
+namespace SnowEditor
+{
+	class Benchmark
+	{
+	public:
+		Benchmark(std::shared_ptr<SnowEngine::Scene> scene, std::shared_ptr<SnowEngine::SceneRenderer> renderer, std::shared_ptr<SnowEngine::Surface> surface, u32 entityCount, u32 frameCount);
+
+		b8 Update();
+
+	private:
+		void Populate(u32 entityCount) const;
+		void MeasurePipelines();
+		void MeasureBindings();
+		b8 MeasureLatency(u32 frame);
+		void Report() const;
+
+		std::shared_ptr<SnowEngine::Scene> mScene;
+		std::shared_ptr<SnowEngine::SceneRenderer> mRenderer;
+		std::shared_ptr<SnowEngine::Surface> mSurface;
+
+		u32 mFrameCount;
+		u32 mCurrentFrame{ 0 };
+		u64 mTotalDraws{ 0 };
+		u64 mTotalStateChanges{ 0 };
+		f64 mTotalRecordTime{ 0.0 };
+		u32 mMaxRecordThreads{ 1 };
+		u32 mMaxLights{ 0 };
+		u64 mStaticShadowCascades{ 0 };
+		f64 mTotalRenderScale{ 0.0 };
+		f32 mMinRenderScale{ 1.0f };
+		f64 mTotalGpuTime{ 0.0 };
+		f64 mTotalComputeTime{ 0.0 };
+		f64 mTotalComputeOverlap{ 0.0 };
+
+		//the first half runs without depth pre-pass and with the skybox first, the second half with both enabled
+		struct FragmentWork
+		{
+			u64 Invocations{ 0 };
+			f64 Overdraw{ 0.0 };
+			u32 Frames{ 0 };
+		};
+		FragmentWork mBaselineWork{};
+		FragmentWork mPrePassWork{};
+
+		//creation of every renderer pipeline, through an empty cache as on a first launch and through the persistent one
+		struct PipelineStartup
+		{
+			f64 Time{ 0.0 };
+			u32 Pipelines{ 0 };
+			u32 Hits{ 0 };
+		};
+		PipelineStartup mColdPipelines{};
+		PipelineStartup mWarmPipelines{};
+		b8 mPipelineFeedback{ false };
+
+		//cpu time of a uniform update of the global set, looked up by name and through a resolved handle, in nanoseconds
+		f64 mNamedUpdateTime{ 0.0 };
+		f64 mHandleUpdateTime{ 0.0 };
+
+		//after the render frames every latency mode runs for sLatencyFrames, empty when the surface does not support it
+		static constexpr std::array sLatencyModes{ SnowEngine::LatencyMode::Fifo, SnowEngine::LatencyMode::Mailbox, SnowEngine::LatencyMode::FifoRelaxed, SnowEngine::LatencyMode::JustInTime };
+		std::array<std::optional<SnowEngine::LatencyStats>, sLatencyModes.size()> mLatency{};
+		SnowEngine::LatencyMode mInitialLatencyMode;
+
+		static constexpr u32 sWarmupFrames{ 16 };
+		static constexpr u32 sStatisticsLatency{ 4 }; //frames whose statistics still come from the previous settings
+		static constexpr u32 sLatencyFrames{ 120 };
+		static constexpr u32 sBindingUpdates{ 1024 }; //of each kind, every update takes room in the uniform allocator of the frame
+	};
+}
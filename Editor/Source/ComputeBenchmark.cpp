@@ -0,0 +1,188 @@
+#include "ComputeBenchmark.h"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+namespace SnowEditor
+{
+	ComputeBenchmark::ComputeBenchmark(const u32 elementCount)
+		: mElementCount{ elementCount }
+	{
+		//the buffers are filled and read back on the graphics queue, running there too avoids ownership transfers
+		mCmd = SnowEngine::CommandBuffer::Create(2, SnowEngine::CommandBufferUsage::Graphics);
+
+		std::mt19937 engine{ 1337 };
+		mKeys.resize(mElementCount);
+		for (auto& key : mKeys)
+			key = engine();
+	}
+
+	void ComputeBenchmark::Run() const
+	{
+		RunPrefixSum();
+		RunStreamCompaction();
+		RunRadixSort();
+		RunHistogram();
+	}
+
+	/**
+	 * \brief Submits the recorded work sIterations times, alternating two frame slots so timestamps are read back
+	 * when a slot is reused.
+	 * \return Average gpu time of one submission in milliseconds.
+	 */
+	f64 ComputeBenchmark::Measure(const std::function<void(const std::shared_ptr<SnowEngine::CommandBuffer>&)>& record) const
+	{
+		const std::vector<SnowEngine::QueueDependency> dependencies{};
+
+		f64 total{ 0.0 };
+		u32 measured{ 0 };
+		for (u32 i{ 0 }; i < sIterations + 2; i++)
+		{
+			const u32 slot{ i % 2 };
+			mCmd->Begin(slot);
+
+			if (f64 begin, end; i >= 2 && mCmd->Timing(slot, begin, end))
+			{
+				total += end - begin;
+				measured++;
+			}
+
+			//the last two submissions are empty, they only retire the timestamps of the previous ones
+			if (i < sIterations)
+			{
+				mCmd->BeginTiming(slot);
+				record(mCmd);
+				mCmd->EndTiming(slot);
+			}
+
+			mCmd->End(slot);
+			mCmd->Submit(slot, dependencies);
+		}
+
+		SnowEngine::GraphicsCore::WaitIdle();
+		return measured ? total / measured : 0.0;
+	}
+
+	void ComputeBenchmark::Report(const char* name, const f64 milliseconds, const b8 valid) const
+	{
+		const f64 elementsPerSecond{ milliseconds > 0.0 ? mElementCount / (milliseconds / 1000.0) : 0.0 };
+
+		LOG_DEBUG("Compute benchmark: %s of %u elements, %.3f ms, %.1f M elements/s, %s", name, mElementCount, milliseconds, elementsPerSecond / 1000000.0, valid ? "valid" : "INVALID");
+		std::cout << "[Compute Benchmark]: " << name << " of " << mElementCount << " elements, " << milliseconds << " ms, "
+				  << elementsPerSecond / 1000000.0 << " M elements/s, " << (valid ? "valid" : "INVALID") << std::endl;
+	}
+
+	void ComputeBenchmark::RunPrefixSum() const
+	{
+		std::vector<u32> values(mElementCount);
+		std::transform(mKeys.begin(), mKeys.end(), values.begin(), [](const u32 key) { return key & 0xFF; });
+
+		const auto input{ SnowEngine::StorageBuffer::Create(mElementCount * sizeof(u32)) };
+		const auto output{ SnowEngine::StorageBuffer::Create(mElementCount * sizeof(u32)) };
+		input->SetData(values.data());
+
+		const SnowEngine::Compute::PrefixSum scan{ input, output, mElementCount };
+		const f64 time{ Measure([&](const auto& cmd) { scan.Record(mElementCount, cmd); }) };
+
+		std::vector<u32> expected(mElementCount);
+		std::exclusive_scan(values.begin(), values.end(), expected.begin(), 0u);
+
+		std::vector<u32> result(mElementCount);
+		output->GetData(result.data());
+
+		const b8 valid{ result == expected };
+		Report("Prefix sum", time, valid);
+	}
+
+	void ComputeBenchmark::RunStreamCompaction() const
+	{
+		std::vector<u32> indices(mElementCount);
+		std::iota(indices.begin(), indices.end(), 0u);
+
+		std::vector<u32> flags(mElementCount);
+		std::transform(mKeys.begin(), mKeys.end(), flags.begin(), [](const u32 key) { return key & 1; });
+
+		const auto input{ SnowEngine::StorageBuffer::Create(mElementCount * sizeof(u32)) };
+		const auto flagBuffer{ SnowEngine::StorageBuffer::Create(mElementCount * sizeof(u32)) };
+		const auto output{ SnowEngine::StorageBuffer::Create(mElementCount * sizeof(u32)) };
+		const auto count{ SnowEngine::StorageBuffer::Create(sizeof(u32)) };
+		input->SetData(indices.data());
+		flagBuffer->SetData(flags.data());
+
+		const SnowEngine::Compute::StreamCompaction compaction{ input, flagBuffer, output, count, mElementCount };
+		const f64 time{ Measure([&](const auto& cmd) { compaction.Record(mElementCount, cmd); }) };
+
+		std::vector<u32> expected{};
+		for (u32 i{ 0 }; i < mElementCount; i++)
+		{
+			if (flags[i])
+				expected.push_back(i);
+		}
+
+		u32 keptCount{ 0 };
+		count->GetData(&keptCount);
+
+		std::vector<u32> result(mElementCount);
+		output->GetData(result.data());
+		result.resize(std::min(keptCount, mElementCount));
+
+		const b8 valid{ keptCount == expected.size() && result == expected };
+		Report("Stream compaction", time, valid);
+	}
+
+	void ComputeBenchmark::RunRadixSort() const
+	{
+		std::vector<u32> values(mElementCount);
+		std::iota(values.begin(), values.end(), 0u);
+
+		const auto keys{ SnowEngine::StorageBuffer::Create(mElementCount * sizeof(u32)) };
+		const auto valueBuffer{ SnowEngine::StorageBuffer::Create(mElementCount * sizeof(u32)) };
+
+		const SnowEngine::Compute::RadixSort sort{ keys, valueBuffer, mElementCount };
+
+		//every iteration sorts the already sorted output, which costs the same as sorting random keys
+		keys->SetData(mKeys.data());
+		valueBuffer->SetData(values.data());
+		const f64 time{ Measure([&](const auto& cmd) { sort.Record(mElementCount, cmd); }) };
+
+		std::vector<u32> order(mElementCount);
+		std::iota(order.begin(), order.end(), 0u);
+		std::stable_sort(order.begin(), order.end(), [&](const u32 a, const u32 b) { return mKeys[a] < mKeys[b]; });
+
+		std::vector<u32> sortedKeys(mElementCount);
+		std::vector<u32> sortedValues(mElementCount);
+		keys->GetData(sortedKeys.data());
+		valueBuffer->GetData(sortedValues.data());
+
+		b8 valid{ true };
+		for (u32 i{ 0 }; i < mElementCount && valid; i++)
+			valid = sortedValues[i] == order[i] && sortedKeys[i] == mKeys[order[i]];
+
+		Report("Radix sort", time, valid);
+	}
+
+	void ComputeBenchmark::RunHistogram() const
+	{
+		constexpr u32 binCount{ 256 };
+		constexpr u32 shift{ 8 };
+
+		const auto keys{ SnowEngine::StorageBuffer::Create(mElementCount * sizeof(u32)) };
+		const auto bins{ SnowEngine::StorageBuffer::Create(binCount * sizeof(u32)) };
+		keys->SetData(mKeys.data());
+
+		const SnowEngine::Compute::Histogram histogram{ keys, bins, binCount };
+		const f64 time{ Measure([&](const auto& cmd) { histogram.Record(mElementCount, shift, cmd); }) };
+
+		std::vector<u32> expected(binCount, 0);
+		for (const u32 key : mKeys)
+			expected[(key >> shift) & (binCount - 1)]++;
+
+		std::vector<u32> result(binCount);
+		bins->GetData(result.data());
+
+		const b8 valid{ result == expected };
+		Report("Histogram", time, valid);
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <functional>
+#include <SnowEngine.h>
+
+namespace SnowEditor
+{
+	/**
+	 * \brief Measures the gpu throughput of the compute primitives in elements per second and checks their results.
+	 */
+	class ComputeBenchmark
+	{
+	public:
+		ComputeBenchmark(u32 elementCount);
+
+		void Run() const;
+
+	private:
+		f64 Measure(const std::function<void(const std::shared_ptr<SnowEngine::CommandBuffer>&)>& record) const;
+		void Report(const char* name, f64 milliseconds, b8 valid) const;
+
+		void RunPrefixSum() const;
+		void RunStreamCompaction() const;
+		void RunRadixSort() const;
+		void RunHistogram() const;
+
+		std::shared_ptr<SnowEngine::CommandBuffer> mCmd;
+		std::vector<u32> mKeys;
+		u32 mElementCount;
+
+		static constexpr u32 sIterations{ 32 };
+	};
+}
@@ -1,11 +1,24 @@
 ﻿#include "Editor.h"
 
 #include <chrono>
+#include <cstdlib>
+#include <string_view>
 #include <imgui.h>
 
-int main()
+int main(int argc, char** argv)
 {
-	SnowEditor::Editor editor{};
+	b8 benchmark{ false };
+	u32 framesInFlight{ 2 };
+	for (i32 i{ 1 }; i < argc; i++)
+	{
+		const std::string_view argument{ argv[i] };
+		if (argument == "--benchmark")
+			benchmark = true;
+		else if (argument == "--frames-in-flight" && i + 1 < argc)
+			framesInFlight = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+	}
+
+	SnowEditor::Editor editor{ benchmark, framesInFlight };
 	editor.Run();
 
 	return 0;
@@ -13,12 +26,12 @@ int main()
 
 namespace SnowEditor
 {
-	Editor::Editor()
+	Editor::Editor(const b8 benchmark, const u32 framesInFlight)
 	{
 		SnowEngine::GraphicsCore::Init();
 
 		mWindow = SnowEngine::Window::Create("SnowEngine", 1920, 1080, true, true, true);
-		mSurface = SnowEngine::Surface::Create(mWindow);
+		mSurface = SnowEngine::Surface::Create(mWindow, framesInFlight);
 
 		mScene = std::make_shared<SnowEngine::Scene>();
 
@@ -26,6 +39,7 @@ namespace SnowEditor
 		mSceneRenderer->SetScene(mScene);
 
 		mGui = SnowEngine::Gui::Create(mSurface, mSceneRenderer->GetRenderPass());
+		mRenderGraph = SnowEngine::RenderGraph::Create(mSurface->FramesInFlight());
 
 		mSceneView = new SceneView();
 		mEntityView = new EntityView();
@@ -38,6 +52,21 @@ namespace SnowEditor
 
 		mSceneRenderer->SetCamera(mCamera);
 
+		const auto pipelines{ SnowEngine::GraphicsCore::PipelineCacheStatistics() };
+		if (pipelines.Feedback)
+			LOG_DEBUG("Startup: %u pipelines in %.3f ms, %u pipeline cache hits, %s cache", pipelines.Pipelines, pipelines.CreationTime, pipelines.Hits, pipelines.Loaded ? "warm" : "cold");
+		else
+			LOG_DEBUG("Startup: %u pipelines in %.3f ms, %s cache", pipelines.Pipelines, pipelines.CreationTime, pipelines.Loaded ? "warm" : "cold");
+
+		const auto shaders{ SnowEngine::Shader::CacheStatistics() };
+		LOG_DEBUG("Startup: %u shader stages in %.3f ms, %u shader cache hits", shaders.Stages, shaders.SetupTime, shaders.Hits);
+
+		if (benchmark)
+		{
+			ComputeBenchmark{ 1 << 22 }.Run();
+			mBenchmark = std::make_unique<Benchmark>(mScene, mSceneRenderer, mSurface, 4096, 512);
+		}
+
 		LOG_DEBUG("Sas");
 		LOG_TRACE("PI: %.3f", 3.1415);
 		LOG_TRACE("PI: %.3f", 3.1415);
@@ -50,7 +79,9 @@ namespace SnowEditor
 		delete mSceneView;
 		delete mEntityView;
 
+		mBenchmark.reset();
 		mScene.reset();
+		mRenderGraph.reset();
 		mSceneRenderer.reset();
 		mGui.reset();
 		mSurface.reset();
@@ -67,35 +98,71 @@ namespace SnowEditor
 			currentTime = std::chrono::high_resolution_clock::now();
 			const f32 time = std::chrono::duration<f32, std::chrono::seconds::period>(currentTime - lastTime).count();
 
+			mSurface->Pace();
+			SnowEngine::Window::Update();
+
 			mSurface->Begin();
 
 			mSceneRenderer->Update(time);
 
-			mSceneRenderer->Draw(mSurface);
+			//the compute work of the frame is submitted first and overlaps the graphics still queued for the previous one
+			mSceneRenderer->BeginFrame(mSurface->CurrentFrame());
+
 			auto& sceneBuffer = mSceneRenderer->GetCommandBuffer();
 
-			mGui->Begin(sceneBuffer);
+			BuildRenderGraph();
+			mRenderGraph->Compile(mSurface->CurrentFrame());
+			mRenderGraph->Execute(sceneBuffer);
 
-			ImGui::ShowStyleEditor();
-			ImGui::ShowDemoWindow();
+			mSceneRenderer->EndFrame(mSurface);
 
-			mSceneView->Draw();
+			mSurface->End(sceneBuffer);
 
-			mEntityView->Draw();
+			lastTime = currentTime;
 
-			mLogView->Draw();
+			if (mBenchmark && mBenchmark->Update())
+				break;
+		}
+	}
 
-			mGui->End(sceneBuffer);
+	void Editor::BuildRenderGraph()
+	{
+		mRenderGraph->Reset();
 
-			sceneBuffer->End(mSurface->CurrentFrame());
+		const auto sceneColor = mRenderGraph->ImportImage("SceneColor", mSceneRenderer->GetRenderPass()->ColorImage(mSurface->CurrentFrame()));
+		const auto backbuffer = mRenderGraph->ImportImage("Backbuffer", nullptr); //synchronized by the surface semaphores
 
-			sceneBuffer->Submit(mSurface->CurrentFrame(), mSurface);
+		mSceneRenderer->AddShadowPasses(*mRenderGraph, mSurface->CurrentFrame());
 
-			mSurface->End(sceneBuffer);
+		mRenderGraph->AddPass("Scene", [&](SnowEngine::RenderGraphBuilder& builder)
+		{
+			mSceneRenderer->DeclareSceneReads(builder);
+			builder.Write(sceneColor, SnowEngine::ResourceUsage::ColorAttachment);
+		},
+		[this](const std::shared_ptr<SnowEngine::CommandBuffer>&)
+		{
+			mSceneRenderer->Draw(mSurface);
+		});
 
-			SnowEngine::Window::Update();
+		mRenderGraph->AddPass("Gui", [&](SnowEngine::RenderGraphBuilder& builder)
+		{
+			builder.Read(sceneColor, SnowEngine::ResourceUsage::ShaderRead);
+			builder.Write(backbuffer, SnowEngine::ResourceUsage::ColorAttachment);
+		},
+		[this](const std::shared_ptr<SnowEngine::CommandBuffer>& cmd)
+		{
+			mGui->Begin(cmd);
 
-			lastTime = currentTime;
-		}
+			ImGui::ShowStyleEditor();
+			ImGui::ShowDemoWindow();
+
+			mSceneView->Draw();
+
+			mEntityView->Draw();
+
+			mLogView->Draw();
+
+			mGui->End(cmd);
+		});
 	}
 }
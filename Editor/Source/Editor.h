@@ -1,6 +1,8 @@
 ﻿#pragma once
 #include <SnowEngine.h>
 
+#include "Benchmark.h"
+#include "ComputeBenchmark.h"
 #include "EntityView.h"
 #include "LogView.h"
 #include "SceneView.h"
@@ -11,21 +13,26 @@ namespace SnowEditor
 	class Editor
 	{
 	public:
-		Editor();
+		Editor(b8 benchmark = false, u32 framesInFlight = 2);
 		~Editor();
 
 		void Run();
 
 	private:
+		void BuildRenderGraph();
+
 		std::shared_ptr<SnowEngine::Scene> mScene{ nullptr };
 		std::shared_ptr<SnowEngine::Window> mWindow{ nullptr };
 		std::shared_ptr<SnowEngine::Surface> mSurface{ nullptr };
 		
 		std::shared_ptr<SnowEngine::SceneRenderer> mSceneRenderer{ nullptr };
 		std::shared_ptr<SnowEngine::Gui> mGui{ nullptr };
+		std::shared_ptr<SnowEngine::RenderGraph> mRenderGraph{ nullptr };
 
 		std::shared_ptr<EditorCamera> mCamera{ nullptr };
 
+		std::unique_ptr<Benchmark> mBenchmark{ nullptr };
+
 		SceneView* mSceneView;
 		EntityView* mEntityView;
 		LogView* mLogView;
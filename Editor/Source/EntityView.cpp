@@ -28,6 +28,44 @@ namespace SnowEditor
 
 				ImGui::Vec3Slider("Scale   ", transform.Scale, glm::vec3(0.0f), glm::vec3(1.0f));
 			});
+
+			DrawComponent<SnowEngine::Component::Mesh>("Mesh", [](SnowEngine::Component::Mesh& mesh)
+			{
+				ImGui::Checkbox("Static", &mesh.Static);
+				ImGui::Checkbox("Double sided", &mesh.DoubleSided);
+			});
+
+			DrawComponent<SnowEngine::Component::ParticleSystem>("Particle System", [](SnowEngine::Component::ParticleSystem& particles)
+			{
+				auto& emitter{ particles.Emitter };
+
+				ImGui::DragFloat("Emit rate", &emitter.EmitRate, 100.0f, 0.0f, static_cast<f32>(particles.System->MaxParticles()));
+				ImGui::DragFloat("Lifetime", &emitter.Lifetime, 0.01f, 0.01f, 60.0f);
+				ImGui::DragFloat("Size", &emitter.Size, 0.001f, 0.001f, 1.0f);
+				ImGui::DragFloat("Spawn radius", &emitter.SpawnRadius, 0.01f, 0.0f, 100.0f);
+				ImGui::Vec3Slider("Velocity", emitter.Velocity, glm::vec3(0.0f), glm::vec3(1.0f));
+				ImGui::DragFloat("Spread", &emitter.Spread, 0.01f, 0.0f, 100.0f);
+				ImGui::ColorEdit4("Color", &emitter.Color.x);
+			});
+
+			DrawComponent<SnowEngine::Component::Light>("Light", [](SnowEngine::Component::Light& light)
+			{
+				auto& source{ light.Source };
+
+				i32 type{ static_cast<i32>(source.Type) };
+				if (ImGui::Combo("Type", &type, "Point\0Spot\0Directional\0"))
+					source.Type = static_cast<SnowEngine::LightType>(type);
+
+				ImGui::ColorEdit3("Color", &source.Color.x);
+				ImGui::DragFloat("Intensity", &source.Intensity, 0.1f, 0.0f, 1000.0f);
+				if (source.Type != SnowEngine::LightType::Directional)
+					ImGui::DragFloat("Range", &source.Range, 0.1f, 0.01f, 1000.0f);
+				if (source.Type == SnowEngine::LightType::Spot)
+				{
+					ImGui::SliderAngle("Inner angle", &source.InnerAngle, 0.0f, 89.0f);
+					ImGui::SliderAngle("Outer angle", &source.OuterAngle, 0.0f, 89.0f);
+				}
+			});
 		}
 		ImGui::End();
 	}
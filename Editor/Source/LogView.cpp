@@ -54,7 +54,8 @@ namespace SnowEditor
 				ImGui::TableSetupColumn("Count");
 				ImGui::TableHeadersRow();
 
-				for (const auto& [message, severity, file, line, repeatCount] : SnowEngine::Logger::GetMessages())
+				const auto messages = SnowEngine::Logger::GetMessages();
+				for (const auto& [message, severity, file, line, repeatCount] : messages)
 				{
 					b8 show = true;
 					switch (severity)
@@ -20,6 +20,22 @@ namespace SnowEditor
 				e.AddComponent<SnowEngine::Component::Mesh>();//TODO: tmp
 			}
 
+			if (ImGui::Button("Create Particle System"))
+			{
+				SnowEngine::Entity e = mScene->CreateEntity();
+				e.AddComponent<SnowEngine::Component::Tag>("Particle system");
+				e.AddComponent<SnowEngine::Component::Transform>();
+				e.AddComponent<SnowEngine::Component::ParticleSystem>();
+			}
+
+			if (ImGui::Button("Create Light"))
+			{
+				SnowEngine::Entity e = mScene->CreateEntity();
+				e.AddComponent<SnowEngine::Component::Tag>("Light");
+				e.AddComponent<SnowEngine::Component::Transform>();
+				e.AddComponent<SnowEngine::Component::Light>();
+			}
+
 			u32 id{ 0 };
 			mScene->ExecuteSystem([&](const SnowEngine::Entity& e)
 			{
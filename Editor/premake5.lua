@@ -32,4 +32,8 @@ project "SnowEditor"
 
     filter "configurations:Release"
         defines { "NDEBUG" }
-        optimize "On"
\ No newline at end of file
+        optimize "On"
+
+    filter "configurations:Shipping"
+        defines { "NDEBUG" }
+        optimize "On"
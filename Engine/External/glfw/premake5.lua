@@ -95,6 +95,6 @@ project "GLFW"
 		runtime "Debug"
 		symbols "on"
 
-	filter "configurations:Release"
+	filter "configurations:Release or Shipping"
 		runtime "Release"
 		optimize "on"
\ No newline at end of file
@@ -1,13 +1,150 @@
 #version 450
 
+#define LIGHT_SPOT 1.0
+
+struct Light
+{
+    vec4 PositionRange;
+    vec4 ColorIntensity;
+    vec4 DirectionType;
+    vec4 Cone; //cos inner, cos outer, sin outer
+};
+
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec2 uv;
+layout(location = 2) in vec3 worldPosition;
+layout(location = 3) in vec3 normal;
 
 layout(location = 0) out vec4 outColor;
 
+layout (set = 0, binding = 1) uniform LightGrid
+{
+    mat4 View;
+    mat4 InverseProjection;
+    uvec4 Size; //clusters along x, y and z, lights per cluster
+    uvec4 Lights; //first light of the frame, light count
+    vec4 Screen;
+    vec4 Depth; //near, far, slice scale and bias
+    vec4 Ambient;
+} grid;
+
+layout(std430, set = 0, binding = 2) readonly buffer Lights {
+    Light lights[ ];
+};
+
+layout(std430, set = 0, binding = 3) readonly buffer ClusterLights {
+    uint clusterLights[ ];
+};
+
+layout(std430, set = 0, binding = 4) readonly buffer LightIndices {
+    uint lightIndices[ ];
+};
+
+layout (set = 0, binding = 5) uniform DirectionalLight
+{
+    mat4 StaticViewProjection[4];
+    mat4 DynamicViewProjection[4];
+    vec4 Splits; //view depth where every cascade ends
+    vec4 Direction;
+    vec4 Radiance;
+    vec4 TexelSizes; //world size of a static texel in every cascade
+    uvec4 Atlas; //tile size
+} sun;
+
+//cached static casters and the dynamic ones rendered every frame, 2x2 cascades each
+layout (set = 0, binding = 6) uniform sampler2D staticShadows;
+layout (set = 0, binding = 7) uniform sampler2D dynamicShadows;
+
 layout (set = 1, binding = 1) uniform sampler2D albedo;
 
+uint Cluster(float depth)
+{
+    uint slice = uint(max(log(depth) * grid.Depth.z - grid.Depth.w, 0.0));
+    uvec2 tile = uvec2(gl_FragCoord.xy / grid.Screen.xy * vec2(grid.Size.xy));
+
+    tile = min(tile, grid.Size.xy - 1);
+    slice = min(slice, grid.Size.z - 1);
+    return tile.x + tile.y * grid.Size.x + slice * grid.Size.x * grid.Size.y;
+}
+
+vec3 Shade(Light light, vec3 n)
+{
+    vec3 toLight = light.PositionRange.xyz - worldPosition;
+    float distance = length(toLight);
+    vec3 l = toLight / max(distance, 0.0001);
+
+    //inverse square with a window reaching zero at the range, so culling by range loses nothing
+    float window = clamp(1.0 - pow(distance / light.PositionRange.w, 4.0), 0.0, 1.0);
+    float attenuation = window * window / (distance * distance + 1.0);
+
+    if (light.DirectionType.w == LIGHT_SPOT)
+        attenuation *= smoothstep(light.Cone.y, light.Cone.x, dot(-l, light.DirectionType.xyz));
+
+    return light.ColorIntensity.rgb * light.ColorIntensity.a * attenuation * max(dot(n, l), 0.0);
+}
+
+//3x3 pcf inside the tile of the cascade
+float SampleShadow(sampler2D atlas, mat4 viewProjection, uint cascade, vec3 position)
+{
+    vec4 clip = viewProjection * vec4(position, 1.0);
+    vec3 ndc = clip.xyz / clip.w;
+    vec2 uv = ndc.xy * 0.5 + 0.5;
+    if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0))) || ndc.z > 1.0)
+        return 1.0;
+
+    int tile = int(sun.Atlas.x);
+    ivec2 origin = ivec2(cascade % 2, cascade / 2) * tile;
+    ivec2 texel = origin + ivec2(uv * float(tile));
+
+    float lit = 0.0;
+    for (int y = -1; y <= 1; y++)
+    {
+        for (int x = -1; x <= 1; x++)
+        {
+            ivec2 coord = clamp(texel + ivec2(x, y), origin, origin + tile - 1);
+            lit += ndc.z <= texelFetch(atlas, coord, 0).r ? 1.0 : 0.0;
+        }
+    }
+
+    return lit / 9.0;
+}
+
+vec3 ShadeSun(vec3 n, float depth)
+{
+    float diffuse = max(dot(n, -sun.Direction.xyz), 0.0);
+    if (diffuse == 0.0)
+        return vec3(0.0);
+
+    uint cascade = 0;
+    while (cascade < 3 && depth > sun.Splits[cascade])
+        cascade++;
+
+    float shadow = 1.0;
+    if (depth <= sun.Splits[3])
+    {
+        //pushed along the normal by a texel and a half against acne on surfaces at grazing angles
+        vec3 position = worldPosition + n * sun.TexelSizes[cascade] * 1.5;
+        shadow = min(SampleShadow(staticShadows, sun.StaticViewProjection[cascade], cascade, position),
+                     SampleShadow(dynamicShadows, sun.DynamicViewProjection[cascade], cascade, position));
+    }
+
+    return sun.Radiance.rgb * diffuse * shadow;
+}
+
 void main() 
 {
-    outColor = vec4(texture(albedo, uv).rgb, 1.0);
+    vec3 n = normalize(normal);
+    float depth = -(grid.View * vec4(worldPosition, 1.0)).z;
+
+    uint cluster = Cluster(depth);
+    uint count = min(clusterLights[cluster], grid.Size.w);
+
+    vec3 lighting = grid.Ambient.rgb;
+    if (sun.Radiance.rgb != vec3(0.0))
+        lighting += ShadeSun(n, depth);
+
+    for (uint i = 0; i < count; i++)
+        lighting += Shade(lights[grid.Lights.x + lightIndices[cluster * grid.Size.w + i]], n);
+
+    outColor = vec4(texture(albedo, uv).rgb * lighting, 1.0);
 }
\ No newline at end of file
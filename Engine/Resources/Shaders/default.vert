@@ -3,9 +3,15 @@
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 color;
 layout (location = 2) in vec2 inUV;
+layout (location = 3) in vec3 inNormal;
+
+//the depth pre-pass runs this same shader, the shaded pass tests for equal depth and needs the exact same positions
+invariant gl_Position;
 
 layout (location = 0) out vec3 fragColor;
 layout (location = 1) out vec2 uv;
+layout (location = 2) out vec3 worldPosition;
+layout (location = 3) out vec3 normal;
 
 layout (set = 0, binding = 0) uniform Camera
 {
@@ -13,13 +19,17 @@ layout (set = 0, binding = 0) uniform Camera
     mat4 Projection;
 } camera;
 
-layout (set = 1, binding = 0) uniform Transform
+layout (push_constant) uniform Object
 {
-    mat4 Transform;
-} transform;
+    mat4 Model;
+    uint Index;
+} object;
 
 void main() {
-    gl_Position = camera.Projection * camera.View * transform.Transform * vec4(position, 1.0);
+    vec4 world = object.Model * vec4(position, 1.0);
+    gl_Position = camera.Projection * camera.View * world;
     fragColor = color;
     uv = inUV;
+    worldPosition = world.xyz;
+    normal = mat3(object.Model) * inNormal;
 }
\ No newline at end of file
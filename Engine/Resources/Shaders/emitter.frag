@@ -0,0 +1,15 @@
+#version 450
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 uv;
+
+layout(location = 0) out vec4 outColor;
+
+void main() 
+{
+    //round particles without blending, faded ones thin out instead
+    if (dot(uv, uv) > fragColor.a)
+        discard;
+
+    outColor = vec4(fragColor.rgb, 1.0);
+}
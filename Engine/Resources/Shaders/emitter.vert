@@ -0,0 +1,38 @@
+#version 450
+
+struct RenderedParticle {
+    vec4 positionSize;
+    vec4 color;
+};
+
+layout (location = 0) out vec4 fragColor;
+layout (location = 1) out vec2 uv;
+
+layout (set = 0, binding = 0) uniform Camera
+{
+    mat4 View;
+    mat4 Projection;
+} camera;
+
+//the alive particles copied out by this frame's simulation, one instance per entry
+layout(std430, set = 1, binding = 0) readonly buffer Rendered {
+    RenderedParticle rendered[ ];
+};
+
+const vec2 corners[6] = vec2[](
+    vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(0.5, 0.5),
+    vec2(0.5, 0.5), vec2(-0.5, 0.5), vec2(-0.5, -0.5)
+);
+
+void main()
+{
+    RenderedParticle particle = rendered[gl_InstanceIndex];
+    vec2 corner = corners[gl_VertexIndex];
+
+    //billboard in view space so every quad faces the camera
+    vec4 center = camera.View * vec4(particle.positionSize.xyz, 1.0);
+    gl_Position = camera.Projection * (center + vec4(corner * particle.positionSize.w, 0.0, 0.0));
+
+    fragColor = particle.color;
+    uv = corner * 2.0;
+}
@@ -0,0 +1,6 @@
+#version 450
+
+//depth only, nothing to write
+void main()
+{
+}
\ No newline at end of file
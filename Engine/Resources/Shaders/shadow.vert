@@ -0,0 +1,14 @@
+#version 450
+
+layout (location = 0) in vec3 position;
+
+layout (push_constant) uniform Caster
+{
+    mat4 ViewProjection;
+    mat4 Model;
+} caster;
+
+void main()
+{
+    gl_Position = caster.ViewProjection * caster.Model * vec4(position, 1.0);
+}
\ No newline at end of file
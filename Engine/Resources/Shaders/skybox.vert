@@ -14,6 +14,8 @@ layout (set = 0, binding = 0) uniform Camera
 
 void main()
 {
-    gl_Position = camera.Projection * mat4(mat3(camera.View)) * vec4(inPosition, 1.0);
+    //z = w puts the sky on the far plane, it only passes a less or equal test where nothing was drawn
+    vec4 position = camera.Projection * mat4(mat3(camera.View)) * vec4(inPosition, 1.0);
+    gl_Position = position.xyww;
     outTexCoord = inPosition;
 }
\ No newline at end of file
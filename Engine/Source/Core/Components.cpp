@@ -2,6 +2,8 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
 
+#include "Graphics/Rhi/Surface.h"
+
 namespace SnowEngine::Component
 {
 	glm::mat4 Transform::Model() const
@@ -11,20 +13,25 @@ namespace SnowEngine::Component
 			 * glm::scale(glm::mat4{ 1.0f }, Scale);
 	}
 
+	glm::vec3 Transform::Forward() const
+	{
+		return glm::quat{ Rotation } * glm::vec3{ 0.0f, 0.0f, -1.0f };
+	}
+
 	Mesh::Mesh()
 	{
 		const auto image = Image::Create("D:/Dev/SnowEngine/Engine/Resources/Images/sus.png");
 
 		const std::vector<SnowEngine::Vertex> vertices = {
-			{ { -0.5f, -0.5f,  0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f } },
-			{ {  0.5f, -0.5f,  0.0f }, { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f } },
-			{ {  0.5f,  0.5f,  0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f } },
-			{ { -0.5f,  0.5f,  0.0f }, { 1.0f, 1.0f, 1.0f }, { 0.0f, 1.0f } },
-
-			{ { -0.5f, -0.5f, -0.5f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f } },
-			{ {  0.5f, -0.5f, -0.5f }, { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f } },
-			{ {  0.5f,  0.5f, -0.5f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f } },
-			{ { -0.5f,  0.5f, -0.5f }, { 1.0f, 1.0f, 1.0f }, { 0.0f, 1.0f } }
+			{ { -0.5f, -0.5f,  0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+			{ {  0.5f, -0.5f,  0.0f }, { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+			{ {  0.5f,  0.5f,  0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f }, { 0.0f, 0.0f, 1.0f } },
+			{ { -0.5f,  0.5f,  0.0f }, { 1.0f, 1.0f, 1.0f }, { 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f } },
+
+			{ { -0.5f, -0.5f, -0.5f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+			{ {  0.5f, -0.5f, -0.5f }, { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+			{ {  0.5f,  0.5f, -0.5f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f }, { 0.0f, 0.0f, 1.0f } },
+			{ { -0.5f,  0.5f, -0.5f }, { 1.0f, 1.0f, 1.0f }, { 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f } }
 		};
 
 		const std::vector<u32> indices = {
@@ -32,7 +39,12 @@ namespace SnowEngine::Component
 			4, 5, 6, 6, 7, 4
 		};
 
-		Model = std::make_shared<SnowEngine::Mesh>(vertices, indices, 2);
+		Model = std::make_shared<SnowEngine::Mesh>(vertices, indices, Surface::sMaxFramesInFlight); //the surface is not known here
 		Model->SetAlbedo(image);
 	}
+
+	ParticleSystem::ParticleSystem(const u32 maxParticles)
+		: System{ std::make_shared<SnowEngine::ParticleSystem>(maxParticles, Surface::sMaxFramesInFlight) }
+	{
+	}
 }
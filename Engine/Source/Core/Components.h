@@ -2,7 +2,9 @@
 #include <string>
 #include <glm/glm.hpp>
 
+#include "Graphics/ClusteredLighting.h"
 #include "Graphics/Mesh.h"
+#include "Graphics/ParticleSystem.h"
 
 namespace SnowEngine::Component
 {
@@ -13,6 +15,7 @@ namespace SnowEngine::Component
 		glm::vec3 Scale{ 1.0f };
 
 		glm::mat4 Model() const;
+		glm::vec3 Forward() const; //-z rotated by the transform
 	};
 
 	struct Tag
@@ -23,7 +26,22 @@ namespace SnowEngine::Component
 	struct Mesh
 	{
 		std::shared_ptr<SnowEngine::Mesh> Model;
+		b8 Static{ false }; //never moves, its shadows are cached
+		b8 DoubleSided{ false }; //drawn without backface culling
 
 		Mesh();
 	};
+
+	struct ParticleSystem
+	{
+		std::shared_ptr<SnowEngine::ParticleSystem> System;
+		ParticleEmitter Emitter{};
+
+		ParticleSystem(u32 maxParticles = 1 << 20);
+	};
+
+	struct Light
+	{
+		LightSource Source{};
+	};
 }
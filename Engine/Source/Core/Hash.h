@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <type_traits>
+
+#include "Types.h"
+
+namespace SnowEngine
+{
+	/**
+	 * \brief FNV-1a, fed a byte at a time so a key hashes the same however its values are split.
+	 */
+	class Hasher
+	{
+	public:
+		void Mix(const void* data, const u64 size)
+		{
+			for (u64 i{ 0 }; i < size; i++)
+				mHash = (mHash ^ static_cast<const u8*>(data)[i]) * sPrime;
+		}
+
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		void Mix(const T& value) { Mix(&value, sizeof(T)); }
+
+		//terminated so adjacent strings can not shift into each other
+		void Mix(const std::string& string) { Mix(string.c_str(), string.size() + 1); }
+
+		u64 Get() const { return mHash; }
+
+	private:
+		static constexpr u64 sOffset{ 14695981039346656037ull };
+		static constexpr u64 sPrime{ 1099511628211ull };
+
+		u64 mHash{ sOffset };
+	};
+}
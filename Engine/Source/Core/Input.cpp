@@ -6,6 +6,8 @@ namespace SnowEngine
 	std::array<b8, 16> Input::sButtons{ false };
 	glm::vec2 Input::sMousePosition{ 0.0f, 0.0f };
 	glm::vec2 Input::sMouseScroll{ 0.0f, 0.0f };
+	std::chrono::steady_clock::time_point Input::sFirstEvent{};
+	b8 Input::sPendingEvent{ false };
 
 	b8 Input::IsKeyPressed(Key key) { return sKeys[static_cast<u32>(key)]; }
 
@@ -19,11 +21,46 @@ namespace SnowEngine
 
 	f32 Input::GetMouseY() { return sMousePosition.y; }
 
-	void Input::SetKey(Key key, const b8 pressed) { sKeys[static_cast<u32>(key)] = pressed; }
+	b8 Input::TakeFirstEvent(std::chrono::steady_clock::time_point& time)
+	{
+		if (!sPendingEvent)
+			return false;
 
-	void Input::SetButton(Button button, const b8 pressed) { sButtons[static_cast<u32>(button)] = pressed; }
+		time = sFirstEvent;
+		sPendingEvent = false;
+		return true;
+	}
 
-	void Input::SetMousePosition(f32 x, f32 y) { sMousePosition = { x, y }; }
+	void Input::StampEvent()
+	{
+		if (sPendingEvent)
+			return;
 
-	void Input::SetMouseScroll(f32 x, f32 y) { sMouseScroll = { x, y }; }
+		sFirstEvent = std::chrono::steady_clock::now();
+		sPendingEvent = true;
+	}
+
+	void Input::SetKey(Key key, const b8 pressed)
+	{
+		sKeys[static_cast<u32>(key)] = pressed;
+		StampEvent();
+	}
+
+	void Input::SetButton(Button button, const b8 pressed)
+	{
+		sButtons[static_cast<u32>(button)] = pressed;
+		StampEvent();
+	}
+
+	void Input::SetMousePosition(f32 x, f32 y)
+	{
+		sMousePosition = { x, y };
+		StampEvent();
+	}
+
+	void Input::SetMouseScroll(f32 x, f32 y)
+	{
+		sMouseScroll = { x, y };
+		StampEvent();
+	}
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include <array>
+#include <chrono>
 #include <glm/glm.hpp>
 
 #include "Types.h"
@@ -166,7 +167,16 @@ namespace SnowEngine
 		static f32 GetMouseX();
 		static f32 GetMouseY();
 
+		/**
+		 * \brief Time of the first input event received since the last call, the surface takes it to measure how long
+		 * the input waits until the frame that reads it is presented.
+		 * \return False when no event was received.
+		 */
+		static b8 TakeFirstEvent(std::chrono::steady_clock::time_point& time);
+
 	private:
+		static void StampEvent();
+
 		static void SetKey(Key key, b8 pressed);
 
 		static void SetButton(Button button, b8 pressed);
@@ -178,6 +188,8 @@ namespace SnowEngine
 		static std::array<b8, 16> sButtons;
 		static glm::vec2 sMousePosition;
 		static glm::vec2 sMouseScroll;
+		static std::chrono::steady_clock::time_point sFirstEvent;
+		static b8 sPendingEvent;
 
 		friend class Window;
 	};
@@ -1,5 +1,6 @@
 #pragma once
 #include <format>
+#include <mutex>
 #include <queue>
 #include <string>
 
@@ -41,6 +42,8 @@ namespace SnowEngine
 			msg.File = file;
 			msg.Line = line;
 
+			//shaders and pipelines are created on the thread pool
+			std::lock_guard lock{ sMutex };
 			if (!sMessages.empty() && sMessages.front().Message == msg.Message)
 			{
 				sMessages.front().RepeatCount++;
@@ -53,11 +56,19 @@ namespace SnowEngine
 			sMessages.push_front(msg);
 		}
 
-		static const std::deque<LogMessage>& GetMessages() { return sMessages; }
+		/**
+		 * \brief Copies the messages under the lock, other threads keep logging while the caller iterates them.
+		 */
+		static std::deque<LogMessage> GetMessages()
+		{
+			std::lock_guard lock{ sMutex };
+			return sMessages;
+		}
 
 	private:
 		inline static std::deque<LogMessage> sMessages{};
 		inline static u32 sMessageCount = 1024;
+		inline static std::mutex sMutex{};
 	};
 
 #define LOG_TRACE(message, ...) ::SnowEngine::Logger::Log(message, ::SnowEngine::LogSeverity::Trace, __FILE__, __LINE__, __VA_ARGS__)
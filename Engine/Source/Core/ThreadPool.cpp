@@ -0,0 +1,56 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace SnowEngine
+{
+	/**
+	 * \brief Shared pool sized to the hardware, leaving one core to the main thread.
+	 */
+	ThreadPool& ThreadPool::Get()
+	{
+		static ThreadPool pool{ std::max(std::thread::hardware_concurrency(), 2u) - 1 };
+		return pool;
+	}
+
+	ThreadPool::ThreadPool(const u32 threadCount)
+	{
+		mThreads.reserve(threadCount);
+		for (u32 i{ 0 }; i < threadCount; i++)
+			mThreads.emplace_back([this] { WorkerLoop(); });
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock{ mMutex };
+			mStopping = true;
+		}
+		mCondition.notify_all();
+
+		for (auto& thread : mThreads)
+			thread.join();
+	}
+
+	u32 ThreadPool::ThreadCount() const { return static_cast<u32>(mThreads.size()); }
+
+	void ThreadPool::WorkerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock lock{ mMutex };
+				mCondition.wait(lock, [this] { return mStopping || !mJobs.empty(); });
+
+				if (mStopping && mJobs.empty())
+					return;
+
+				job = std::move(mJobs.front());
+				mJobs.pop();
+			}
+
+			job();
+		}
+	}
+}
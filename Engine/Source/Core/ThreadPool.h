@@ -0,0 +1,54 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "Types.h"
+
+namespace SnowEngine
+{
+	class ThreadPool
+	{
+	public:
+		static ThreadPool& Get();
+
+		ThreadPool(u32 threadCount);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		u32 ThreadCount() const;
+
+		template<typename F>
+		auto Submit(F&& func) -> std::future<std::invoke_result_t<F>>
+		{
+			using result = std::invoke_result_t<F>;
+
+			auto task = std::make_shared<std::packaged_task<result()>>(std::forward<F>(func));
+			std::future<result> future{ task->get_future() };
+
+			{
+				std::lock_guard lock{ mMutex };
+				mJobs.emplace([task] { (*task)(); });
+			}
+			mCondition.notify_one();
+
+			return future;
+		}
+
+	private:
+		void WorkerLoop();
+
+		std::vector<std::thread> mThreads;
+		std::queue<std::function<void()>> mJobs;
+		std::mutex mMutex;
+		std::condition_variable mCondition;
+		b8 mStopping{ false };
+	};
+}
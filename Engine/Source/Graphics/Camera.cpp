@@ -40,6 +40,10 @@ namespace SnowEngine
 	glm::mat4 CameraController::View() const { return mCamera.View(); }
 
 	glm::mat4 CameraController::Projection() const { return mCamera.Projection(); }
+
+	f32 CameraController::Near() const { return mCamera.Near(); }
+
+	f32 CameraController::Far() const { return mCamera.Far(); }
 	
 	void FirstPersonCamera::Update(f32 dt)
 	{
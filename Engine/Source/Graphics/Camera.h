@@ -44,6 +44,8 @@ namespace SnowEngine
 
 		virtual glm::mat4 View() const;
 		virtual glm::mat4 Projection() const;
+		virtual f32 Near() const;
+		virtual f32 Far() const;
 
 	protected:
 		Camera mCamera;
@@ -0,0 +1,120 @@
+#include "ClusteredLighting.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Rhi/Shader.h"
+
+namespace SnowEngine
+{
+	ClusteredLighting::ClusteredLighting(const u32 frameCount, const u32 maxLights)
+		: mFrameCount{ frameCount }, mMaxLights{ maxLights }
+	{
+		//the lights are written every frame by the cpu
+		mLights.resize(mFrameCount);
+		mClusterLights.resize(mFrameCount);
+		mLightIndices.resize(mFrameCount);
+		for (u32 i{ 0 }; i < mFrameCount; i++)
+		{
+			mLights[i] = StorageBuffer::Create(mMaxLights * static_cast<u32>(sizeof(GpuLight)), true);
+			mClusterLights[i] = StorageBuffer::Create(sClusterCount * sizeof(u32));
+			mLightIndices[i] = StorageBuffer::Create(sClusterCount * sLightsPerCluster * sizeof(u32));
+		}
+
+		Shader::GetShader("light_culling", mCullingShader);
+
+		mQueued.reserve(mMaxLights);
+		mConstants.Size = { sClustersX, sClustersY, sClustersZ, sLightsPerCluster };
+		mConstants.Ambient = glm::vec4{ 0.15f };
+	}
+
+	u32 ClusteredLighting::MaxLights() const { return mMaxLights; }
+
+	u32 ClusteredLighting::LightCount() const { return static_cast<u32>(mQueued.size()); }
+
+	void ClusteredLighting::SetAmbient(const glm::vec3& ambient) { mConstants.Ambient = glm::vec4{ ambient, 0.0f }; }
+
+	void ClusteredLighting::Clear() { mQueued.clear(); }
+
+	void ClusteredLighting::AddLight(const LightSource& light, const glm::vec3& position, const glm::vec3& direction)
+	{
+		if (mQueued.size() >= mMaxLights)
+			return;
+
+		const f32 outer{ std::clamp(light.OuterAngle, 0.0f, glm::radians(89.0f)) };
+		const f32 inner{ std::min(light.InnerAngle, outer) };
+
+		GpuLight& gpuLight{ mQueued.emplace_back() };
+		gpuLight.PositionRange = glm::vec4{ position, light.Range };
+		gpuLight.ColorIntensity = glm::vec4{ light.Color, light.Intensity };
+		gpuLight.DirectionType = glm::vec4{ glm::normalize(direction), static_cast<f32>(light.Type) };
+		gpuLight.Cone = glm::vec4{ std::cos(inner), std::cos(outer), std::sin(outer), 0.0f };
+	}
+
+	void ClusteredLighting::AddPasses(RenderGraph& graph, const ComputePipeline* pipeline, const glm::mat4& view, const glm::mat4& projection, const f32 nearPlane, const f32 farPlane, const u32 width, const u32 height, const u32 currentFrame)
+	{
+		const u32 lightCount{ LightCount() };
+		if (lightCount)
+			mLights[currentFrame]->Write(mQueued.data(), lightCount * static_cast<u32>(sizeof(GpuLight)), 0);
+
+		const f32 logRatio{ std::log(farPlane / nearPlane) };
+
+		mConstants.View = view;
+		mConstants.InverseProjection = glm::inverse(projection);
+		mConstants.Lights = { 0, lightCount, 0, 0 };
+		mConstants.Screen = { static_cast<f32>(width), static_cast<f32>(height), 0.0f, 0.0f };
+		mConstants.Depth = { nearPlane, farPlane, sClustersZ / logRatio, sClustersZ * std::log(nearPlane) / logRatio };
+
+		//only used by this frame's pass, so it comes from the pools reset when the frame slot begins again
+		const auto set{ DescriptorSet::CreateTransient(mCullingShader, 0, currentFrame) };
+		SetResources(*set, currentFrame);
+		SetUniforms(*set, currentFrame);
+
+		mResources.ClusterLights = graph.ImportBuffer("ClusterLights", mClusterLights[currentFrame].get());
+		mResources.LightIndices = graph.ImportBuffer("LightIndices", mLightIndices[currentFrame].get());
+
+		//runs without lights as well, the counts of the previous frame would be stale otherwise
+		const auto& resources{ mResources };
+		graph.AddPass("LightCulling", [&](RenderGraphBuilder& builder)
+		{
+			builder.Write(resources.ClusterLights, ResourceUsage::StorageWrite);
+			builder.Write(resources.LightIndices, ResourceUsage::StorageWrite);
+		},
+		[pipeline, set, currentFrame](const std::shared_ptr<CommandBuffer>& cmd)
+		{
+			pipeline->BindDescriptorSet(set.get(), currentFrame, cmd);
+			pipeline->Dispatch((sClusterCount + sGroupSize - 1) / sGroupSize, 1, 1, cmd);
+		});
+	}
+
+	void ClusteredLighting::GetSharedBuffers(const u32 currentFrame, std::vector<std::shared_ptr<StorageBuffer>>& buffers) const
+	{
+		buffers.push_back(mLights[currentFrame]);
+		buffers.push_back(mClusterLights[currentFrame]);
+		buffers.push_back(mLightIndices[currentFrame]);
+	}
+
+	void ClusteredLighting::ImportReads(RenderGraph& graph, const u32 currentFrame)
+	{
+		mReadResources.ClusterLights = graph.ImportBuffer("ClusterLights", mClusterLights[currentFrame].get());
+		mReadResources.LightIndices = graph.ImportBuffer("LightIndices", mLightIndices[currentFrame].get());
+	}
+
+	void ClusteredLighting::DeclareReads(RenderGraphBuilder& builder) const
+	{
+		builder.Read(mReadResources.ClusterLights, ResourceUsage::StorageRead);
+		builder.Read(mReadResources.LightIndices, ResourceUsage::StorageRead);
+	}
+
+	void ClusteredLighting::SetResources(DescriptorSet& set, const u32 frameIndex) const
+	{
+		set.SetStorageBuffer("Lights", mLights[frameIndex]);
+		set.SetStorageBuffer("ClusterLights", mClusterLights[frameIndex]);
+		set.SetStorageBuffer("LightIndices", mLightIndices[frameIndex]);
+	}
+
+	void ClusteredLighting::SetUniforms(const DescriptorSet& set, const u32 currentFrame) const
+	{
+		set.SetUniform("LightGrid", &mConstants, currentFrame);
+	}
+}
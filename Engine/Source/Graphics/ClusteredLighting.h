@@ -0,0 +1,115 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "RenderGraph.h"
+#include "Core/Types.h"
+#include "Rhi/Buffers.h"
+#include "Rhi/DescriptorSet.h"
+#include "Rhi/Pipeline.h"
+
+namespace SnowEngine
+{
+	enum class LightType : u32
+	{
+		Point,
+		Spot,
+		Directional //not clustered, a single one casts the cascaded shadows
+	};
+
+	struct LightSource
+	{
+		LightType Type{ LightType::Point };
+		glm::vec3 Color{ 1.0f };
+		f32 Intensity{ 1.0f };
+		f32 Range{ 5.0f }; //the light fades to zero at this distance
+		f32 InnerAngle{ 0.35f }; //radians, spot lights only
+		f32 OuterAngle{ 0.5f };
+	};
+
+	/**
+	 * \brief Clustered forward light culling. The view frustum is split into froxels, tiles in screen space sliced
+	 * exponentially in view depth, and a compute pass bins the lights of the frame into a fixed size index list per
+	 * froxel so the fragment shader only walks the lights that can reach it.
+	 * Every frame slot owns its buffers, so the culling of a frame runs on the compute queue while the graphics queue
+	 * still shades the previous one.
+	 */
+	class ClusteredLighting
+	{
+	public:
+		ClusteredLighting(u32 frameCount, u32 maxLights = 4096);
+
+		ClusteredLighting(const ClusteredLighting&) = delete;
+		ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+		u32 MaxLights() const;
+		u32 LightCount() const;
+
+		void SetAmbient(const glm::vec3& ambient);
+
+		void Clear();
+		/** \brief Queues a light for the current frame, lights past MaxLights are dropped. */
+		void AddLight(const LightSource& light, const glm::vec3& position, const glm::vec3& direction);
+
+		/** \brief Uploads the queued lights and adds the culling pass to a graph recorded on the compute queue. */
+		void AddPasses(RenderGraph& graph, const ComputePipeline* pipeline, const glm::mat4& view, const glm::mat4& projection, f32 nearPlane, f32 farPlane, u32 width, u32 height, u32 currentFrame);
+		/** \brief Appends the buffers of the frame slot the culling hands to the graphics queue. */
+		void GetSharedBuffers(u32 currentFrame, std::vector<std::shared_ptr<StorageBuffer>>& buffers) const;
+		/** \brief Imports the buffers read by the shaded draws into the graph that records them. */
+		void ImportReads(RenderGraph& graph, u32 currentFrame);
+		/** \brief Declares the buffers read by the shaded draws on the pass that records them. */
+		void DeclareReads(RenderGraphBuilder& builder) const;
+
+		/** \brief Binds the light and cluster buffers of a frame slot to a set of a shader that shades with the clusters. */
+		void SetResources(DescriptorSet& set, u32 frameIndex) const;
+		void SetUniforms(const DescriptorSet& set, u32 currentFrame) const;
+
+		static constexpr u32 sClustersX{ 16 };
+		static constexpr u32 sClustersY{ 9 };
+		static constexpr u32 sClustersZ{ 24 };
+		static constexpr u32 sClusterCount{ sClustersX * sClustersY * sClustersZ };
+		static constexpr u32 sLightsPerCluster{ 256 };
+
+	private:
+		struct GpuLight
+		{
+			glm::vec4 PositionRange;
+			glm::vec4 ColorIntensity;
+			glm::vec4 DirectionType;
+			glm::vec4 Cone; //cosine of the inner and outer angles, sine of the outer one
+		};
+
+		struct GridConstants
+		{
+			glm::mat4 View;
+			glm::mat4 InverseProjection;
+			glm::uvec4 Size; //clusters along x, y and z, lights per cluster
+			glm::uvec4 Lights; //first light of the frame, light count
+			glm::vec4 Screen;
+			glm::vec4 Depth; //near, far, slice scale and bias
+			glm::vec4 Ambient;
+		};
+
+		struct GraphResources
+		{
+			RenderGraphResource ClusterLights;
+			RenderGraphResource LightIndices;
+		};
+
+		//of every frame slot
+		std::vector<std::shared_ptr<StorageBuffer>> mLights; //host visible
+		std::vector<std::shared_ptr<StorageBuffer>> mClusterLights; //light count of every cluster
+		std::vector<std::shared_ptr<StorageBuffer>> mLightIndices;
+		std::shared_ptr<Shader> mCullingShader{ nullptr };
+
+		std::vector<GpuLight> mQueued;
+		GridConstants mConstants{};
+		GraphResources mResources{};
+		GraphResources mReadResources{};
+		u32 mFrameCount;
+		u32 mMaxLights;
+
+		static constexpr u32 sGroupSize{ 128 };
+	};
+}
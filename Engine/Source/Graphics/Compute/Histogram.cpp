@@ -0,0 +1,34 @@
+#include "Histogram.h"
+
+#include "Kernels.h"
+#include "Core/Logger.h"
+
+namespace SnowEngine::Compute
+{
+	Histogram::Histogram(const std::shared_ptr<StorageBuffer>& keys, const std::shared_ptr<StorageBuffer>& bins, const u32 binCount)
+		: mBinCount{ binCount }
+	{
+		//the kernel would index its shared counters out of bounds, the histogram records nothing instead
+		if (binCount == 0 || binCount > Kernels::sGroupSize || (binCount & (binCount - 1)) != 0)
+		{
+			LOG_ERROR("Histogram bin count %u is not a power of two up to %u", binCount, Kernels::sGroupSize);
+			return;
+		}
+
+		mPipeline = Kernels::CreatePipeline();
+		mSet = DescriptorSet::Create(Kernels::GetShader(), 0, 1);
+		mSet->SetStorageBuffer("KeysIn", keys);
+		mSet->SetStorageBuffer("Counters", bins);
+	}
+
+	void Histogram::Record(const u32 count, const u32 shift, const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		if (!mPipeline)
+			return;
+
+		Kernels::Dispatch(mPipeline.get(), mSet.get(), Kernel::Clear, mBinCount, 1, cmd);
+
+		if (count)
+			Kernels::Dispatch(mPipeline.get(), mSet.get(), Kernel::Histogram, count, Kernels::BlockCount(count), cmd, shift, mBinCount);
+	}
+}
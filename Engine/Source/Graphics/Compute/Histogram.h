@@ -0,0 +1,29 @@
+#pragma once
+#include <memory>
+
+#include "Core/Types.h"
+#include "Graphics/Rhi/Buffers.h"
+#include "Graphics/Rhi/CommandBuffer.h"
+#include "Graphics/Rhi/DescriptorSet.h"
+#include "Graphics/Rhi/Pipeline.h"
+
+namespace SnowEngine::Compute
+{
+	/**
+	 * \brief Counts the occurrences of a digit of u32 keys, (key >> shift) & (binCount - 1), into binCount u32 counters.
+	 * Every workgroup accumulates in shared memory and adds its counts to the output once.
+	 */
+	class Histogram
+	{
+	public:
+		/** \param binCount Power of two, at most 256, any other value is rejected and Record does nothing. */
+		Histogram(const std::shared_ptr<StorageBuffer>& keys, const std::shared_ptr<StorageBuffer>& bins, u32 binCount);
+
+		void Record(u32 count, u32 shift, const std::shared_ptr<CommandBuffer>& cmd) const;
+
+	private:
+		std::shared_ptr<ComputePipeline> mPipeline;
+		std::shared_ptr<DescriptorSet> mSet;
+		u32 mBinCount;
+	};
+}
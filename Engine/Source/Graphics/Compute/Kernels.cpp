@@ -0,0 +1,44 @@
+#include "Kernels.h"
+
+#include "Graphics/Rhi/Core.h"
+
+namespace SnowEngine::Compute
+{
+	std::shared_ptr<Shader> Kernels::GetShader()
+	{
+		const b8 subgroups{ GraphicsCore::SubgroupOperations() };
+		const std::string name{ subgroups ? "primitives_subgroup" : "primitives" };
+
+		if (std::shared_ptr<Shader> shader; Shader::GetShader(name, shader))
+			return shader;
+
+		ComputeShaderSource source{ { "D:/Dev/SnowEngine/Engine/Resources/Shaders/primitives.comp", ShaderType::Compute } };
+		if (subgroups)
+			source.Defines.emplace_back("USE_SUBGROUPS");
+
+		return Shader::Create(source, name);
+	}
+
+	std::shared_ptr<ComputePipeline> Kernels::CreatePipeline()
+	{
+		return ComputePipeline::Create(GetShader());
+	}
+
+	void Kernels::Dispatch(const ComputePipeline* pipeline, const DescriptorSet* set, const Kernel kernel, const u32 count, const u32 groupCount,
+		const std::shared_ptr<CommandBuffer>& cmd, const u32 shift, const u32 bins)
+	{
+		const Parameters parameters{ static_cast<u32>(kernel), count, shift, bins };
+
+		//the sets of the primitives hold no per frame data
+		pipeline->BindDescriptorSet(set, 0, cmd);
+		pipeline->PushConstants(&parameters, sizeof(Parameters), cmd);
+		pipeline->Dispatch(groupCount, 1, 1, cmd);
+
+		cmd->ComputeBarrier();
+	}
+
+	u32 Kernels::BlockCount(const u32 count)
+	{
+		return (count + sBlockSize - 1) / sBlockSize;
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <memory>
+
+#include "Core/Types.h"
+#include "Graphics/Rhi/CommandBuffer.h"
+#include "Graphics/Rhi/DescriptorSet.h"
+#include "Graphics/Rhi/Pipeline.h"
+#include "Graphics/Rhi/Shader.h"
+
+namespace SnowEngine::Compute
+{
+	enum class Kernel : u32
+	{
+		Scan,
+		Add,
+		Compact,
+		Clear,
+		Histogram,
+		RadixCount,
+		RadixScatter
+	};
+
+	/**
+	 * \brief Access to primitives.comp, the shader holding every kernel of the compute primitives.
+	 * Its descriptor set binds KeysIn, KeysOut, ValuesIn, ValuesOut, Partials and Counters, each kernel uses a subset.
+	 */
+	class Kernels
+	{
+	public:
+		/** \brief Compiles the shader on first use, with subgroup operations when the device supports them. */
+		static std::shared_ptr<Shader> GetShader();
+		static std::shared_ptr<ComputePipeline> CreatePipeline();
+
+		/** \brief Records a kernel followed by a barrier making its writes visible to the next one. */
+		static void Dispatch(const ComputePipeline* pipeline, const DescriptorSet* set, Kernel kernel, u32 count, u32 groupCount,
+			const std::shared_ptr<CommandBuffer>& cmd, u32 shift = 0, u32 bins = 0);
+
+		/** \brief Number of workgroups processing count elements, sBlockSize per workgroup. */
+		static u32 BlockCount(u32 count);
+
+		static constexpr u32 sGroupSize{ 256 };
+		static constexpr u32 sBlockSize{ sGroupSize * 4 };
+
+	private:
+		struct Parameters
+		{
+			u32 Kernel;
+			u32 Count;
+			u32 Shift;
+			u32 Bins;
+		};
+	};
+}
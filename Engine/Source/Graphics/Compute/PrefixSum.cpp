@@ -0,0 +1,55 @@
+#include "PrefixSum.h"
+
+#include <algorithm>
+
+#include "Kernels.h"
+#include "Core/Logger.h"
+
+namespace SnowEngine::Compute
+{
+	PrefixSum::PrefixSum(const std::shared_ptr<StorageBuffer>& input, const std::shared_ptr<StorageBuffer>& output, const u32 maxCount)
+		: mPipeline{ Kernels::CreatePipeline() }, mMaxCount{ maxCount }
+	{
+		const auto shader{ Kernels::GetShader() };
+
+		//level 0 scans the input, every other level scans the block totals of the previous one in place
+		u32 count{ std::max(maxCount, 1u) };
+		do
+		{
+			auto& level{ mLevels.emplace_back() };
+			level.Partials = StorageBuffer::Create(Kernels::BlockCount(count) * sizeof(u32));
+			level.Set = DescriptorSet::Create(shader, 0, 1);
+
+			const b8 first{ mLevels.size() == 1 };
+			level.Set->SetStorageBuffer("KeysIn", first ? input : mLevels[mLevels.size() - 2].Partials);
+			level.Set->SetStorageBuffer("KeysOut", first ? output : mLevels[mLevels.size() - 2].Partials);
+			level.Set->SetStorageBuffer("Partials", level.Partials);
+
+			count = Kernels::BlockCount(count);
+		}
+		while (count > 1);
+	}
+
+	void PrefixSum::Record(const u32 count, const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		if (count > mMaxCount)
+		{
+			LOG_ERROR("Prefix sum of %u elements exceeds its capacity of %u", count, mMaxCount);
+			return;
+		}
+
+		if (count == 0)
+			return;
+
+		std::vector<u32> counts{ count };
+		while (Kernels::BlockCount(counts.back()) > 1)
+			counts.push_back(Kernels::BlockCount(counts.back()));
+
+		for (u32 i{ 0 }; i < counts.size(); i++)
+			Kernels::Dispatch(mPipeline.get(), mLevels[i].Set.get(), Kernel::Scan, counts[i], Kernels::BlockCount(counts[i]), cmd);
+
+		//the partials of the last level hold a single total and need no scan
+		for (u32 i{ static_cast<u32>(counts.size()) - 1 }; i > 0; i--)
+			Kernels::Dispatch(mPipeline.get(), mLevels[i - 1].Set.get(), Kernel::Add, counts[i - 1], Kernels::BlockCount(counts[i - 1]), cmd);
+	}
+}
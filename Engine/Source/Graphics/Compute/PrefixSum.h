@@ -0,0 +1,37 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "Core/Types.h"
+#include "Graphics/Rhi/Buffers.h"
+#include "Graphics/Rhi/CommandBuffer.h"
+#include "Graphics/Rhi/DescriptorSet.h"
+#include "Graphics/Rhi/Pipeline.h"
+
+namespace SnowEngine::Compute
+{
+	/**
+	 * \brief Device wide exclusive prefix sum of u32 elements. Every workgroup scans a block and stores its total,
+	 * the totals are scanned the same way one level up until they fit a single block and are then added back down.
+	 */
+	class PrefixSum
+	{
+	public:
+		/** \param input May be the same buffer as output to scan in place. */
+		PrefixSum(const std::shared_ptr<StorageBuffer>& input, const std::shared_ptr<StorageBuffer>& output, u32 maxCount);
+
+		/** \brief Records the scan of the first count elements, count must not exceed maxCount. */
+		void Record(u32 count, const std::shared_ptr<CommandBuffer>& cmd) const;
+
+	private:
+		struct Level
+		{
+			std::shared_ptr<StorageBuffer> Partials;
+			std::shared_ptr<DescriptorSet> Set;
+		};
+
+		std::shared_ptr<ComputePipeline> mPipeline;
+		std::vector<Level> mLevels;
+		u32 mMaxCount;
+	};
+}
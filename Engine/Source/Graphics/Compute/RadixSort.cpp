@@ -0,0 +1,60 @@
+#include "RadixSort.h"
+
+#include <algorithm>
+
+#include "Kernels.h"
+#include "Core/Logger.h"
+
+namespace SnowEngine::Compute
+{
+	RadixSort::RadixSort(const std::shared_ptr<StorageBuffer>& keys, const std::shared_ptr<StorageBuffer>& values, const u32 maxCount)
+		: mPipeline{ Kernels::CreatePipeline() }, mMaxCount{ maxCount }
+	{
+		const u32 capacity{ std::max(maxCount, 1u) };
+		const u32 digitCounts{ (1u << sRadixBits) * Kernels::BlockCount(capacity) };
+
+		mKeysScratch = StorageBuffer::Create(capacity * sizeof(u32));
+		mValuesScratch = StorageBuffer::Create(capacity * sizeof(u32));
+		mDigitCounts = StorageBuffer::Create(digitCounts * sizeof(u32));
+		mScan = std::make_unique<PrefixSum>(mDigitCounts, mDigitCounts, digitCounts);
+
+		const std::array<std::shared_ptr<StorageBuffer>, 2> keyBuffers{ keys, mKeysScratch };
+		const std::array<std::shared_ptr<StorageBuffer>, 2> valueBuffers{ values, mValuesScratch };
+		for (u32 i{ 0 }; i < 2; i++)
+		{
+			mSets[i] = DescriptorSet::Create(Kernels::GetShader(), 0, 1);
+			mSets[i]->SetStorageBuffer("KeysIn", keyBuffers[i]);
+			mSets[i]->SetStorageBuffer("KeysOut", keyBuffers[1 - i]);
+			mSets[i]->SetStorageBuffer("ValuesIn", valueBuffers[i]);
+			mSets[i]->SetStorageBuffer("ValuesOut", valueBuffers[1 - i]);
+			mSets[i]->SetStorageBuffer("Partials", mDigitCounts);
+		}
+	}
+
+	void RadixSort::Record(const u32 count, const std::shared_ptr<CommandBuffer>& cmd, const u32 keyBits) const
+	{
+		if (count > mMaxCount)
+		{
+			LOG_ERROR("Radix sort of %u elements exceeds its capacity of %u", count, mMaxCount);
+			return;
+		}
+
+		if (count == 0)
+			return;
+
+		//an even number of passes leaves the result in the original buffers, an extra pass over zero digits keeps the order
+		u32 passes{ (std::clamp(keyBits, 1u, 32u) + sRadixBits - 1) / sRadixBits };
+		passes += passes % 2;
+
+		const u32 blockCount{ Kernels::BlockCount(count) };
+		for (u32 pass{ 0 }; pass < passes; pass++)
+		{
+			const auto* set{ mSets[pass % 2].get() };
+			const u32 shift{ pass * sRadixBits };
+
+			Kernels::Dispatch(mPipeline.get(), set, Kernel::RadixCount, count, blockCount, cmd, shift);
+			mScan->Record((1u << sRadixBits) * blockCount, cmd);
+			Kernels::Dispatch(mPipeline.get(), set, Kernel::RadixScatter, count, blockCount, cmd, shift);
+		}
+	}
+}
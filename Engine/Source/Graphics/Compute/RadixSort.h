@@ -0,0 +1,34 @@
+#pragma once
+#include <array>
+#include <memory>
+
+#include "PrefixSum.h"
+
+namespace SnowEngine::Compute
+{
+	/**
+	 * \brief Stable least significant digit radix sort of u32 keys carrying u32 values, 4 bits per pass.
+	 * Each pass counts the digits of every block, scans the counts into scatter offsets and scatters the pairs
+	 * into scratch buffers, ranking equal digits of a block with a workgroup scan. The sorted pairs end up in the
+	 * original buffers.
+	 */
+	class RadixSort
+	{
+	public:
+		RadixSort(const std::shared_ptr<StorageBuffer>& keys, const std::shared_ptr<StorageBuffer>& values, u32 maxCount);
+
+		/** \param keyBits Number of low bits that differ between keys, fewer bits need fewer passes. */
+		void Record(u32 count, const std::shared_ptr<CommandBuffer>& cmd, u32 keyBits = 32) const;
+
+		static constexpr u32 sRadixBits{ 4 };
+
+	private:
+		std::shared_ptr<ComputePipeline> mPipeline;
+		std::shared_ptr<StorageBuffer> mKeysScratch;
+		std::shared_ptr<StorageBuffer> mValuesScratch;
+		std::shared_ptr<StorageBuffer> mDigitCounts;
+		std::unique_ptr<PrefixSum> mScan;
+		std::array<std::shared_ptr<DescriptorSet>, 2> mSets; //set i reads the buffers written by set 1 - i
+		u32 mMaxCount;
+	};
+}
@@ -0,0 +1,32 @@
+#include "StreamCompaction.h"
+
+#include <algorithm>
+
+#include "Kernels.h"
+
+namespace SnowEngine::Compute
+{
+	StreamCompaction::StreamCompaction(const std::shared_ptr<StorageBuffer>& input, const std::shared_ptr<StorageBuffer>& flags,
+		const std::shared_ptr<StorageBuffer>& output, const std::shared_ptr<StorageBuffer>& count, const u32 maxCount)
+		: mPipeline{ Kernels::CreatePipeline() }
+	{
+		mOffsets = StorageBuffer::Create(std::max(maxCount, 1u) * sizeof(u32));
+		mScan = std::make_unique<PrefixSum>(flags, mOffsets, maxCount);
+
+		mSet = DescriptorSet::Create(Kernels::GetShader(), 0, 1);
+		mSet->SetStorageBuffer("KeysIn", input);
+		mSet->SetStorageBuffer("KeysOut", output);
+		mSet->SetStorageBuffer("ValuesIn", flags);
+		mSet->SetStorageBuffer("Partials", mOffsets);
+		mSet->SetStorageBuffer("Counters", count);
+	}
+
+	void StreamCompaction::Record(const u32 count, const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		if (count == 0)
+			return;
+
+		mScan->Record(count, cmd);
+		Kernels::Dispatch(mPipeline.get(), mSet.get(), Kernel::Compact, count, (count + Kernels::sGroupSize - 1) / Kernels::sGroupSize, cmd);
+	}
+}
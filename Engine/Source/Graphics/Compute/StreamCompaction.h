@@ -0,0 +1,26 @@
+#pragma once
+#include <memory>
+
+#include "PrefixSum.h"
+
+namespace SnowEngine::Compute
+{
+	/**
+	 * \brief Keeps the elements whose flag is not zero, preserving their order. The flags are scanned into write offsets
+	 * and the kept elements are scattered to them, the number of kept elements is written to the first u32 of count.
+	 */
+	class StreamCompaction
+	{
+	public:
+		StreamCompaction(const std::shared_ptr<StorageBuffer>& input, const std::shared_ptr<StorageBuffer>& flags,
+			const std::shared_ptr<StorageBuffer>& output, const std::shared_ptr<StorageBuffer>& count, u32 maxCount);
+
+		void Record(u32 count, const std::shared_ptr<CommandBuffer>& cmd) const;
+
+	private:
+		std::shared_ptr<ComputePipeline> mPipeline;
+		std::shared_ptr<StorageBuffer> mOffsets;
+		std::unique_ptr<PrefixSum> mScan;
+		std::shared_ptr<DescriptorSet> mSet;
+	};
+}
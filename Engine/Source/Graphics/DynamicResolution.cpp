@@ -0,0 +1,68 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SnowEngine
+{
+	DynamicResolution::DynamicResolution(const f32 targetFrameTime, const f32 minScale, const f32 maxScale)
+		: mTargetFrameTime{ targetFrameTime }, mMinScale{ minScale }, mMaxScale{ maxScale }, mScale{ maxScale }
+	{
+	}
+
+	f32 DynamicResolution::Scale() const { return mScale; }
+
+	f32 DynamicResolution::FrameTime() const { return mFrameTime; }
+
+	f32 DynamicResolution::TargetFrameTime() const { return mTargetFrameTime; }
+
+	b8 DynamicResolution::Enabled() const { return mEnabled; }
+
+	void DynamicResolution::SetTargetFrameTime(const f32 milliseconds) { mTargetFrameTime = milliseconds; }
+
+	void DynamicResolution::SetScaleRange(const f32 minScale, const f32 maxScale)
+	{
+		mMinScale = std::clamp(minScale, sStep, 1.0f);
+		mMaxScale = std::clamp(maxScale, mMinScale, 1.0f);
+		mScale = std::clamp(mScale, mMinScale, mMaxScale);
+	}
+
+	void DynamicResolution::SetEnabled(const b8 enabled)
+	{
+		mEnabled = enabled;
+		if (!mEnabled)
+			mScale = mMaxScale;
+	}
+
+	f32 DynamicResolution::Update(const f32 gpuTime)
+	{
+		mFrameTime = mFrameTime > 0.0f ? mFrameTime + (gpuTime - mFrameTime) * sSmoothing : gpuTime;
+
+		if (!mEnabled || mFrameTime <= 0.0f)
+			return mScale;
+
+		if (mCooldown)
+		{
+			mCooldown--;
+			return mScale;
+		}
+
+		const f32 budget{ mTargetFrameTime * sHeadroom };
+		if (std::abs(mFrameTime - budget) <= budget * sTolerance)
+			return mScale;
+
+		f32 scale{ mScale * std::sqrt(budget / mFrameTime) };
+		scale = std::min(scale, mScale + sMaxIncrease);
+		scale = std::clamp(std::round(scale / sStep) * sStep, mMinScale, mMaxScale);
+
+		if (scale != mScale)
+		{
+			//predict the time at the new scale, the frames measured next were still rendered at the old one
+			mFrameTime *= (scale * scale) / (mScale * mScale);
+			mScale = scale;
+			mCooldown = sSettleFrames;
+		}
+
+		return mScale;
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "Core/Types.h"
+
+namespace SnowEngine
+{
+	/**
+	 * \brief Picks the fraction of the scene target to render to from the measured GPU frame time. The scale drops at
+	 * once when a frame goes over budget and recovers in small steps, the GPU time is assumed to follow the pixel count.
+	 */
+	class DynamicResolution
+	{
+	public:
+		DynamicResolution(f32 targetFrameTime = 1000.0f / 60.0f, f32 minScale = 0.5f, f32 maxScale = 1.0f);
+
+		f32 Scale() const;
+		f32 FrameTime() const; //smoothed GPU time in milliseconds
+		f32 TargetFrameTime() const;
+		b8 Enabled() const;
+
+		void SetTargetFrameTime(f32 milliseconds);
+		void SetScaleRange(f32 minScale, f32 maxScale);
+		/** \brief A disabled controller keeps the maximum scale. */
+		void SetEnabled(b8 enabled);
+
+		/** \brief Feeds the GPU time of a completed frame, in milliseconds, and returns the scale of the next one. */
+		f32 Update(f32 gpuTime);
+
+	private:
+		f32 mTargetFrameTime;
+		f32 mMinScale;
+		f32 mMaxScale;
+		f32 mScale;
+		f32 mFrameTime{ 0.0f };
+		u32 mCooldown{ 0 };
+		b8 mEnabled{ true };
+
+		static constexpr f32 sHeadroom{ 0.9f }; //fraction of the target aimed at, leaves room for spikes
+		static constexpr f32 sTolerance{ 0.05f }; //relative distance from the budget within which the scale is kept
+		static constexpr f32 sSmoothing{ 0.2f };
+		static constexpr f32 sStep{ 1.0f / 32.0f }; //scales are quantized so noise does not change them every frame
+		static constexpr f32 sMaxIncrease{ 0.05f };
+		static constexpr u32 sSettleFrames{ 4 }; //frames in flight still rendered at the previous scale
+	};
+}
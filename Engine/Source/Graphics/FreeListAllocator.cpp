@@ -0,0 +1,58 @@
+#include "FreeListAllocator.h"
+
+namespace SnowEngine
+{
+	FreeListAllocator::FreeListAllocator(const u64 size)
+		: mSize{ size }, mFreeSpace{ size }
+	{
+		mFreeBlocks.insert({ 0, size });
+	}
+
+	b8 FreeListAllocator::Allocate(const u64 size, u64& offset)
+	{
+		for (auto it = mFreeBlocks.begin(); it != mFreeBlocks.end(); ++it)
+		{
+			const auto [blockOffset, blockSize] = *it;
+			if (blockSize < size)
+				continue;
+
+			mFreeBlocks.erase(it);
+			if (blockSize > size)
+				mFreeBlocks.insert({ blockOffset + size, blockSize - size });
+
+			mFreeSpace -= size;
+			offset = blockOffset;
+			return true;
+		}
+
+		return false;
+	}
+
+	void FreeListAllocator::Free(const u64 offset, const u64 size)
+	{
+		if (size == 0)
+			return;
+
+		auto [it, inserted] = mFreeBlocks.insert({ offset, size });
+		mFreeSpace += size;
+
+		if (const auto next = std::next(it); next != mFreeBlocks.end() && it->first + it->second == next->first)
+		{
+			it->second += next->second;
+			mFreeBlocks.erase(next);
+		}
+
+		if (it != mFreeBlocks.begin())
+		{
+			if (const auto previous = std::prev(it); previous->first + previous->second == it->first)
+			{
+				previous->second += it->second;
+				mFreeBlocks.erase(it);
+			}
+		}
+	}
+
+	u64 FreeListAllocator::Size() const { return mSize; }
+
+	u64 FreeListAllocator::FreeSpace() const { return mFreeSpace; }
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <map>
+
+#include "Core/Types.h"
+
+namespace SnowEngine
+{
+	/**
+	 * \brief First fit offset allocator over a linear range, adjacent free blocks are merged on release.
+	 */
+	class FreeListAllocator
+	{
+	public:
+		FreeListAllocator(u64 size);
+
+		b8 Allocate(u64 size, u64& offset);
+		void Free(u64 offset, u64 size);
+
+		u64 Size() const;
+		u64 FreeSpace() const;
+
+	private:
+		std::map<u64, u64> mFreeBlocks;
+		u64 mSize;
+		u64 mFreeSpace;
+	};
+}
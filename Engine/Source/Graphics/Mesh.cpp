@@ -4,37 +4,32 @@ namespace SnowEngine
 {
 	Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<u32>& indices, const u32 frameCount)
 	{
-		mVertexBuffer = VertexBuffer::Create(vertices.data(), static_cast<u32>(vertices.size()));
-		mIndexBuffer = IndexBuffer::Create(indices.data(), static_cast<u32>(indices.size()));
+		mAllocated = GeometryPool::Get()->Allocate(vertices.data(), static_cast<u32>(vertices.size()), indices.data(), static_cast<u32>(indices.size()), mGeometry);
 
 		if (std::shared_ptr<Shader> shader; Shader::GetShader("default", shader))
-			mTransformDescriptorSet = DescriptorSet::Create(shader, 1, frameCount);//TODO: better way
+			mDescriptorSet = DescriptorSet::Create(shader, 1, frameCount);//TODO: better way
 	}
 
-	void Mesh::SetTransform(const glm::mat4& transform, const u32 frameIndex) const
+	Mesh::~Mesh()
 	{
-		mTransformDescriptorSet->SetUniform("Transform", &transform, frameIndex);
+		if (mAllocated)
+			GeometryPool::Get()->Free(mGeometry);
 	}
 
-	void Mesh::SetAlbedo(const std::shared_ptr<Image>& albedo) const
+	void Mesh::SetAlbedo(const std::shared_ptr<Image>& albedo, const SamplerDesc& sampler) const
 	{
-		mTransformDescriptorSet->SetImage("albedo", albedo);
+		mDescriptorSet->SetImage("albedo", albedo, sampler);
 	}
 
 	void Mesh::Draw(const std::shared_ptr<Pipeline>& pipeline, const std::shared_ptr<CommandBuffer>& cmd, const u32 currentFrame) const
 	{
-		pipeline->BindDescriptorSet(mTransformDescriptorSet.get(), currentFrame, cmd);
+		pipeline->BindDescriptorSet(mDescriptorSet.get(), currentFrame, cmd);
 
-		mVertexBuffer->Bind(cmd);
-
-		if (mIndexBuffer)
-		{
-			mIndexBuffer->Bind(cmd);
-			mIndexBuffer->Draw(cmd);
+		GeometryPool::Get()->Bind(cmd);
+		GeometryPool::Get()->Draw(mGeometry, cmd);
+	}
 
-			return;
-		}
+	const GeometryRange& Mesh::GetGeometry() const { return mGeometry; }
 
-		mVertexBuffer->Draw(cmd);
-	}
+	const std::shared_ptr<DescriptorSet>& Mesh::GetDescriptorSet() const { return mDescriptorSet; }
 }
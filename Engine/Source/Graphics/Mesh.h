@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include "Rhi/Buffers.h"
 #include "Rhi/DescriptorSet.h"
+#include "Rhi/GeometryPool.h"
 #include "Rhi/Pipeline.h"
 
 namespace SnowEngine
@@ -9,16 +10,22 @@ namespace SnowEngine
 	{
 	public:
 		Mesh(const std::vector<Vertex>& vertices, const std::vector<u32>& indices, u32 frameCount);
+		~Mesh();
 
-		void SetTransform(const glm::mat4& transform, u32 frameIndex) const;
-		void SetAlbedo(const std::shared_ptr<Image>& albedo) const;
+		Mesh(const Mesh&) = delete;
+		Mesh& operator=(const Mesh&) = delete;
+
+		void SetAlbedo(const std::shared_ptr<Image>& albedo, const SamplerDesc& sampler = {}) const;
 
 		void Draw(const std::shared_ptr<Pipeline>& pipeline, const std::shared_ptr<CommandBuffer>& cmd, u32 currentFrame) const;
 
+		const GeometryRange& GetGeometry() const;
+		const std::shared_ptr<DescriptorSet>& GetDescriptorSet() const;
+
 	private:
-		std::shared_ptr<VertexBuffer> mVertexBuffer{ nullptr };
-		std::shared_ptr<IndexBuffer> mIndexBuffer{ nullptr };
+		GeometryRange mGeometry{};
+		b8 mAllocated{ false };
 
-		std::shared_ptr<DescriptorSet> mTransformDescriptorSet{ nullptr };
+		std::shared_ptr<DescriptorSet> mDescriptorSet{ nullptr };
 	};
 }
@@ -0,0 +1,208 @@
+#include "ParticleSystem.h"
+
+#include <algorithm>
+
+#include "Rhi/Shader.h"
+
+namespace SnowEngine
+{
+	ParticleSystem::ParticleSystem(const u32 maxParticles, const u32 frameCount)
+		: mMaxParticles{ maxParticles }
+	{
+		CreateBuffers(frameCount);
+
+		//the sets hold no uniforms, a single copy of each is enough
+		if (std::shared_ptr<Shader> shader; Shader::GetShader("emitter_simulation", shader))
+		{
+			mSimulationSets.resize(frameCount * 2);
+			for (u32 i{ 0 }; i < mSimulationSets.size(); i++)
+			{
+				const u32 frame{ i / 2 };
+				const u32 parity{ i % 2 };
+
+				mSimulationSets[i] = DescriptorSet::Create(shader, 0, 1);
+				mSimulationSets[i]->SetStorageBuffer("Particles", mParticles);
+				mSimulationSets[i]->SetStorageBuffer("AliveIn", mAlive[parity]);
+				mSimulationSets[i]->SetStorageBuffer("AliveOut", mAlive[1 - parity]);
+				mSimulationSets[i]->SetStorageBuffer("DeadList", mDeadList);
+				mSimulationSets[i]->SetStorageBuffer("Arguments", mArguments);
+				mSimulationSets[i]->SetStorageBuffer("Counters", mCounters);
+				mSimulationSets[i]->SetStorageBuffer("Rendered", mRendered[frame]);
+				mSimulationSets[i]->SetStorageBuffer("Draw", mDrawArguments[frame]);
+			}
+		}
+
+		if (std::shared_ptr<Shader> shader; Shader::GetShader("emitter", shader))
+		{
+			mRenderSets.resize(frameCount);
+			for (u32 i{ 0 }; i < frameCount; i++)
+			{
+				mRenderSets[i] = DescriptorSet::Create(shader, 1, 1);
+				mRenderSets[i]->SetStorageBuffer("Rendered", mRendered[i]);
+			}
+		}
+	}
+
+	u32 ParticleSystem::MaxParticles() const { return mMaxParticles; }
+
+	void ParticleSystem::AddPasses(RenderGraph& graph, const ComputePipeline* pipeline, const ParticleEmitter& emitter, const glm::vec3& position, const f32 dt, const u32 currentFrame)
+	{
+		mParity = 1 - mParity;
+
+		mEmitRemainder += emitter.EmitRate * dt;
+		const u32 emitCount{ static_cast<u32>(std::min(mEmitRemainder, static_cast<f32>(mMaxParticles))) };
+		mEmitRemainder -= static_cast<f32>(emitCount);
+
+		mResources.Particles = graph.ImportBuffer("Particles", mParticles.get());
+		mResources.AliveIn = graph.ImportBuffer("AliveIn", mAlive[mParity].get());
+		mResources.AliveOut = graph.ImportBuffer("AliveOut", mAlive[1 - mParity].get());
+		mResources.DeadList = graph.ImportBuffer("ParticleDeadList", mDeadList.get());
+		mResources.Arguments = graph.ImportBuffer("ParticleArguments", mArguments.get());
+		mResources.Counters = graph.ImportBuffer("ParticleCounters", mCounters.get());
+		mResources.Rendered = graph.ImportBuffer("RenderedParticles", mRendered[currentFrame].get());
+		mResources.DrawArguments = graph.ImportBuffer("ParticleDrawArguments", mDrawArguments[currentFrame].get());
+
+		EmitterConstants constants{};
+		constants.Position = glm::vec4{ position, emitter.SpawnRadius };
+		constants.Velocity = glm::vec4{ emitter.Velocity, emitter.Spread };
+		constants.Color = emitter.Color;
+		constants.DeltaTime = dt;
+		constants.Lifetime = emitter.Lifetime;
+		constants.Size = emitter.Size;
+		constants.EmitCount = emitCount;
+		constants.Parity = mParity;
+		constants.Seed = mSeed++;
+		constants.MaxParticles = mMaxParticles;
+
+		const auto* set{ mSimulationSets[currentFrame * 2 + mParity].get() };
+		const auto bind = [pipeline, set, constants](const Stage stage, const std::shared_ptr<CommandBuffer>& cmd)
+		{
+			EmitterConstants stageConstants{ constants };
+			stageConstants.Stage = static_cast<u32>(stage);
+
+			pipeline->BindDescriptorSet(set, 0, cmd);
+			pipeline->PushConstants(&stageConstants, sizeof(EmitterConstants), cmd);
+		};
+
+		const auto& resources{ mResources };
+		if (!mReset)
+		{
+			graph.AddPass("ParticleReset", [&](RenderGraphBuilder& builder)
+			{
+				builder.Write(resources.DeadList, ResourceUsage::StorageWrite);
+				builder.Write(resources.Counters, ResourceUsage::StorageWrite);
+			},
+			[=, maxParticles = mMaxParticles](const std::shared_ptr<CommandBuffer>& cmd)
+			{
+				bind(Stage::Reset, cmd);
+				pipeline->Dispatch((maxParticles + sGroupSize - 1) / sGroupSize, 1, 1, cmd);
+			});
+
+			mReset = true;
+		}
+
+		graph.AddPass("ParticlePrepare", [&](RenderGraphBuilder& builder)
+		{
+			builder.Write(resources.Arguments, ResourceUsage::StorageWrite);
+			builder.Write(resources.Counters, ResourceUsage::StorageWrite);
+		},
+		[=](const std::shared_ptr<CommandBuffer>& cmd)
+		{
+			bind(Stage::Prepare, cmd);
+			pipeline->Dispatch(1, 1, 1, cmd);
+		});
+
+		if (emitCount)
+		{
+			graph.AddPass("ParticleEmit", [&](RenderGraphBuilder& builder)
+			{
+				builder.Write(resources.Particles, ResourceUsage::StorageWrite);
+				builder.Write(resources.AliveIn, ResourceUsage::StorageWrite);
+				builder.Write(resources.DeadList, ResourceUsage::StorageWrite);
+				builder.Write(resources.Counters, ResourceUsage::StorageWrite);
+			},
+			[=](const std::shared_ptr<CommandBuffer>& cmd)
+			{
+				bind(Stage::Emit, cmd);
+				pipeline->Dispatch((emitCount + sGroupSize - 1) / sGroupSize, 1, 1, cmd);
+			});
+		}
+
+		//sized on the gpu by the prepare pass, from the alive count of the previous frame plus the emitted particles
+		graph.AddPass("ParticleSimulate", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(resources.Arguments, ResourceUsage::IndirectBuffer);
+			builder.Read(resources.AliveIn, ResourceUsage::StorageRead);
+			builder.Write(resources.Particles, ResourceUsage::StorageWrite);
+			builder.Write(resources.AliveOut, ResourceUsage::StorageWrite);
+			builder.Write(resources.DeadList, ResourceUsage::StorageWrite);
+			builder.Write(resources.Counters, ResourceUsage::StorageWrite);
+			builder.Write(resources.Rendered, ResourceUsage::StorageWrite);
+		},
+		[=, arguments = mArguments](const std::shared_ptr<CommandBuffer>& cmd)
+		{
+			bind(Stage::Simulate, cmd);
+			pipeline->DispatchIndirect(arguments, 0, cmd);
+		});
+
+		graph.AddPass("ParticleFinalize", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(resources.Counters, ResourceUsage::StorageRead);
+			builder.Write(resources.DrawArguments, ResourceUsage::StorageWrite);
+		},
+		[=](const std::shared_ptr<CommandBuffer>& cmd)
+		{
+			bind(Stage::Finalize, cmd);
+			pipeline->Dispatch(1, 1, 1, cmd);
+		});
+	}
+
+	void ParticleSystem::GetSharedBuffers(const u32 currentFrame, std::vector<std::shared_ptr<StorageBuffer>>& buffers) const
+	{
+		buffers.push_back(mRendered[currentFrame]);
+		buffers.push_back(mDrawArguments[currentFrame]);
+	}
+
+	void ParticleSystem::ImportDraw(RenderGraph& graph, const u32 currentFrame)
+	{
+		mDrawResources.Rendered = graph.ImportBuffer("RenderedParticles", mRendered[currentFrame].get());
+		mDrawResources.DrawArguments = graph.ImportBuffer("ParticleDrawArguments", mDrawArguments[currentFrame].get());
+	}
+
+	void ParticleSystem::DeclareDraw(RenderGraphBuilder& builder) const
+	{
+		builder.Read(mDrawResources.DrawArguments, ResourceUsage::IndirectBuffer);
+		builder.Read(mDrawResources.Rendered, ResourceUsage::StorageRead);
+	}
+
+	void ParticleSystem::Draw(const Pipeline* pipeline, const u32 currentFrame, const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		pipeline->BindDescriptorSet(mRenderSets[currentFrame].get(), 0, cmd);
+		mDrawArguments[currentFrame]->DrawIndirect(0, cmd);
+	}
+
+	/**
+	 * \brief Creates the buffers without uploading anything, the first frame fills them on the compute queue.
+	 */
+	void ParticleSystem::CreateBuffers(const u32 frameCount)
+	{
+		constexpr u32 particleSize{ 3 * sizeof(glm::vec4) };
+		constexpr u32 renderedSize{ 2 * sizeof(glm::vec4) };
+
+		mParticles = StorageBuffer::Create(mMaxParticles * particleSize);
+		for (auto& alive : mAlive)
+			alive = StorageBuffer::Create(mMaxParticles * sizeof(u32));
+
+		mDeadList = StorageBuffer::Create(mMaxParticles * sizeof(u32));
+		mArguments = StorageBuffer::Create(3 * sizeof(u32));
+		mCounters = StorageBuffer::Create(4 * sizeof(u32));
+
+		mRendered.resize(frameCount);
+		mDrawArguments.resize(frameCount);
+		for (u32 i{ 0 }; i < frameCount; i++)
+		{
+			mRendered[i] = StorageBuffer::Create(mMaxParticles * renderedSize);
+			mDrawArguments[i] = StorageBuffer::Create(4 * sizeof(u32));
+		}
+	}
+}
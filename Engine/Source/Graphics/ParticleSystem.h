@@ -0,0 +1,119 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "RenderGraph.h"
+#include "Core/Types.h"
+#include "Rhi/Buffers.h"
+#include "Rhi/DescriptorSet.h"
+#include "Rhi/Pipeline.h"
+
+namespace SnowEngine
+{
+	struct ParticleEmitter
+	{
+		f32 EmitRate{ 50000.0f }; //particles per second
+		f32 Lifetime{ 4.0f }; //seconds, every particle lives between half and all of it
+		f32 Size{ 0.02f };
+		f32 SpawnRadius{ 0.25f };
+		glm::vec3 Velocity{ 0.0f, 1.0f, 0.0f };
+		f32 Spread{ 0.5f }; //random speed added in every direction
+		glm::vec4 Color{ 1.0f };
+	};
+
+	/**
+	 * \brief Particle simulation living entirely on the gpu. Dead particles are recycled through a dead list, the alive
+	 * indices ping-pong between two lists by alternating descriptor sets and the draw reads its instance count from the
+	 * counters written by the simulation, so the cpu never knows how many particles are alive.
+	 * The simulation state never leaves the compute queue, every step copies the alive particles out to the frame slot
+	 * and only that copy and its draw arguments are handed to the graphics queue.
+	 */
+	class ParticleSystem
+	{
+	public:
+		ParticleSystem(u32 maxParticles, u32 frameCount);
+
+		ParticleSystem(const ParticleSystem&) = delete;
+		ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+		u32 MaxParticles() const;
+
+		/** \brief Adds the emission and simulation passes of this frame to a graph recorded on the compute queue, the emitter is in world space. */
+		void AddPasses(RenderGraph& graph, const ComputePipeline* pipeline, const ParticleEmitter& emitter, const glm::vec3& position, f32 dt, u32 currentFrame);
+		/** \brief Appends the buffers of the frame slot the simulation hands to the graphics queue. */
+		void GetSharedBuffers(u32 currentFrame, std::vector<std::shared_ptr<StorageBuffer>>& buffers) const;
+		/** \brief Imports the buffers read by Draw into the graph that draws the particles. */
+		void ImportDraw(RenderGraph& graph, u32 currentFrame);
+		/** \brief Declares the buffers read by Draw on the pass that draws the particles. */
+		void DeclareDraw(RenderGraphBuilder& builder) const;
+		void Draw(const Pipeline* pipeline, u32 currentFrame, const std::shared_ptr<CommandBuffer>& cmd) const;
+
+	private:
+		enum class Stage : u32
+		{
+			Prepare,
+			Emit,
+			Simulate,
+			Finalize,
+			Reset
+		};
+
+		struct EmitterConstants
+		{
+			glm::vec4 Position;
+			glm::vec4 Velocity;
+			glm::vec4 Color;
+			f32 DeltaTime;
+			f32 Lifetime;
+			f32 Size;
+			u32 EmitCount;
+			u32 Stage;
+			u32 Parity;
+			u32 Seed;
+			u32 MaxParticles;
+		};
+
+		struct GraphResources
+		{
+			RenderGraphResource Particles;
+			RenderGraphResource AliveIn;
+			RenderGraphResource AliveOut;
+			RenderGraphResource DeadList;
+			RenderGraphResource Arguments;
+			RenderGraphResource Counters;
+			RenderGraphResource Rendered;
+			RenderGraphResource DrawArguments;
+		};
+
+		struct DrawResources
+		{
+			RenderGraphResource Rendered;
+			RenderGraphResource DrawArguments;
+		};
+
+		void CreateBuffers(u32 frameCount);
+
+		std::shared_ptr<StorageBuffer> mParticles{ nullptr };
+		std::array<std::shared_ptr<StorageBuffer>, 2> mAlive{};
+		std::shared_ptr<StorageBuffer> mDeadList{ nullptr };
+		std::shared_ptr<StorageBuffer> mArguments{ nullptr }; //the simulation dispatch
+		std::shared_ptr<StorageBuffer> mCounters{ nullptr };
+		std::vector<std::shared_ptr<StorageBuffer>> mRendered; //of every frame slot, the alive particles in draw order
+		std::vector<std::shared_ptr<StorageBuffer>> mDrawArguments; //of every frame slot
+
+		std::vector<std::shared_ptr<DescriptorSet>> mSimulationSets; //of every frame slot and parity
+		std::vector<std::shared_ptr<DescriptorSet>> mRenderSets; //of every frame slot
+
+		GraphResources mResources{};
+		DrawResources mDrawResources{};
+		u32 mMaxParticles;
+		u32 mParity{ 1 }; //alive list read by the current frame, flipped before the first one
+		u32 mSeed{ 0 };
+		f32 mEmitRemainder{ 0.0f };
+		b8 mReset{ false }; //the dead list and the counters have been filled on the gpu
+
+		static constexpr u32 sGroupSize{ 256 };
+	};
+}
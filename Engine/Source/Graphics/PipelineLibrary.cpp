@@ -0,0 +1,180 @@
+#include "PipelineLibrary.h"
+
+#include <chrono>
+
+#include "Core/Hash.h"
+#include "Core/Logger.h"
+#include "Core/ThreadPool.h"
+
+namespace SnowEngine
+{
+	PipelineLibrary::~PipelineLibrary()
+	{
+		Clear();
+	}
+
+	pipelineHandle PipelineLibrary::Add(const PipelineSettings& settings, const std::shared_ptr<Pipeline>& pipeline)
+	{
+		pipelineHandle handle{ Find(settings) };
+		if (handle == sNoPipeline)
+		{
+			handle = static_cast<pipelineHandle>(mEntries.size());
+			mHandles[Hash(settings)].push_back(handle);
+			mEntries.push_back({ settings, nullptr, {}, sNoPipeline });
+		}
+		else if (!mEntries[handle].Pipeline && !mEntries[handle].Failed)
+		{
+			//already queued, the compiled one is dropped
+			Receive(mEntries[handle]);
+		}
+
+		mEntries[handle].Pipeline = pipeline;
+		mEntries[handle].Failed = false;
+		return handle;
+	}
+
+	pipelineHandle PipelineLibrary::Request(const PipelineSettings& settings)
+	{
+		if (const pipelineHandle handle{ Find(settings) }; handle != sNoPipeline)
+			return handle;
+
+		const pipelineHandle handle{ static_cast<pipelineHandle>(mEntries.size()) };
+		mHandles[Hash(settings)].push_back(handle);
+
+		mEntries.push_back({ settings, nullptr, ThreadPool::Get().Submit([settings] { return Pipeline::Create(settings); }), FindFallback(settings) });
+		mPending++;
+
+		return handle;
+	}
+
+	const Pipeline* PipelineLibrary::Get(const pipelineHandle handle) const
+	{
+		const Entry& entry{ mEntries[handle] };
+		if (entry.Pipeline)
+			return entry.Pipeline.get();
+
+		return entry.Fallback != sNoPipeline ? mEntries[entry.Fallback].Pipeline.get() : nullptr;
+	}
+
+	b8 PipelineLibrary::Ready(const pipelineHandle handle) const { return mEntries[handle].Pipeline != nullptr; }
+
+	u32 PipelineLibrary::Pending() const { return mPending; }
+
+	void PipelineLibrary::Update()
+	{
+		if (!mPending)
+			return;
+
+		for (auto& entry : mEntries)
+		{
+			if (entry.Pipeline || entry.Failed || entry.Compiling.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready)
+				continue;
+
+			Receive(entry);
+		}
+	}
+
+	void PipelineLibrary::Wait()
+	{
+		for (auto& entry : mEntries)
+		{
+			if (entry.Pipeline || entry.Failed)
+				continue;
+
+			Receive(entry);
+		}
+	}
+
+	void PipelineLibrary::Clear()
+	{
+		Wait();
+
+		mEntries.clear();
+		mHandles.clear();
+	}
+
+	/**
+	 * \brief Takes the result of a finished or awaited compilation, a compilation that threw is logged and the entry keeps
+	 * drawing with its fallback instead of the exception reaching the frame.
+	 */
+	void PipelineLibrary::Receive(Entry& entry)
+	{
+		try
+		{
+			entry.Pipeline = entry.Compiling.get();
+		}
+		catch (const std::exception& exception)
+		{
+			LOG_ERROR("Failed to compile a pipeline permutation: %s", exception.what());
+			entry.Failed = true;
+		}
+
+		mPending--;
+	}
+
+	pipelineHandle PipelineLibrary::Find(const PipelineSettings& settings) const
+	{
+		const auto it{ mHandles.find(Hash(settings)) };
+		if (it == mHandles.end())
+			return sNoPipeline;
+
+		for (const pipelineHandle handle : it->second)
+		{
+			if (mEntries[handle].Settings == settings)
+				return handle;
+		}
+
+		return sNoPipeline;
+	}
+
+	/**
+	 * \brief A compiled pipeline that can stand in for the settings: same shader, so the sets bind the same way, same
+	 * render pass, same vertex input and primitives, and drawing color when the settings do. Among those the one
+	 * differing in the fewest states is picked.
+	 */
+	pipelineHandle PipelineLibrary::FindFallback(const PipelineSettings& settings) const
+	{
+		pipelineHandle fallback{ sNoPipeline };
+		u32 fewestDifferences{ ~0u };
+
+		for (pipelineHandle handle{ 0 }; handle < mEntries.size(); handle++)
+		{
+			const PipelineSettings& candidate{ mEntries[handle].Settings };
+			if (!mEntries[handle].Pipeline || candidate.Shader != settings.Shader || candidate.RenderPass != settings.RenderPass ||
+				candidate.VertexInput != settings.VertexInput || candidate.Topology != settings.Topology || candidate.ColorWrite != settings.ColorWrite)
+				continue;
+
+			const u32 differences
+			{
+				static_cast<u32>(candidate.BackfaceCulling != settings.BackfaceCulling) +
+				static_cast<u32>(candidate.DepthTest != settings.DepthTest) +
+				static_cast<u32>(candidate.DepthWrite != settings.DepthWrite) +
+				static_cast<u32>(candidate.DepthCompare != settings.DepthCompare) +
+				static_cast<u32>(candidate.Blend != settings.Blend)
+			};
+
+			if (differences < fewestDifferences)
+			{
+				fallback = handle;
+				fewestDifferences = differences;
+			}
+		}
+
+		return fallback;
+	}
+
+	u64 PipelineLibrary::Hash(const PipelineSettings& settings)
+	{
+		Hasher hash;
+		hash.Mix(settings.Shader.get());
+		hash.Mix(settings.RenderPass.get());
+		hash.Mix(static_cast<u64>(settings.Width) << 32 | settings.Height);
+		hash.Mix(static_cast<u64>(settings.BackfaceCulling) | static_cast<u64>(settings.DepthTest) << 1 | static_cast<u64>(settings.DepthWrite) << 2 |
+			static_cast<u64>(settings.ColorWrite) << 3 | static_cast<u64>(settings.VertexInput) << 4 | static_cast<u64>(settings.DepthCompare) << 8 |
+			static_cast<u64>(settings.Blend) << 16 | static_cast<u64>(settings.Topology) << 24);
+		hash.Mix(settings.DepthBiasConstant);
+		hash.Mix(settings.DepthBiasSlope);
+
+		return hash.Get();
+	}
+}
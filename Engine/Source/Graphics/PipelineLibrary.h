@@ -0,0 +1,69 @@
+#pragma once
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/Types.h"
+#include "Rhi/Pipeline.h"
+
+namespace SnowEngine
+{
+	using pipelineHandle = u32;
+
+	/**
+	 * \brief Pipelines addressed by their settings. A permutation requested for the first time is compiled on the
+	 * thread pool while the caller keeps drawing with a compatible pipeline that is already compiled, one made from the
+	 * same shader and render pass, or skips the draw when there is none.
+	 * Must only be used from the thread recording the frame.
+	 */
+	class PipelineLibrary
+	{
+	public:
+		PipelineLibrary() = default;
+		~PipelineLibrary();
+
+		PipelineLibrary(const PipelineLibrary&) = delete;
+		PipelineLibrary& operator=(const PipelineLibrary&) = delete;
+
+		/** \brief Adds a pipeline compiled elsewhere, requests for its settings return it without compiling. */
+		pipelineHandle Add(const PipelineSettings& settings, const std::shared_ptr<Pipeline>& pipeline);
+		/** \brief Handle of the settings, their compilation is queued the first time they are requested. */
+		pipelineHandle Request(const PipelineSettings& settings);
+		/**
+		 * \brief Pipeline to draw with.
+		 * \return The requested pipeline once compiled, its fallback until then, null when the draw has to be skipped.
+		 */
+		const Pipeline* Get(pipelineHandle handle) const;
+		b8 Ready(pipelineHandle handle) const;
+		u32 Pending() const;
+
+		/** \brief Takes in the compilations that finished, once per frame before drawing. Failed ones are logged. */
+		void Update();
+		/** \brief Blocks until every queued compilation finished. */
+		void Wait();
+		/** \brief Drops every pipeline, waiting for the queued ones. The gpu must be done with them. */
+		void Clear();
+
+	private:
+		struct Entry
+		{
+			PipelineSettings Settings;
+			std::shared_ptr<Pipeline> Pipeline;
+			std::future<std::shared_ptr<SnowEngine::Pipeline>> Compiling;
+			pipelineHandle Fallback;
+			b8 Failed{ false }; //the compilation threw, the fallback is used for good
+		};
+
+		void Receive(Entry& entry);
+		pipelineHandle Find(const PipelineSettings& settings) const;
+		pipelineHandle FindFallback(const PipelineSettings& settings) const;
+		static u64 Hash(const PipelineSettings& settings);
+
+		std::vector<Entry> mEntries;
+		std::unordered_map<u64, std::vector<pipelineHandle>> mHandles; //by the hash of the settings
+		u32 mPending{ 0 };
+
+		static constexpr pipelineHandle sNoPipeline{ ~0u };
+	};
+}
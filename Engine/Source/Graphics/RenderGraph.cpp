@@ -0,0 +1,306 @@
+#include "RenderGraph.h"
+
+#include <algorithm>
+
+#include "Core/Logger.h"
+#include "Vulkan/VkRenderGraph.h"
+
+namespace SnowEngine
+{
+	RenderGraphBuilder::RenderGraphBuilder(RenderGraph& graph, const u32 pass)
+		: mGraph{ graph }, mPass{ pass }
+	{
+	}
+
+	/**
+	 * \brief Declares an image owned by the graph, its memory only lives between its first and last use and may be shared.
+	 */
+	RenderGraphResource RenderGraphBuilder::CreateImage(const std::string& name, const TransientImageDesc& desc)
+	{
+		auto& resource{ mGraph.mResources.emplace_back() };
+		resource.Name = name;
+		resource.Desc = desc;
+
+		return static_cast<RenderGraphResource>(mGraph.mResources.size() - 1);
+	}
+
+	void RenderGraphBuilder::Read(const RenderGraphResource resource, const ResourceUsage usage)
+	{
+		if (RenderGraph::IsWrite(usage))
+			LOG_ERROR("Render graph pass %s reads %s with a writing usage", mGraph.mPasses[mPass].Name.c_str(), mGraph.mResources[resource].Name.c_str());
+
+		mGraph.mPasses[mPass].Reads.push_back({ resource, usage });
+	}
+
+	void RenderGraphBuilder::Write(const RenderGraphResource resource, const ResourceUsage usage)
+	{
+		mGraph.mPasses[mPass].Writes.push_back({ resource, usage });
+		mGraph.mResources[resource].Writers.push_back(mPass);
+	}
+
+	std::shared_ptr<RenderGraph> RenderGraph::Create(const u32 frameCount)
+	{
+		return std::make_shared<VkRenderGraph>(frameCount);
+	}
+
+	RenderGraph::RenderGraph(const u32 frameCount)
+		: mFrameCount{ frameCount }
+	{
+	}
+
+	/**
+	 * \brief Imports an image owned outside of the graph.
+	 * \param image The image to synchronize, nullptr for images synchronized by other means (e.g. swapchain images).
+	 */
+	RenderGraphResource RenderGraph::ImportImage(const std::string& name, Image* image)
+	{
+		auto& resource{ mResources.emplace_back() };
+		resource.Name = name;
+		resource.Image = image;
+		resource.Imported = true;
+
+		return static_cast<RenderGraphResource>(mResources.size() - 1);
+	}
+
+	RenderGraphResource RenderGraph::ImportBuffer(const std::string& name, StorageBuffer* buffer)
+	{
+		auto& resource{ mResources.emplace_back() };
+		resource.Name = name;
+		resource.Buffer = buffer;
+		resource.Imported = true;
+
+		return static_cast<RenderGraphResource>(mResources.size() - 1);
+	}
+
+	void RenderGraph::AddPass(const std::string& name, const SetupFunction& setup, ExecuteFunction execute)
+	{
+		auto& pass{ mPasses.emplace_back() };
+		pass.Name = name;
+		pass.Execute = std::move(execute);
+
+		RenderGraphBuilder builder{ *this, static_cast<u32>(mPasses.size() - 1) };
+		setup(builder);
+	}
+
+	void RenderGraph::Reset()
+	{
+		mResources.clear();
+		mPasses.clear();
+	}
+
+	/**
+	 * \brief Expected once per frame, imported resources not seen for a whole round of frames in flight are forgotten.
+	 */
+	void RenderGraph::Compile(const u32 currentFrame)
+	{
+		mCompileCount++;
+		mStats = {};
+		mStats.PassCount = static_cast<u32>(mPasses.size());
+
+		Cull();
+		ComputeLifetimes();
+
+		std::vector<ResourceNode*> transients{};
+		for (auto& resource : mResources)
+		{
+			if (!resource.Imported && resource.FirstPass != ~0u)
+				transients.push_back(&resource);
+		}
+		AllocateTransients(currentFrame, transients);
+		ValidateTransients(transients);
+
+		ComputeBarriers();
+	}
+
+	void RenderGraph::Execute(const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		for (const auto& pass : mPasses)
+		{
+			if (pass.Culled)
+				continue;
+
+			if (!pass.Barriers.empty())
+				RecordBarriers(pass.Barriers, cmd);
+
+			pass.Execute(cmd);
+		}
+	}
+
+	Image* RenderGraph::GetImage(const RenderGraphResource resource) const { return mResources[resource].Image; }
+
+	const RenderGraphStats& RenderGraph::Stats() const { return mStats; }
+
+	b8 RenderGraph::IsWrite(const ResourceUsage usage)
+	{
+		return usage == ResourceUsage::ColorAttachment || usage == ResourceUsage::DepthAttachment || usage == ResourceUsage::StorageWrite || usage == ResourceUsage::TransferDst;
+	}
+
+	/**
+	 * \brief Reference counting cull: a pass survives while one of the resources it writes is read by a surviving pass or imported.
+	 */
+	void RenderGraph::Cull()
+	{
+		for (auto& resource : mResources)
+			resource.RefCount = resource.Imported ? 1 : 0;
+
+		for (auto& pass : mPasses)
+		{
+			pass.RefCount = static_cast<u32>(pass.Writes.size());
+			pass.Culled = false;
+
+			for (const auto& [resource, usage] : pass.Reads)
+				mResources[resource].RefCount++;
+		}
+
+		std::vector<RenderGraphResource> unreferenced{};
+		const auto cullPass = [&](PassNode& pass)
+		{
+			pass.Culled = true;
+			mStats.CulledPasses++;
+
+			for (const auto& [resource, usage] : pass.Reads)
+			{
+				if (--mResources[resource].RefCount == 0)
+					unreferenced.push_back(resource);
+			}
+		};
+
+		for (auto& pass : mPasses)
+		{
+			if (pass.RefCount == 0)
+				cullPass(pass);
+		}
+
+		for (RenderGraphResource i{ 0 }; i < mResources.size(); i++)
+		{
+			if (mResources[i].RefCount == 0)
+				unreferenced.push_back(i);
+		}
+
+		while (!unreferenced.empty())
+		{
+			const RenderGraphResource resource{ unreferenced.back() };
+			unreferenced.pop_back();
+
+			for (const u32 writer : mResources[resource].Writers)
+			{
+				auto& pass{ mPasses[writer] };
+				if (!pass.Culled && --pass.RefCount == 0)
+					cullPass(pass);
+			}
+		}
+	}
+
+	void RenderGraph::ComputeLifetimes()
+	{
+		for (u32 i{ 0 }; i < mPasses.size(); i++)
+		{
+			const auto& pass{ mPasses[i] };
+			if (pass.Culled)
+				continue;
+
+			for (const auto* accesses : { &pass.Reads, &pass.Writes })
+			{
+				for (const auto& [resource, usage] : *accesses)
+				{
+					auto& node{ mResources[resource] };
+					node.FirstPass = std::min(node.FirstPass, i);
+					node.LastPass = std::max(node.LastPass, i);
+					node.Usages |= 1u << static_cast<u32>(usage);
+				}
+			}
+		}
+	}
+
+	/**
+	 * \brief Walks the surviving passes in order and emits one barrier per usage change, read after read in the same usage needs none.
+	 * The first use of an aliased transient waits on the last use of the previous image in the same memory.
+	 */
+	void RenderGraph::ComputeBarriers()
+	{
+		std::vector<ResourceUsage> states(mResources.size(), ResourceUsage::None);
+		std::vector<b8> touched(mResources.size(), false);
+		std::unordered_map<u32, RenderGraphResource> slotOwners{};
+
+		const auto importKey = [](const ResourceNode& resource) { return resource.Image ? resource.Image->Id() : resource.Buffer->Id(); };
+
+		for (u32 i{ 0 }; i < mResources.size(); i++)
+		{
+			if (!mResources[i].Imported || (!mResources[i].Image && !mResources[i].Buffer))
+				continue;
+
+			if (const auto it = mImportedUsages.find(importKey(mResources[i])); it != mImportedUsages.end())
+				states[i] = it->second.Usage;
+		}
+
+		for (auto& pass : mPasses)
+		{
+			pass.Barriers.clear();
+			if (pass.Culled)
+				continue;
+
+			for (const auto* accesses : { &pass.Reads, &pass.Writes })
+			{
+				for (const auto& [resource, usage] : *accesses)
+				{
+					const auto& node{ mResources[resource] };
+					if (node.Imported && !node.Image && !node.Buffer)
+						continue;
+
+					ResourceUsage before{ states[resource] };
+					b8 discard{ false };
+
+					if (!node.Imported && !touched[resource])
+					{
+						discard = true;
+
+						const auto owner = slotOwners.find(node.AliasSlot);
+						before = owner != slotOwners.end() ? states[owner->second] : ResourceUsage::None;
+						slotOwners[node.AliasSlot] = resource;
+					}
+					touched[resource] = true;
+
+					if (!discard && before == usage && !IsWrite(usage))
+						continue;
+
+					pass.Barriers.push_back({ resource, before, usage, discard });
+					states[resource] = usage;
+				}
+			}
+
+			mStats.Barriers += static_cast<u32>(pass.Barriers.size());
+			if (!pass.Barriers.empty())
+				mStats.BarrierBatches++;
+		}
+
+		for (u32 i{ 0 }; i < mResources.size(); i++)
+		{
+			if (mResources[i].Imported && touched[i])
+				mImportedUsages[importKey(mResources[i])] = { states[i], mCompileCount };
+		}
+
+		//the fence of the current frame covers every use older than a round of frames in flight
+		std::erase_if(mImportedUsages, [this](const auto& entry) { return mCompileCount - entry.second.LastCompile >= mFrameCount; });
+	}
+
+	/**
+	 * \brief Checks the aliasing of the backend: every transient has an image and transients sharing memory are never
+	 * alive in the same pass.
+	 */
+	void RenderGraph::ValidateTransients(const std::vector<ResourceNode*>& transients) const
+	{
+		for (u32 i{ 0 }; i < transients.size(); i++)
+		{
+			const auto& a{ *transients[i] };
+			if (!a.Image)
+				LOG_ERROR("Render graph transient %s has no image", a.Name.c_str());
+
+			for (u32 j{ i + 1 }; j < transients.size(); j++)
+			{
+				const auto& b{ *transients[j] };
+				if (a.AliasSlot == b.AliasSlot && a.FirstPass <= b.LastPass && b.FirstPass <= a.LastPass)
+					LOG_ERROR("Render graph transients %s and %s share memory while both alive", a.Name.c_str(), b.Name.c_str());
+			}
+		}
+	}
+}
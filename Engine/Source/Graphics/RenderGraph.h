@@ -0,0 +1,174 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/Types.h"
+#include "Rhi/Buffers.h"
+#include "Rhi/CommandBuffer.h"
+#include "Rhi/Image.h"
+
+namespace SnowEngine
+{
+	using RenderGraphResource = u32;
+
+	enum class ResourceUsage : u8
+	{
+		None,
+		ColorAttachment,
+		DepthAttachment,
+		ShaderRead,
+		StorageRead,
+		StorageWrite,
+		TransferSrc,
+		TransferDst,
+		VertexBuffer,
+		IndexBuffer,
+		IndirectBuffer,
+		Present
+	};
+
+	enum class ImageFormat
+	{
+		Rgba8Unorm,
+		Bgra8Srgb,
+		Rgba16Float,
+		R32Float,
+		Depth32
+	};
+
+	struct TransientImageDesc
+	{
+		u32 Width;
+		u32 Height;
+		ImageFormat Format;
+	};
+
+	struct RenderGraphBarrier
+	{
+		RenderGraphResource Resource;
+		ResourceUsage Before;
+		ResourceUsage After;
+		b8 Discard; //the previous contents are not needed, images may start from an undefined layout
+	};
+
+	struct RenderGraphStats
+	{
+		u32 PassCount{ 0 };
+		u32 CulledPasses{ 0 };
+		u32 Barriers{ 0 };
+		u32 BarrierBatches{ 0 };
+		u64 TransientBytes{ 0 }; //memory actually allocated for transient images
+		u64 UnaliasedBytes{ 0 }; //memory the same images would need without aliasing
+	};
+
+	class RenderGraph;
+
+	class RenderGraphBuilder
+	{
+	public:
+		RenderGraphBuilder(RenderGraph& graph, u32 pass);
+
+		RenderGraphResource CreateImage(const std::string& name, const TransientImageDesc& desc);
+		void Read(RenderGraphResource resource, ResourceUsage usage);
+		void Write(RenderGraphResource resource, ResourceUsage usage);
+
+	private:
+		RenderGraph& mGraph;
+		u32 mPass;
+	};
+
+	/**
+	 * \brief Frame graph rebuilt every frame: passes declare the resources they read and write, Compile culls the passes
+	 * whose results are never observed, places batched barriers between them and aliases the memory of transient images
+	 * whose lifetimes do not overlap. Imported resources are always considered observed outside of the graph.
+	 */
+	class RenderGraph
+	{
+	public:
+		using SetupFunction = std::function<void(RenderGraphBuilder&)>;
+		using ExecuteFunction = std::function<void(const std::shared_ptr<CommandBuffer>&)>;
+
+		static std::shared_ptr<RenderGraph> Create(u32 frameCount);
+		virtual ~RenderGraph() = default;
+
+		RenderGraphResource ImportImage(const std::string& name, Image* image);
+		RenderGraphResource ImportBuffer(const std::string& name, StorageBuffer* buffer);
+		void AddPass(const std::string& name, const SetupFunction& setup, ExecuteFunction execute);
+
+		void Reset();
+		void Compile(u32 currentFrame);
+		void Execute(const std::shared_ptr<CommandBuffer>& cmd) const;
+
+		Image* GetImage(RenderGraphResource resource) const;
+		const RenderGraphStats& Stats() const;
+
+	protected:
+		RenderGraph(u32 frameCount);
+
+		struct ResourceNode
+		{
+			std::string Name;
+			SnowEngine::Image* Image{ nullptr };
+			StorageBuffer* Buffer{ nullptr };
+			TransientImageDesc Desc{};
+			b8 Imported{ false };
+			u32 Usages{ 0 }; //bit mask of every ResourceUsage declared on the resource
+			std::vector<u32> Writers;
+			u32 RefCount{ 0 };
+			u32 FirstPass{ ~0u };
+			u32 LastPass{ 0 };
+			u32 AliasSlot{ ~0u };
+		};
+
+		struct ResourceAccess
+		{
+			RenderGraphResource Resource;
+			ResourceUsage Usage;
+		};
+
+		struct PassNode
+		{
+			std::string Name;
+			std::vector<ResourceAccess> Reads;
+			std::vector<ResourceAccess> Writes;
+			ExecuteFunction Execute;
+			std::vector<RenderGraphBarrier> Barriers;
+			u32 RefCount{ 0 };
+			b8 Culled{ false };
+		};
+
+		/**
+		 * \brief Creates the transient images of the compiled graph, sets their Image and AliasSlot.
+		 * \param transients Transient resources that survived culling, with their pass lifetimes.
+		 */
+		virtual void AllocateTransients(u32 currentFrame, const std::vector<ResourceNode*>& transients) = 0;
+		virtual void RecordBarriers(const std::vector<RenderGraphBarrier>& barriers, const std::shared_ptr<CommandBuffer>& cmd) const = 0;
+
+		static b8 IsWrite(ResourceUsage usage);
+
+		std::vector<ResourceNode> mResources;
+		std::vector<PassNode> mPasses;
+		RenderGraphStats mStats{};
+
+	private:
+		void Cull();
+		void ComputeLifetimes();
+		void ComputeBarriers();
+		void ValidateTransients(const std::vector<ResourceNode*>& transients) const;
+
+		struct ImportedUsage
+		{
+			ResourceUsage Usage;
+			u64 LastCompile;
+		};
+
+		u32 mFrameCount;
+		u64 mCompileCount{ 0 };
+		std::unordered_map<u64, ImportedUsage> mImportedUsages; //last usage of imported resources by id, kept while they may still be in flight
+
+		friend class RenderGraphBuilder;
+	};
+}
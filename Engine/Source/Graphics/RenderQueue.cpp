@@ -0,0 +1,232 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <future>
+#include <memory>
+
+#include "Core/ThreadPool.h"
+
+namespace SnowEngine
+{
+	static constexpr u32 sParallelThreshold{ 2048 }; //below this the cost of waking workers outweighs the recording
+	static constexpr u32 sMinDrawsPerSlice{ 512 };
+
+	RenderQueue::RenderQueue(const u32 frameCount)
+		: mFrameCount{ frameCount }
+	{
+	}
+
+	/**
+	 * \brief Also forgets the ids of the pipelines, materials and meshes, they only have to be unique within a frame and
+	 * objects destroyed since would otherwise keep theirs forever.
+	 */
+	void RenderQueue::Clear()
+	{
+		mCommands.clear();
+		mEntries.clear();
+		mPipelineIds.clear();
+		mMaterialIds.clear();
+		mMeshIds.clear();
+	}
+
+	/**
+	 * \brief Queues a draw.
+	 * \param depth Normalized depth of the draw in [0, 1], lower values are drawn first inside a material.
+	 */
+	void RenderQueue::Submit(const u8 pass, const Pipeline* pipeline, const Mesh* mesh, const glm::mat4& transform, const f32 depth)
+	{
+		const u64 depthBucket{ static_cast<u64>(std::clamp(depth, 0.0f, 1.0f) * 65535.0f) };
+
+		u64 key{ 0 };
+		key |= static_cast<u64>(pass & 0xF) << 60;
+		key |= static_cast<u64>(Intern(pipeline, mPipelineIds, 1 << 12)) << 48;
+		key |= static_cast<u64>(Intern(mesh->GetDescriptorSet().get(), mMaterialIds, 1 << 16)) << 32;
+		key |= static_cast<u64>(Intern(mesh, mMeshIds, 1 << 16)) << 16;
+		key |= depthBucket;
+
+		mEntries.push_back({ key, static_cast<u32>(mCommands.size()) });
+		mCommands.push_back({ pipeline, mesh, transform });
+	}
+
+	void RenderQueue::Sort()
+	{
+		RadixSort(mEntries, mScratch);
+	}
+
+	void RenderQueue::Record(const DescriptorSet* globalSet, const u32 currentFrame, const std::shared_ptr<CommandBuffer>& cmd)
+	{
+		mStateChanges = RecordRange(0, Size(), globalSet, currentFrame, cmd);
+		mRecordThreads = 1;
+	}
+
+	/**
+	 * \brief Splits the sorted draws into contiguous slices and records each one into its own secondary command buffer.
+	 * The first slice is recorded on the calling thread, the others on the thread pool. Slices no worker has started by
+	 * then, e.g. queued behind pipeline compiles, are recorded on the calling thread too instead of being waited for.
+	 * The render pass must have been begun with secondary command buffer contents.
+	 * \return The recorded buffers, in draw order, to be executed by the primary buffer.
+	 */
+	const std::vector<std::shared_ptr<CommandBuffer>>& RenderQueue::RecordParallel(const std::shared_ptr<RenderPass>& renderPass, const DescriptorSet* globalSet, const u32 currentFrame)
+	{
+		const u32 sliceCount{ std::clamp(Size() / sMinDrawsPerSlice, 1u, ThreadPool::Get().ThreadCount() + 1) };
+		const u32 sliceSize{ (Size() + sliceCount - 1) / sliceCount };
+
+		//every slice owns its command pool, so no two threads ever record from the same pool
+		while (mSecondaryBuffers.size() < sliceCount)
+			mSecondaryBuffers.emplace_back(CommandBuffer::Create(mFrameCount, CommandBufferUsage::Graphics, CommandBufferLevel::Secondary));
+
+		mRecordedBuffers.assign(mSecondaryBuffers.begin(), mSecondaryBuffers.begin() + sliceCount);
+
+		const auto recordSlice = [this, &renderPass, globalSet, currentFrame, sliceSize](const u32 slice)
+		{
+			const auto& cmd{ mRecordedBuffers[slice] };
+			const u32 begin{ slice * sliceSize };
+			const u32 end{ std::min(begin + sliceSize, Size()) };
+
+			cmd->Begin(currentFrame, renderPass);
+			const u32 stateChanges{ RecordRange(begin, end, globalSet, currentFrame, cmd) };
+			cmd->End(currentFrame);
+
+			return stateChanges;
+		};
+
+		//whoever claims a slice first records it, jobs running after this returns find their slice claimed and do nothing
+		const auto claimed{ std::make_shared<std::vector<std::atomic<b8>>>(sliceCount) };
+
+		std::vector<std::future<u32>> jobs{};
+		jobs.reserve(sliceCount - 1);
+		for (u32 slice{ 1 }; slice < sliceCount; slice++)
+			jobs.emplace_back(ThreadPool::Get().Submit([&recordSlice, claimed, slice] { return (*claimed)[slice].exchange(true) ? 0u : recordSlice(slice); }));
+
+		mStateChanges = recordSlice(0);
+		mRecordThreads = 1;
+		for (u32 slice{ 1 }; slice < sliceCount; slice++)
+		{
+			if (!(*claimed)[slice].exchange(true))
+			{
+				mStateChanges += recordSlice(slice);
+				continue;
+			}
+
+			mStateChanges += jobs[slice - 1].get();
+			mRecordThreads++;
+		}
+
+		return mRecordedBuffers;
+	}
+
+	b8 RenderQueue::PrefersParallel() const { return Size() >= sParallelThreshold && ThreadPool::Get().ThreadCount() > 0; }
+
+	u32 RenderQueue::Size() const { return static_cast<u32>(mEntries.size()); }
+
+	u32 RenderQueue::StateChanges() const { return mStateChanges; }
+
+	u32 RenderQueue::RecordThreads() const { return mRecordThreads; }
+
+	/**
+	 * \brief Records the sorted draws in [begin, end), secondary buffers inherit no bound state so every range starts clean.
+	 * \return The number of pipeline, descriptor set and geometry binds recorded.
+	 */
+	u32 RenderQueue::RecordRange(const u32 begin, const u32 end, const DescriptorSet* globalSet, const u32 currentFrame, const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		const Pipeline* boundPipeline{ nullptr };
+		const DescriptorSet* boundMaterial{ nullptr };
+		b8 geometryBound{ false };
+		u32 stateChanges{ 0 };
+
+		ObjectConstants object{};
+		object.Index = begin;
+		for (u32 i{ begin }; i < end; i++)
+		{
+			const auto& [pipeline, mesh, transform] = mCommands[mEntries[i].Index];
+
+			if (pipeline != boundPipeline)
+			{
+				//sets below the first incompatible one are kept by the command buffer across the switch
+				const u32 compatible{ boundPipeline ? pipeline->CompatibleSets(boundPipeline) : 0 };
+
+				pipeline->Bind(cmd);
+				stateChanges++;
+				if (compatible < 1)
+				{
+					pipeline->BindDescriptorSet(globalSet, currentFrame, cmd);
+					stateChanges++;
+				}
+				if (compatible < 2)
+					boundMaterial = nullptr;
+
+				boundPipeline = pipeline;
+			}
+
+			if (const auto* material = mesh->GetDescriptorSet().get(); material != boundMaterial)
+			{
+				pipeline->BindDescriptorSet(material, currentFrame, cmd);
+				boundMaterial = material;
+				stateChanges++;
+			}
+
+			//every mesh lives in the shared geometry pool, so vertex and index buffers are bound once
+			if (!geometryBound)
+			{
+				GeometryPool::Get()->Bind(cmd);
+				geometryBound = true;
+				stateChanges++;
+			}
+
+			object.Model = transform;
+			pipeline->PushConstants(&object, sizeof(ObjectConstants), cmd);
+			object.Index++;
+
+			GeometryPool::Get()->Draw(mesh->GetGeometry(), cmd);
+		}
+
+		return stateChanges;
+	}
+
+	/**
+	 * \param capacity Number of ids the key field holds, objects past it share the last id so they are no longer grouped
+	 * together but never collide with the ids of other objects.
+	 */
+	u16 RenderQueue::Intern(const void* object, std::unordered_map<const void*, u16>& ids, const u32 capacity)
+	{
+		const auto [it, inserted] = ids.try_emplace(object, static_cast<u16>(std::min(static_cast<u32>(ids.size()), capacity - 1)));
+		return it->second;
+	}
+
+	/**
+	 * \brief Stable least significant digit radix sort on 8 bit digits, passes where every key shares the digit are skipped.
+	 */
+	void RenderQueue::RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch)
+	{
+		const u64 count{ entries.size() };
+		if (count < 2)
+			return;
+
+		scratch.resize(count);
+
+		for (u32 shift{ 0 }; shift < 64; shift += 8)
+		{
+			std::array<u64, 256> offsets{};
+			for (const auto& entry : entries)
+				offsets[(entry.Key >> shift) & 0xFF]++;
+
+			if (offsets[(entries.front().Key >> shift) & 0xFF] == count)
+				continue;
+
+			u64 sum{ 0 };
+			for (auto& offset : offsets)
+			{
+				const u64 digitCount{ offset };
+				offset = sum;
+				sum += digitCount;
+			}
+
+			for (const auto& entry : entries)
+				scratch[offsets[(entry.Key >> shift) & 0xFF]++] = entry;
+
+			entries.swap(scratch);
+		}
+	}
+}
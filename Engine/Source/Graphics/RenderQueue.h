@@ -0,0 +1,72 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Mesh.h"
+#include "Core/Types.h"
+#include "Rhi/CommandBuffer.h"
+#include "Rhi/Pipeline.h"
+#include "Rhi/RenderPass.h"
+
+namespace SnowEngine
+{
+	struct ObjectConstants
+	{
+		glm::mat4 Model;
+		u32 Index;
+	};
+
+	struct DrawCommand
+	{
+		const SnowEngine::Pipeline* Pipeline;
+		const SnowEngine::Mesh* Mesh;
+		glm::mat4 Transform;
+	};
+
+	/**
+	 * \brief Collects the draws of a frame, orders them by a packed 64 bit key and records them skipping redundant binds.
+	 * Key layout from the most significant bit: pass (4), pipeline (12), material (16), mesh (16), depth bucket (16).
+	 * Large queues can be split into slices recorded on the thread pool into secondary command buffers.
+	 */
+	class RenderQueue
+	{
+	public:
+		RenderQueue(u32 frameCount);
+
+		void Clear();
+		void Submit(u8 pass, const Pipeline* pipeline, const Mesh* mesh, const glm::mat4& transform, f32 depth);
+		void Sort();
+		void Record(const DescriptorSet* globalSet, u32 currentFrame, const std::shared_ptr<CommandBuffer>& cmd);
+		const std::vector<std::shared_ptr<CommandBuffer>>& RecordParallel(const std::shared_ptr<RenderPass>& renderPass, const DescriptorSet* globalSet, u32 currentFrame);
+
+		b8 PrefersParallel() const;
+		u32 Size() const;
+		u32 StateChanges() const;
+		u32 RecordThreads() const;
+
+	private:
+		struct SortEntry
+		{
+			u64 Key;
+			u32 Index;
+		};
+
+		u32 RecordRange(u32 begin, u32 end, const DescriptorSet* globalSet, u32 currentFrame, const std::shared_ptr<CommandBuffer>& cmd) const;
+
+		static u16 Intern(const void* object, std::unordered_map<const void*, u16>& ids, u32 capacity);
+		static void RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+
+		std::vector<DrawCommand> mCommands;
+		std::vector<SortEntry> mEntries;
+		std::vector<SortEntry> mScratch;
+		std::unordered_map<const void*, u16> mPipelineIds;
+		std::unordered_map<const void*, u16> mMaterialIds;
+		std::unordered_map<const void*, u16> mMeshIds;
+		std::vector<std::shared_ptr<CommandBuffer>> mSecondaryBuffers;
+		std::vector<std::shared_ptr<CommandBuffer>> mRecordedBuffers;
+		u32 mFrameCount;
+		u32 mStateChanges{ 0 };
+		u32 mRecordThreads{ 1 };
+	};
+}
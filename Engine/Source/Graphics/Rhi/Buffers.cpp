@@ -14,8 +14,8 @@ namespace SnowEngine
 		return std::make_shared<VkIndexBuffer>(indices, indexCount);
 	}
 
-	std::shared_ptr<StorageBuffer> StorageBuffer::Create(const u32 size)
+	std::shared_ptr<StorageBuffer> StorageBuffer::Create(const u32 size, const b8 hostVisible)
 	{
-		return std::make_shared<VkStorageBuffer>(size);
+		return std::make_shared<VkStorageBuffer>(size, hostVisible);
 	}
 }
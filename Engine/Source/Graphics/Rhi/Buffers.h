@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <memory>
 #include <glm/glm.hpp>
 
@@ -12,6 +13,7 @@ namespace SnowEngine
 		glm::vec3 Position;
 		glm::vec3 Color;
 		glm::vec2 Uv;
+		glm::vec3 Normal;
 	};
 
 	class VertexBuffer
@@ -37,10 +39,25 @@ namespace SnowEngine
 	class StorageBuffer
 	{
 	public:
-		static std::shared_ptr<StorageBuffer> Create(u32 size);
+		/** \brief Host visible buffers are persistently mapped and can be written directly with Write. */
+		static std::shared_ptr<StorageBuffer> Create(u32 size, b8 hostVisible = false);
 		virtual ~StorageBuffer() = default;
 
 		virtual void SetData(const std::shared_ptr<StorageBuffer>& other) const = 0;
 		virtual void SetData(const void* data) const = 0;
+		/** \brief Reads the whole buffer back, waits for the copy to complete. */
+		virtual void GetData(void* data) const = 0;
+		/** \brief Writes a sub-range of a host visible buffer without any copy on the gpu. */
+		virtual void Write(const void* data, u32 size, u32 offset) const = 0;
+
+		/** \brief Draws without vertex input, the vertex and instance counts are read on the gpu at offset. */
+		virtual void DrawIndirect(u32 offset, const std::shared_ptr<CommandBuffer>& cmd) const = 0;
+
+		/** \brief Never reused, unlike the address of a destroyed buffer. */
+		u64 Id() const { return mId; }
+
+	private:
+		inline static std::atomic<u64> sNextId{ 0 };
+		u64 mId{ sNextId++ };
 	};
 }
@@ -4,8 +4,8 @@
 
 namespace SnowEngine
 {
-	std::shared_ptr<CommandBuffer> CommandBuffer::Create(const u32 frameCount, const CommandBufferUsage usage)
+	std::shared_ptr<CommandBuffer> CommandBuffer::Create(const u32 frameCount, const CommandBufferUsage usage, const CommandBufferLevel level)
 	{
-		return std::make_shared<VkCommandBuffer>(frameCount, usage);
+		return std::make_shared<VkCommandBuffer>(frameCount, usage, level);
 	}
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include <memory>
+#include <vector>
 
 #include "Surface.h"
 #include "Core/Types.h"
@@ -13,15 +14,49 @@ namespace SnowEngine
 		Copy
 	};
 
+	enum class CommandBufferLevel
+	{
+		Primary,
+		Secondary //recorded inside a render pass and executed by a primary buffer
+	};
+
+	class RenderPass;
+	class StorageBuffer;
+	class CommandBuffer;
+
+	struct QueueDependency
+	{
+		std::shared_ptr<const CommandBuffer> Cmd;
+		u64 Value; //timeline value of the submission of Cmd to wait for
+	};
+
 	class CommandBuffer
 	{
 	public:
-		static std::shared_ptr<CommandBuffer> Create(u32 frameCount, CommandBufferUsage usage);
+		static std::shared_ptr<CommandBuffer> Create(u32 frameCount, CommandBufferUsage usage, CommandBufferLevel level = CommandBufferLevel::Primary);
 		virtual ~CommandBuffer() = default;
 
 		virtual void Begin(u32 currentFrame) const = 0;
+		virtual void Begin(u32 currentFrame, const std::shared_ptr<RenderPass>& renderPass) const = 0;
+		virtual void Execute(u32 currentFrame, const std::vector<std::shared_ptr<CommandBuffer>>& secondaries) const = 0;
 		virtual void End(u32 currentFrame) const = 0;
 		virtual void Submit(u32 currentFrame, const std::shared_ptr<const CommandBuffer>& previousCmd) const = 0;
 		virtual void Submit(u32 currentFrame, const std::shared_ptr<const Surface>& surface) const = 0;
+		virtual void Submit(u32 currentFrame, const std::vector<QueueDependency>& dependencies, const std::shared_ptr<const Surface>& surface = nullptr) const = 0;
+		virtual u64 TimelineValue() const = 0;
+
+		virtual void Release(const std::shared_ptr<StorageBuffer>& buffer, CommandBufferUsage destination) const = 0;
+		virtual void Acquire(const std::shared_ptr<StorageBuffer>& buffer, CommandBufferUsage source) const = 0;
+		/** \brief Makes the writes of previous dispatches visible to the following dispatches and indirect commands. */
+		virtual void ComputeBarrier() const = 0;
+
+		virtual void BeginTiming(u32 currentFrame) const = 0;
+		virtual void EndTiming(u32 currentFrame) const = 0;
+		virtual b8 Timing(u32 frameIndex, f64& begin, f64& end) const = 0;
+
+		/** \brief Counts the fragment shader invocations recorded between the two calls, outside of render passes. */
+		virtual void BeginStatistics(u32 currentFrame) const = 0;
+		virtual void EndStatistics(u32 currentFrame) const = 0;
+		virtual b8 FragmentInvocations(u32 frameIndex, u64& invocations) const = 0;
 	};
 }
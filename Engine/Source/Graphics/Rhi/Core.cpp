@@ -28,4 +28,22 @@ namespace SnowEngine
 	{
 		sInstance->DeviceWaitIdle();
 	}
+
+	/**
+	 * \brief True when compute shaders can use subgroup arithmetic operations.
+	 */
+	b8 GraphicsCore::SubgroupOperations()
+	{
+		return sInstance->DeviceSubgroupOperations();
+	}
+
+	PipelineCacheStats GraphicsCore::PipelineCacheStatistics()
+	{
+		return sInstance->DevicePipelineCacheStatistics();
+	}
+
+	void GraphicsCore::SetColdPipelineCache(const b8 cold)
+	{
+		sInstance->DeviceSetColdPipelineCache(cold);
+	}
 }
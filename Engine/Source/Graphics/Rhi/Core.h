@@ -1,7 +1,17 @@
 #pragma once
+#include "Core/Types.h"
 
 namespace SnowEngine
 {
+	struct PipelineCacheStats
+	{
+		u32 Pipelines{ 0 }; //created since startup
+		u32 Hits{ 0 }; //found in the cache by the driver, only counted with Feedback
+		f64 CreationTime{ 0.0 }; //milliseconds spent creating pipelines
+		b8 Loaded{ false }; //a cache of this device was read at startup
+		b8 Feedback{ false }; //the device reports cache hits through creation feedback
+	};
+
 	class GraphicsCore
 	{
 	public:
@@ -11,11 +21,21 @@ namespace SnowEngine
 		virtual ~GraphicsCore() = default;
 
 		static void WaitIdle();
+		static b8 SubgroupOperations();
+		static PipelineCacheStats PipelineCacheStatistics();
+		/**
+		 * \brief While set pipelines are created through an empty cache, as on the first launch, and are not persisted.
+		 * Pipelines must not be created on other threads meanwhile.
+		 */
+		static void SetColdPipelineCache(b8 cold);
 
 	protected:
 		GraphicsCore() = default;
 
 		virtual void DeviceWaitIdle() const = 0;
+		virtual b8 DeviceSubgroupOperations() const = 0;
+		virtual PipelineCacheStats DevicePipelineCacheStatistics() const = 0;
+		virtual void DeviceSetColdPipelineCache(b8 cold) const = 0;
 
 	private:
 		static GraphicsCore* sInstance;
@@ -9,4 +9,16 @@ namespace SnowEngine
 		const auto vkShader = std::static_pointer_cast<const VkShader>(shader);
 		return std::make_shared<VkDescriptorSet>(vkShader->Layouts().at(setIndex), frameCount);
 	}
+
+	std::shared_ptr<DescriptorSet> DescriptorSet::CreateTransient(const std::shared_ptr<const Shader>& shader, const u32 setIndex, const u32 currentFrame)
+	{
+		const auto vkShader = std::static_pointer_cast<const VkShader>(shader);
+		return std::make_shared<VkDescriptorSet>(vkShader->Layouts().at(setIndex), 1, currentFrame);
+	}
+
+	void DescriptorSet::SetUniform(const std::string& name, const void* data, const u32 currentFrame) const { SetUniform(Resolve(name), data, currentFrame); }
+
+	void DescriptorSet::SetImage(const std::string& name, const std::shared_ptr<Image>& image, const SamplerDesc& sampler) { SetImage(Resolve(name), image, sampler); }
+
+	void DescriptorSet::SetStorageBuffer(const std::string& name, const std::shared_ptr<StorageBuffer>& buffer) { SetStorageBuffer(Resolve(name), buffer); }
 }
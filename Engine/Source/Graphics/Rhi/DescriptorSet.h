@@ -6,14 +6,36 @@
 
 namespace SnowEngine
 {
+	using bindingHandle = u32;
+
 	class DescriptorSet
 	{
 	public:
 		static std::shared_ptr<DescriptorSet> Create(const std::shared_ptr<const Shader>& shader, u32 setIndex, u32 frameCount);
+		/**
+		 * \brief Set recreated every frame, taken from pools that are reset as a whole once the frame slot comes around
+		 * again. It is only valid for currentFrame and its storage buffers start unset, they must all be given before it
+		 * is bound.
+		 */
+		static std::shared_ptr<DescriptorSet> CreateTransient(const std::shared_ptr<const Shader>& shader, u32 setIndex, u32 currentFrame);
 		virtual ~DescriptorSet() = default;
 
-		virtual void SetUniform(const std::string& name, const void* data, u32 currentFrame) const = 0;
-		virtual void SetImage(const std::string& name, const std::shared_ptr<Image>& image) = 0;
-		virtual void SetStorageBuffer(const std::string& name, const std::shared_ptr<StorageBuffer>& buffer) = 0;
+		/**
+		 * \brief Looks the named resource up once, so frequent updates can skip comparing names.
+		 * \return The handle of the resource, valid for every set created from the same shader and set index, or
+		 * sNoBinding when there is no such resource.
+		 */
+		virtual bindingHandle Resolve(const std::string& name) const = 0;
+
+		/** \brief The data is only kept for the current frame, a set must be given its uniforms every frame it is bound in. */
+		virtual void SetUniform(bindingHandle handle, const void* data, u32 currentFrame) const = 0;
+		virtual void SetImage(bindingHandle handle, const std::shared_ptr<Image>& image, const SamplerDesc& sampler = {}) = 0;
+		virtual void SetStorageBuffer(bindingHandle handle, const std::shared_ptr<StorageBuffer>& buffer) = 0;
+
+		void SetUniform(const std::string& name, const void* data, u32 currentFrame) const;
+		void SetImage(const std::string& name, const std::shared_ptr<Image>& image, const SamplerDesc& sampler = {});
+		void SetStorageBuffer(const std::string& name, const std::shared_ptr<StorageBuffer>& buffer);
+
+		static constexpr bindingHandle sNoBinding{ ~0u };
 	};
 }
@@ -0,0 +1,12 @@
+#include "GeometryPool.h"
+
+#include "Graphics/Vulkan/VkCore.h"
+#include "Graphics/Vulkan/VkGeometryPool.h"
+
+namespace SnowEngine
+{
+	GeometryPool* GeometryPool::Get()
+	{
+		return &VkCore::Get()->GeometryPool();
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <memory>
+
+#include "Buffers.h"
+#include "CommandBuffer.h"
+#include "Core/Types.h"
+
+namespace SnowEngine
+{
+	struct GeometryRange
+	{
+		u32 VertexOffset{ 0 };
+		u32 VertexCount{ 0 };
+		u32 FirstIndex{ 0 };
+		u32 IndexCount{ 0 };
+	};
+
+	/**
+	 * \brief Shared vertex and index storage for every mesh, so a whole pass binds geometry once.
+	 */
+	class GeometryPool
+	{
+	public:
+		static GeometryPool* Get();
+		virtual ~GeometryPool() = default;
+
+		virtual b8 Allocate(const Vertex* vertices, u32 vertexCount, const u32* indices, u32 indexCount, GeometryRange& range) = 0;
+		virtual void Free(const GeometryRange& range) = 0;
+
+		virtual void Bind(const std::shared_ptr<CommandBuffer>& cmd) const = 0;
+		virtual void Draw(const GeometryRange& range, const std::shared_ptr<CommandBuffer>& cmd) const = 0;
+	};
+}
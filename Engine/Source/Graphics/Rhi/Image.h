@@ -1,13 +1,57 @@
 #pragma once
+#include <array>
+#include <atomic>
 #include <filesystem>
+#include <memory>
+
+#include "Core/Types.h"
 
 namespace SnowEngine
 {
+	enum class SamplerFilter : u32
+	{
+		Nearest,
+		Linear
+	};
+
+	enum class SamplerAddressMode : u32
+	{
+		Repeat,
+		MirroredRepeat,
+		ClampToEdge,
+		ClampToBorder
+	};
+
+	/**
+	 * \brief How an image is sampled, identical descriptions share a single sampler. The default filters trilinearly and
+	 * anisotropically with repeating coordinates.
+	 */
+	struct SamplerDesc
+	{
+		SamplerFilter Filter{ SamplerFilter::Linear };
+		SamplerFilter MipFilter{ SamplerFilter::Linear };
+		SamplerAddressMode AddressU{ SamplerAddressMode::Repeat };
+		SamplerAddressMode AddressV{ SamplerAddressMode::Repeat };
+		SamplerAddressMode AddressW{ SamplerAddressMode::Repeat };
+		f32 Anisotropy{ 16.0f }; //clamped to the device limit, 1 disables it
+		f32 MinLod{ 0.0f };
+		f32 MaxLod{ 1000.0f }; //no clamp
+
+		b8 operator==(const SamplerDesc& other) const = default;
+	};
+
 	class Image
 	{
 	public:
 		static std::shared_ptr<Image> Create(const std::filesystem::path& source);
 		static std::shared_ptr<Image> Create(const std::array<std::filesystem::path, 6>& sources);
 		virtual ~Image() = default;
+
+		/** \brief Never reused, unlike the address of a destroyed image. */
+		u64 Id() const { return mId; }
+
+	private:
+		inline static std::atomic<u64> sNextId{ 0 };
+		u64 mId{ sNextId++ };
 	};
 }
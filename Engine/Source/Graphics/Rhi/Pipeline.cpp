@@ -1,5 +1,6 @@
 #include "Pipeline.h"
 
+#include "Core/ThreadPool.h"
 #include "Graphics/Vulkan/VkPipeline.h"
 
 namespace SnowEngine
@@ -13,8 +14,30 @@ namespace SnowEngine
 		return std::make_shared<VkPipeline>(settings);
 	}
 
+	std::vector<std::future<std::shared_ptr<Pipeline>>> Pipeline::CreateBatch(const std::vector<PipelineSettings>& settings)
+	{
+		std::vector<std::future<std::shared_ptr<Pipeline>>> pipelines{};
+		pipelines.reserve(settings.size());
+
+		for (const auto& pipelineSettings : settings)
+			pipelines.emplace_back(ThreadPool::Get().Submit([pipelineSettings] { return Create(pipelineSettings); }));
+
+		return pipelines;
+	}
+
 	std::shared_ptr<ComputePipeline> ComputePipeline::Create(const std::shared_ptr<const Shader>& shader)
 	{
 		return std::make_shared<VkComputePipeline>(std::static_pointer_cast<const VkShader>(shader));
 	}
+
+	std::vector<std::future<std::shared_ptr<ComputePipeline>>> ComputePipeline::CreateBatch(const std::vector<std::shared_ptr<const Shader>>& shaders)
+	{
+		std::vector<std::future<std::shared_ptr<ComputePipeline>>> pipelines{};
+		pipelines.reserve(shaders.size());
+
+		for (const auto& shader : shaders)
+			pipelines.emplace_back(ThreadPool::Get().Submit([shader] { return Create(shader); }));
+
+		return pipelines;
+	}
 }
@@ -1,4 +1,7 @@
 #pragma once
+#include <future>
+#include <vector>
+
 #include "DescriptorSet.h"
 #include "Shader.h"
 #include "RenderPass.h"
@@ -6,6 +9,32 @@
 
 namespace SnowEngine
 {
+	enum class CompareOp
+	{
+		Never,
+		Less,
+		Equal,
+		LessOrEqual,
+		Greater,
+		NotEqual,
+		GreaterOrEqual,
+		Always
+	};
+
+	enum class BlendMode
+	{
+		None,
+		Alpha, //source over destination, weighted by the source alpha
+		Additive
+	};
+
+	enum class PrimitiveTopology
+	{
+		TriangleList,
+		LineList,
+		PointList
+	};
+
 	struct PipelineSettings
 	{
 		PipelineSettings(const std::shared_ptr<const Shader>& shader, const std::shared_ptr<const RenderPass>& renderPass, u32 width, u32 height);
@@ -18,25 +47,45 @@ namespace SnowEngine
 		b8 BackfaceCulling = true;
 		b8 DepthTest = true;
 		b8 DepthWrite = true;
+		CompareOp DepthCompare = CompareOp::Less;
+		b8 ColorWrite = true; //false also leaves out the fragment stage, for depth only draws
+		b8 VertexInput = true; //false for shaders that fetch their vertices from storage buffers
+		f32 DepthBiasConstant = 0.0f; //both zero disables the depth bias
+		f32 DepthBiasSlope = 0.0f;
+		BlendMode Blend = BlendMode::None;
+		PrimitiveTopology Topology = PrimitiveTopology::TriangleList;
+
+		b8 operator==(const PipelineSettings& other) const = default;
 	};
 
 	class Pipeline
 	{
 	public:
 		static std::shared_ptr<Pipeline> Create(const PipelineSettings& settings);
+		/**
+		 * \brief Creates the pipelines concurrently on the thread pool, their shaders must already be compiled.
+		 * \return A future for every settings, in the same order.
+		 */
+		static std::vector<std::future<std::shared_ptr<Pipeline>>> CreateBatch(const std::vector<PipelineSettings>& settings);
 		virtual ~Pipeline() = default;
 
 		virtual void Bind(const std::shared_ptr<CommandBuffer>& cmd) const = 0;
 		virtual void BindDescriptorSet(const DescriptorSet* set, u32 currentFrame, const std::shared_ptr<CommandBuffer>& cmd) const = 0;
+		virtual void PushConstants(const void* data, u32 size, const std::shared_ptr<CommandBuffer>& cmd) const = 0;
+		/** \brief Number of leading descriptor sets that stay bound when switching from the other pipeline to this one. */
+		virtual u32 CompatibleSets(const Pipeline* other) const = 0;
 	};
 
 	class ComputePipeline
 	{
 	public:
 		static std::shared_ptr<ComputePipeline> Create(const std::shared_ptr<const Shader>& shader);
+		static std::vector<std::future<std::shared_ptr<ComputePipeline>>> CreateBatch(const std::vector<std::shared_ptr<const Shader>>& shaders);
 		virtual ~ComputePipeline() = default;
 
 		virtual void Dispatch(u32 x, u32 y, u32 z, const std::shared_ptr<CommandBuffer>& cmd) const = 0;
+		virtual void DispatchIndirect(const std::shared_ptr<StorageBuffer>& arguments, u32 offset, const std::shared_ptr<CommandBuffer>& cmd) const = 0;
 		virtual void BindDescriptorSet(const DescriptorSet* set, u32 currentFrame, const std::shared_ptr<CommandBuffer>& cmd) const = 0;
+		virtual void PushConstants(const void* data, u32 size, const std::shared_ptr<CommandBuffer>& cmd) const = 0;
 	};
 }
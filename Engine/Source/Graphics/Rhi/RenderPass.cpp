@@ -13,4 +13,9 @@ namespace SnowEngine
 	{
 		return std::make_shared<VkRenderPass>(frameCount, width, height, depth);
 	}
+
+	std::shared_ptr<RenderPass> RenderPass::CreateDepth(u32 width, u32 height)
+	{
+		return std::make_shared<VkRenderPass>(width, height);
+	}
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <memory>
 
+#include "Image.h"
 #include "Surface.h"
 
 namespace SnowEngine
@@ -10,12 +11,27 @@ namespace SnowEngine
 	public:
 		static std::shared_ptr<RenderPass> Create(const std::shared_ptr<const Surface>& surface, b8 depth);
 		static std::shared_ptr<RenderPass> Create(u32 frameCount, u32 width, u32 height, b8 depth);
+		/**
+		 * \brief Depth only pass rendering into a single sampled depth image shared by every frame, the regions a pass
+		 * does not touch keep their contents so the image can hold cached data, e.g. a shadow atlas.
+		 */
+		static std::shared_ptr<RenderPass> CreateDepth(u32 width, u32 height);
 		virtual ~RenderPass() = default;
 
 		virtual u32 Width() const = 0;
 		virtual u32 Height() const = 0;
+		/** \brief Size of the region Begin renders to, the top left part of the attachments covered by the render scale. */
+		virtual u32 RenderWidth() const = 0;
+		virtual u32 RenderHeight() const = 0;
+		virtual f32 RenderScale() const = 0;
+		/** \brief Renders to a fraction of the attachments in both dimensions without reallocating them. */
+		virtual void SetRenderScale(f32 scale) = 0;
+		virtual Image* ColorImage(u32 frameIndex) const = 0; //nullptr when rendering to a surface
+		virtual std::shared_ptr<Image> DepthImage() const = 0; //nullptr unless created with CreateDepth
 
-		virtual void Begin(const std::shared_ptr<CommandBuffer>& cmd) = 0;
+		virtual void Begin(const std::shared_ptr<CommandBuffer>& cmd, b8 secondaryCommands = false) = 0;
+		/** \brief Begins the pass clearing and rendering only inside the given region of the attachments. */
+		virtual void BeginRegion(const std::shared_ptr<CommandBuffer>& cmd, u32 x, u32 y, u32 width, u32 height) = 0;
 		virtual void End(const std::shared_ptr<CommandBuffer>& cmd) const = 0;
 	};
 }
@@ -1,24 +1,50 @@
 #include "Shader.h"
+#include "Core/ThreadPool.h"
 #include "Graphics/Vulkan/VkShader.h"
 
 namespace SnowEngine
 {
 	std::map<std::string, std::shared_ptr<Shader>> Shader::sShaders;
+	std::mutex Shader::sShadersMutex;
 
 	std::shared_ptr<Shader> Shader::Create(const GraphicShaderSource& source, const std::string& name)
 	{
-		sShaders[name] = std::make_shared<VkShader>(source);
-		return sShaders[name];
+		//compiled outside the lock, batches compile on several threads at once
+		std::shared_ptr<Shader> shader{ std::make_shared<VkShader>(source) };
+
+		std::lock_guard lock{ sShadersMutex };
+		sShaders[name] = shader;
+		return shader;
 	}
 
 	std::shared_ptr<Shader> Shader::Create(const ComputeShaderSource& source, const std::string& name)
 	{
-		sShaders[name] = std::make_shared<VkShader>(source);
-		return sShaders[name];
+		std::shared_ptr<Shader> shader{ std::make_shared<VkShader>(source) };
+
+		std::lock_guard lock{ sShadersMutex };
+		sShaders[name] = shader;
+		return shader;
+	}
+
+	std::vector<std::future<std::shared_ptr<Shader>>> Shader::CreateBatch(const std::vector<NamedShaderSource>& sources)
+	{
+		std::vector<std::future<std::shared_ptr<Shader>>> shaders{};
+		shaders.reserve(sources.size());
+
+		for (const auto& [name, source] : sources)
+		{
+			shaders.emplace_back(ThreadPool::Get().Submit([name, source]
+			{
+				return std::visit([&name](const auto& shaderSource) { return Create(shaderSource, name); }, source);
+			}));
+		}
+
+		return shaders;
 	}
 
 	b8 Shader::GetShader(const std::string& name, std::shared_ptr<Shader>& shader)
 	{
+		std::lock_guard lock{ sShadersMutex };
 		if (sShaders.contains(name))
 		{
 			shader = sShaders[name];
@@ -26,4 +52,6 @@ namespace SnowEngine
 		}
 		return false;
 	}
+
+	ShaderCacheStats Shader::CacheStatistics() { return VkShaderCache::Stats(); }
 }
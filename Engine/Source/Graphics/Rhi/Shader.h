@@ -1,6 +1,11 @@
 #pragma once
 #include <filesystem>
+#include <future>
 #include <map>
+#include <mutex>
+#include <string>
+#include <variant>
+#include <vector>
 
 #include "Core/Types.h"
 
@@ -26,6 +31,21 @@ namespace SnowEngine
 	struct ComputeShaderSource
 	{
 		shaderSource Comp;
+
+		std::vector<std::string> Defines{}; //macros defined before compiling, e.g. to select a variant
+	};
+
+	struct NamedShaderSource
+	{
+		std::string Name;
+		std::variant<GraphicShaderSource, ComputeShaderSource> Source;
+	};
+
+	struct ShaderCacheStats
+	{
+		u32 Stages{ 0 };
+		u32 Hits{ 0 }; //stages loaded from the shader cache instead of compiled
+		f64 SetupTime{ 0.0 }; //ms spent compiling or loading and reflecting stages
 	};
 
 	class Shader
@@ -33,10 +53,17 @@ namespace SnowEngine
 	public:
 		static std::shared_ptr<Shader> Create(const GraphicShaderSource& source, const std::string& name);
 		static std::shared_ptr<Shader> Create(const ComputeShaderSource& source, const std::string& name);
+		/**
+		 * \brief Compiles the shaders concurrently on the thread pool.
+		 * \return A future for every source, in the same order.
+		 */
+		static std::vector<std::future<std::shared_ptr<Shader>>> CreateBatch(const std::vector<NamedShaderSource>& sources);
 
 		static b8 GetShader(const std::string& name, std::shared_ptr<Shader>& shader);
+		static ShaderCacheStats CacheStatistics();
 
 	private:
 		static std::map<std::string, std::shared_ptr<Shader>> sShaders;
+		static std::mutex sShadersMutex;
 	};
 }
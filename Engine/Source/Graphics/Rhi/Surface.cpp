@@ -4,8 +4,8 @@
 
 namespace SnowEngine
 {
-	std::shared_ptr<Surface> Surface::Create(std::shared_ptr<const Window> window)
+	std::shared_ptr<Surface> Surface::Create(std::shared_ptr<const Window> window, u32 framesInFlight)
 	{
-		return std::make_shared<VkSurface>(window);
+		return std::make_shared<VkSurface>(window, framesInFlight);
 	}
 }
@@ -7,16 +7,58 @@ namespace SnowEngine
 {
 	class CommandBuffer;
 
+	enum class LatencyMode
+	{
+		Fifo, //vsync, the cpu may queue up to the frames in flight
+		Mailbox, //the newest frame replaces the queued one, no tearing but the gpu is not throttled
+		FifoRelaxed, //vsync unless a frame misses the refresh, it tears instead of waiting for the next one
+		JustInTime //vsync, the input is sampled only once the previous frame has completed on the gpu
+	};
+
+	/** \brief Milliseconds measured on the cpu up to the call that queues the frame for presentation. */
+	struct LatencyStats
+	{
+		f64 InputToPresent{ 0.0 }; //average, from the first input event a frame reads
+		f64 MaxInputToPresent{ 0.0 };
+		u32 InputFrames{ 0 }; //frames that read at least one input event
+		f64 SampleToPresent{ 0.0 }; //average, from Pace, measured for every frame
+		u32 Frames{ 0 };
+	};
+
 	class Surface
 	{
 	public:
-		static std::shared_ptr<Surface> Create(std::shared_ptr<const Window> window);
+		/**
+		 * \brief Creates the swapchain of the window.
+		 * \param framesInFlight Frames the cpu may record ahead of the gpu, between 1 and sMaxFramesInFlight. Fewer
+		 * frames lower the latency, more let the cpu and the gpu overlap.
+		 */
+		static std::shared_ptr<Surface> Create(std::shared_ptr<const Window> window, u32 framesInFlight = 2);
 		virtual ~Surface() = default;
 
-		virtual u32 ImageCount() const = 0;
+		virtual u32 ImageCount() const = 0; //swapchain images, unrelated to the frames in flight
+		/** \brief Number of frames every per frame resource must hold, CurrentFrame indexes them. */
+		virtual u32 FramesInFlight() const = 0;
 		virtual u32 CurrentFrame() const = 0;
 
+		virtual LatencyMode GetLatencyMode() const = 0;
+		virtual b8 SupportsLatencyMode(LatencyMode mode) const = 0;
+		/**
+		 * \brief Recreates the swapchain with the present mode of the given latency mode and resets the latency statistics.
+		 * \return False when the mode is not supported, the current one is kept.
+		 */
+		virtual b8 SetLatencyMode(LatencyMode mode) = 0;
+		virtual const LatencyStats& Latency() const = 0;
+		virtual void ResetLatency() = 0;
+
+		/**
+		 * \brief Must be called every frame right before the input is polled. In just in time mode it blocks until the
+		 * previous frame has completed on the gpu, so recording starts with the freshest input.
+		 */
+		virtual void Pace() = 0;
 		virtual void Begin() = 0;
 		virtual void End(const std::shared_ptr<const CommandBuffer>& commandBuffer) = 0;
+
+		static constexpr u32 sMaxFramesInFlight{ 3 };
 	};
 }
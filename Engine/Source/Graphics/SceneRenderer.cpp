@@ -1,5 +1,8 @@
 #include "SceneRenderer.h"
 
+#include <algorithm>
+#include <chrono>
+
 #include "Core/Components.h"
 #include "Core/Entity.h"
 
@@ -50,32 +53,81 @@ namespace SnowEngine
 		4, 1, 5
 	};
 
+	//render queue passes, recorded in this order
+	static constexpr u8 sDepthPass{ 0 };
+	static constexpr u8 sOpaquePass{ 1 };
+
 	SceneRenderer::SceneRenderer(const std::shared_ptr<Surface>& surface)
+		: mQueue{ surface->FramesInFlight() }
 	{
-		mRenderPass = RenderPass::Create(surface->ImageCount(), 1920, 1080, true);
-		mShader = Shader::Create(
+		mRenderPass = RenderPass::Create(surface->FramesInFlight(), 1920, 1080, true);
+
+		//every shader compiles on the thread pool, the rest of the setup only waits for the ones it uses
+		auto shaders{ Shader::CreateBatch(
 		{
-			{ "D:/Dev/SnowEngine/Engine/Resources/Shaders/default.vert", ShaderType::Vertex },
-			{ "D:/Dev/SnowEngine/Engine/Resources/Shaders/default.frag", ShaderType::Fragment },
-			{}
-		}, "default");
-		mPipeline = Pipeline::Create({ mShader, mRenderPass, 2560, 1440 });
-		mCmdBuffer = CommandBuffer::Create(surface->ImageCount(), CommandBufferUsage::Graphics);
+			{ "default", GraphicShaderSource
+			{
+				{ "D:/Dev/SnowEngine/Engine/Resources/Shaders/default.vert", ShaderType::Vertex },
+				{ "D:/Dev/SnowEngine/Engine/Resources/Shaders/default.frag", ShaderType::Fragment },
+				{}
+			} },
+			{ "light_culling", ComputeShaderSource
+			{
+				{ "D:/Dev/SnowEngine/Engine/Resources/Shaders/light_culling.comp", ShaderType::Compute }
+			} },
+			{ "shadow", GraphicShaderSource
+			{
+				{ "D:/Dev/SnowEngine/Engine/Resources/Shaders/shadow.vert", ShaderType::Vertex },
+				{ "D:/Dev/SnowEngine/Engine/Resources/Shaders/shadow.frag", ShaderType::Fragment },
+				{}
+			} },
+			{ "skybox", GraphicShaderSource
+			{
+				{ "D:/Dev/SnowEngine/Engine/Resources/Shaders/skybox.vert", ShaderType::Vertex },
+				{ "D:/Dev/SnowEngine/Engine/Resources/Shaders/skybox.frag", ShaderType::Fragment },
+				{}
+			} },
+			{ "emitter", GraphicShaderSource
+			{
+				{ "D:/Dev/SnowEngine/Engine/Resources/Shaders/emitter.vert", ShaderType::Vertex },
+				{ "D:/Dev/SnowEngine/Engine/Resources/Shaders/emitter.frag", ShaderType::Fragment },
+				{}
+			} },
+			{ "emitter_simulation", ComputeShaderSource
+			{
+				{ "D:/Dev/SnowEngine/Engine/Resources/Shaders/emitter.comp", ShaderType::Compute }
+			} }
+		}) };
 
-		mGlobalDescriptorSet = DescriptorSet::Create(mShader, 0, 2);
+		mFrameCount = surface->FramesInFlight();
+		mCmdBuffer = CommandBuffer::Create(mFrameCount, CommandBufferUsage::Graphics);
+		mRenderedPixels.resize(mFrameCount, 0);
 
-		mSkyboxShader = Shader::Create(
-		{
-			{ "D:/Dev/SnowEngine/Engine/Resources/Shaders/skybox.vert", ShaderType::Vertex },
-			{ "D:/Dev/SnowEngine/Engine/Resources/Shaders/skybox.frag", ShaderType::Fragment },
-			{}
-		}, "skybox");
+		mComputeCmdBuffer = CommandBuffer::Create(mFrameCount, CommandBufferUsage::Compute);
+		mComputeGraph = RenderGraph::Create(mFrameCount);
+		mSharedBuffers.resize(mFrameCount);
+		mAcquiredBuffers.resize(mFrameCount);
+		mGraphicsValues.resize(mFrameCount, 0);
+
+		mShader = shaders[0].get();
+		mGlobalDescriptorSets.resize(mFrameCount);
+		for (auto& set : mGlobalDescriptorSets)
+			set = DescriptorSet::Create(mShader, 0, mFrameCount);
+		mGlobalCamera = mGlobalDescriptorSets[0]->Resolve("Camera");
+
+		mLightCullingShader = shaders[1].get();
+		mLighting = std::make_unique<ClusteredLighting>(mFrameCount);
+
+		mShadowShader = shaders[2].get();
+		mShadows = std::make_unique<CascadedShadowMaps>();
 
-		PipelineSettings settings{ mSkyboxShader, mRenderPass, 2560, 1440 };
-		settings.BackfaceCulling = false;
-		settings.DepthWrite = false;
+		for (u32 i{ 0 }; i < mFrameCount; i++)
+		{
+			mLighting->SetResources(*mGlobalDescriptorSets[i], i);
+			mShadows->SetResources(*mGlobalDescriptorSets[i]);
+		}
 
-		mSkyboxPipeline = Pipeline::Create(settings);
+		mSkyboxShader = shaders[3].get();
 
 		mSkyboxImage = Image::Create(
 		{
@@ -87,29 +139,194 @@ namespace SnowEngine
 			"D:/Dev/SnowEngine/Engine/Resources/Images/back.jpg"
 		});
 
-		mSkyboxDescriptorSet = DescriptorSet::Create(mSkyboxShader, 0, 2);
-		mSkyboxDescriptorSet->SetImage("skybox", mSkyboxImage);
+		mSkyboxDescriptorSet = DescriptorSet::Create(mSkyboxShader, 0, surface->FramesInFlight());
+		mSkyboxCamera = mSkyboxDescriptorSet->Resolve("Camera");
+		mSkyboxDescriptorSet->SetImage("skybox", mSkyboxImage, { SamplerFilter::Linear, SamplerFilter::Linear, SamplerAddressMode::ClampToEdge, SamplerAddressMode::ClampToEdge, SamplerAddressMode::ClampToEdge });
+		mSkyboxCmdBuffer = CommandBuffer::Create(surface->FramesInFlight(), CommandBufferUsage::Graphics, CommandBufferLevel::Secondary);
+
+		GeometryPool::Get()->Allocate(sCubeVertices.data(), static_cast<u32>(sCubeVertices.size()), sCubeIndices.data(), static_cast<u32>(sCubeIndices.size()), mSkyboxGeometry);
+
+		mParticleShader = shaders[4].get();
+		mParticleDescriptorSet = DescriptorSet::Create(mParticleShader, 0, surface->FramesInFlight());
+		mParticleCamera = mParticleDescriptorSet->Resolve("Camera");
 
-		mSkyboxVertexBuffer = VertexBuffer::Create(sCubeVertices.data(), static_cast<u32>(sCubeVertices.size()));
-		mSkyboxIndexBuffer = IndexBuffer::Create(sCubeIndices.data(), static_cast<u32>(sCubeIndices.size()));
+		mParticleSimulationShader = shaders[5].get();
+
+		CreatePipelines();
 
 		mCamera = std::make_shared<FirstPersonCamera>();
 	}
 
+	SceneRenderer::~SceneRenderer()
+	{
+		GeometryPool::Get()->Free(mSkyboxGeometry);
+	}
+
+	/**
+	 * \brief Creates every pipeline of the renderer from its shaders and render passes, replacing the current ones.
+	 * The gpu must be done with the replaced pipelines.
+	 */
+	void SceneRenderer::CreatePipelines()
+	{
+		const PipelineSettings settings{ SceneSettings(false, false, false) };
+		const PipelineSettings depthSettings{ SceneSettings(true, false, false) };
+		const PipelineSettings depthEqualSettings{ SceneSettings(false, true, false) };
+
+		PipelineSettings shadowSettings{ mShadowShader, mShadows->GetRenderPass(), 2048, 2048 };
+		shadowSettings.BackfaceCulling = false;
+		shadowSettings.DepthBiasConstant = 1.25f;
+		shadowSettings.DepthBiasSlope = 1.75f;
+
+		PipelineSettings skyboxSettings{ mSkyboxShader, mRenderPass, 2560, 1440 };
+		skyboxSettings.BackfaceCulling = false;
+		skyboxSettings.DepthWrite = false;
+		skyboxSettings.DepthCompare = CompareOp::LessOrEqual; //the sky lies exactly on the cleared far plane
+
+		PipelineSettings particleSettings{ mParticleShader, mRenderPass, 2560, 1440 };
+		particleSettings.BackfaceCulling = false;
+		particleSettings.VertexInput = false;
+
+		auto pipelines{ Pipeline::CreateBatch({ settings, depthSettings, depthEqualSettings, shadowSettings, skyboxSettings, particleSettings }) };
+		auto computePipelines{ ComputePipeline::CreateBatch({ mLightCullingShader, mParticleSimulationShader }) };
+
+		mPipeline = pipelines[0].get();
+		mDepthPipeline = pipelines[1].get();
+		mDepthEqualPipeline = pipelines[2].get();
+		mShadowPipeline = pipelines[3].get();
+		mSkyboxPipeline = pipelines[4].get();
+		mParticlePipeline = pipelines[5].get();
+
+		mLightCullingPipeline = computePipelines[0].get();
+		mParticleSimulationPipeline = computePipelines[1].get();
+
+		//the other permutations are requested while drawing and fall back to these until compiled
+		mPipelines.Clear();
+		mPipelines.Add(settings, mPipeline);
+		mPipelines.Add(depthSettings, mDepthPipeline);
+		mPipelines.Add(depthEqualSettings, mDepthEqualPipeline);
+	}
+
+	PipelineSettings SceneRenderer::SceneSettings(const b8 depthOnly, const b8 prePass, const b8 doubleSided) const
+	{
+		//the pre-pass shares the layout of the shaded pipelines so both bind the same sets
+		PipelineSettings settings{ mShader, mRenderPass, 2560, 1440 };
+		settings.BackfaceCulling = !doubleSided;
+
+		if (depthOnly)
+			settings.ColorWrite = false;
+		else if (prePass)
+		{
+			settings.DepthWrite = false;
+			settings.DepthCompare = CompareOp::Equal;
+		}
+
+		return settings;
+	}
+
 	void SceneRenderer::SetCamera(const std::shared_ptr<CameraController>& camera) { mCamera = camera; }
 
 	const std::shared_ptr<RenderPass>& SceneRenderer::GetRenderPass() const { return mRenderPass; }
 
 	const std::shared_ptr<CommandBuffer>& SceneRenderer::GetCommandBuffer() const { return mCmdBuffer; }
 
+	const RenderStats& SceneRenderer::Stats() const { return mStats; }
+
+	DynamicResolution& SceneRenderer::Resolution() { return mResolution; }
+
+	b8 SceneRenderer::DepthPrePass() const { return mDepthPrePass; }
+
+	b8 SceneRenderer::SkyboxLast() const { return mSkyboxLast; }
+
+	void SceneRenderer::SetDepthPrePass(const b8 enabled) { mDepthPrePass = enabled; }
+
+	void SceneRenderer::SetSkyboxLast(const b8 enabled) { mSkyboxLast = enabled; }
+
 	void SceneRenderer::SetScene(const std::shared_ptr<Scene>& scene) { mScene = scene;	}
 
 	void SceneRenderer::Update(f32 dt)
 	{
 		mCamera->Update(dt);
+		mDeltaTime = dt;
+	}
+
+	/**
+	 * \brief Begins the scene command buffer and submits the light culling and the simulation of every particle system
+	 * in the scene to the compute queue, where they run while the graphics queue still draws the previous frame.
+	 */
+	void SceneRenderer::BeginFrame(const u32 currentFrame)
+	{
+		mCmdBuffer->Begin(currentFrame);
+		mCmdBuffer->BeginTiming(currentFrame); //drives the dynamic resolution of the scene
+
+		UpdateResolution(currentFrame);
+
+		b8 hasSun{ false };
+		glm::vec3 sunDirection{ 0.0f, -1.0f, 0.0f };
+		glm::vec3 sunRadiance{ 0.0f };
+
+		mLighting->Clear();
+		mStaticCasters.clear();
+		mDynamicCasters.clear();
+		mScene->ExecuteSystem([&](const Entity& e)
+		{
+			if (e.HasComponents<Component::Transform, Component::Light>())
+			{
+				const auto [transform, light] = e.GetComponents<Component::Transform, Component::Light>();
+
+				//the first directional light is the one casting shadows, the others are ignored
+				if (light.Source.Type != LightType::Directional)
+					mLighting->AddLight(light.Source, transform.Position, transform.Forward());
+				else if (!hasSun)
+				{
+					hasSun = true;
+					sunDirection = transform.Forward();
+					sunRadiance = light.Source.Color * light.Source.Intensity;
+				}
+			}
+
+			if (e.HasComponents<Component::Transform, Component::Mesh>())
+			{
+				const auto [transform, mesh] = e.GetComponents<Component::Transform, Component::Mesh>();
+
+				(mesh.Static ? mStaticCasters : mDynamicCasters).push_back({ mesh.Model.get(), transform.Model() });
+			}
+		});
+
+		mShadows->SetLight(sunDirection, sunRadiance);
+
+		SubmitCompute(currentFrame);
+	}
+
+	/**
+	 * \brief Adds the shadow maps and imports what the compute queue produced for the scene pass, the passes must
+	 * precede the scene pass.
+	 */
+	void SceneRenderer::AddShadowPasses(RenderGraph& graph, const u32 currentFrame)
+	{
+		mShadows->AddPasses(graph, mShadowPipeline.get(), mCamera->View(), mCamera->Projection(), mCamera->Near(), mCamera->Far(), mStaticCasters, mDynamicCasters);
+		mStats.StaticShadowCascades = mShadows->RenderedStaticCascades();
+
+		mLighting->ImportReads(graph, currentFrame);
+		for (auto* system : mParticleSystems)
+			system->ImportDraw(graph, currentFrame);
 	}
 
-	void SceneRenderer::Draw(const std::shared_ptr<Surface>& surface) const
+	/**
+	 * \brief Declares the resources the scene pass reads besides its attachments.
+	 */
+	void SceneRenderer::DeclareSceneReads(RenderGraphBuilder& builder) const
+	{
+		mLighting->DeclareReads(builder);
+		mShadows->DeclareReads(builder);
+
+		for (const auto* system : mParticleSystems)
+			system->DeclareDraw(builder);
+	}
+
+	/**
+	 * \brief Records the scene pass into the scene command buffer, which the caller has already begun.
+	 */
+	void SceneRenderer::Draw(const std::shared_ptr<Surface>& surface)
 	{
 		struct Camera
 		{
@@ -121,36 +338,256 @@ namespace SnowEngine
 		camera.View = mCamera->View();
 		camera.Projection = mCamera->Projection();
 
-		mCmdBuffer->Begin(surface->CurrentFrame());
+		const auto& globalSet{ mGlobalDescriptorSets[surface->CurrentFrame()] };
 
-		mRenderPass->Begin(mCmdBuffer);
+		mSkyboxDescriptorSet->SetUniform(mSkyboxCamera, &camera, surface->CurrentFrame());
+		mParticleDescriptorSet->SetUniform(mParticleCamera, &camera, surface->CurrentFrame());
+		globalSet->SetUniform(mGlobalCamera, &camera, surface->CurrentFrame());
+		mLighting->SetUniforms(*globalSet, surface->CurrentFrame());
+		mShadows->SetUniforms(*globalSet, surface->CurrentFrame());
 
-		mSkyboxDescriptorSet->SetUniform("Camera", &camera, surface->CurrentFrame());
+		ReadFragmentStatistics(surface->CurrentFrame());
 
-		mSkyboxPipeline->Bind(mCmdBuffer);
-		mSkyboxPipeline->BindDescriptorSet(mSkyboxDescriptorSet.get(), surface->CurrentFrame(), mCmdBuffer);
+		const auto recordStart = std::chrono::high_resolution_clock::now();
 
-		mSkyboxVertexBuffer->Bind(mCmdBuffer);
-		mSkyboxIndexBuffer->Bind(mCmdBuffer);
-		mSkyboxIndexBuffer->Draw(mCmdBuffer);
+		const glm::mat4 viewProjection{ camera.Projection * camera.View };
+		const Pipeline* opaquePipeline{ mDepthPrePass ? mDepthEqualPipeline.get() : mPipeline.get() };
 
-		mGlobalDescriptorSet->SetUniform("Camera", &camera, surface->CurrentFrame());
-
-		mPipeline->Bind(mCmdBuffer);
-		mPipeline->BindDescriptorSet(mGlobalDescriptorSet.get(), surface->CurrentFrame(), mCmdBuffer);
+		//double sided meshes use their own permutations, compiled in the background the first time one is drawn. Until
+		//both passes have theirs the default pair is used, so the pre-pass and the shading pass keep culling alike
+		mPipelines.Update();
+		pipelineHandle doubleSidedDepth{ 0 };
+		pipelineHandle doubleSidedOpaque{ 0 };
+		b8 doubleSidedRequested{ false };
+		b8 doubleSidedReady{ false };
 
+		mQueue.Clear();
 		mScene->ExecuteSystem([&](const Entity& e)
 		{
 			if (e.HasComponents<Component::Transform, Component::Mesh>())
 			{
 				const auto [transform, mesh] = e.GetComponents<Component::Transform, Component::Mesh>();
 
-				mesh.Model->SetTransform(transform.Model(), surface->CurrentFrame());
+				const glm::vec4 clip{ viewProjection * glm::vec4{ transform.Position, 1.0f } };
+				const f32 depth{ clip.w > 0.0f ? clip.z / clip.w : 1.0f };
+
+				if (mesh.DoubleSided && !doubleSidedRequested)
+				{
+					if (mDepthPrePass)
+						doubleSidedDepth = mPipelines.Request(SceneSettings(true, false, true));
+					doubleSidedOpaque = mPipelines.Request(SceneSettings(false, mDepthPrePass, true));
+					doubleSidedReady = mPipelines.Ready(doubleSidedOpaque) && (!mDepthPrePass || mPipelines.Ready(doubleSidedDepth));
+					doubleSidedRequested = true;
+				}
 
-				mesh.Model->Draw(mPipeline, mCmdBuffer, surface->CurrentFrame());
+				const b8 doubleSided{ mesh.DoubleSided && doubleSidedReady };
+
+				//the pass is the most significant part of the sort key, so every depth only draw precedes the shaded ones
+				if (mDepthPrePass)
+					mQueue.Submit(sDepthPass, doubleSided ? mPipelines.Get(doubleSidedDepth) : mDepthPipeline.get(), mesh.Model.get(), transform.Model(), depth);
+				mQueue.Submit(sOpaquePass, doubleSided ? mPipelines.Get(doubleSidedOpaque) : opaquePipeline, mesh.Model.get(), transform.Model(), depth);
 			}
 		});
 
+		mStats.PendingPipelines = mPipelines.Pending();
+
+		mQueue.Sort();
+
+		mCmdBuffer->BeginStatistics(surface->CurrentFrame());
+
+		//a subpass is either recorded inline or entirely from secondary buffers, so the choice is made before it begins
+		if (mQueue.PrefersParallel())
+		{
+			mRenderPass->Begin(mCmdBuffer, true);
+
+			mSkyboxCmdBuffer->Begin(surface->CurrentFrame(), mRenderPass);
+			DrawSkybox(surface->CurrentFrame(), mSkyboxCmdBuffer);
+			DrawParticles(surface->CurrentFrame(), mSkyboxCmdBuffer);
+			mSkyboxCmdBuffer->End(surface->CurrentFrame());
+
+			const auto& recorded{ mQueue.RecordParallel(mRenderPass, globalSet.get(), surface->CurrentFrame()) };
+			std::vector<std::shared_ptr<CommandBuffer>> secondaries{ recorded.begin(), recorded.end() };
+			secondaries.insert(mSkyboxLast ? secondaries.end() : secondaries.begin(), mSkyboxCmdBuffer);
+
+			mCmdBuffer->Execute(surface->CurrentFrame(), secondaries);
+		}
+		else
+		{
+			mRenderPass->Begin(mCmdBuffer);
+
+			if (!mSkyboxLast)
+			{
+				DrawSkybox(surface->CurrentFrame(), mCmdBuffer);
+				DrawParticles(surface->CurrentFrame(), mCmdBuffer);
+			}
+
+			mQueue.Record(globalSet.get(), surface->CurrentFrame(), mCmdBuffer);
+
+			if (mSkyboxLast)
+			{
+				DrawSkybox(surface->CurrentFrame(), mCmdBuffer);
+				DrawParticles(surface->CurrentFrame(), mCmdBuffer);
+			}
+		}
+
+		mStats.DrawCount = mQueue.Size();
+		mStats.StateChanges = mQueue.StateChanges();
+		mStats.RecordThreads = mQueue.RecordThreads();
+		mStats.RecordTime = std::chrono::duration<f32, std::chrono::milliseconds::period>(std::chrono::high_resolution_clock::now() - recordStart).count();
+
 		mRenderPass->End(mCmdBuffer);
+
+		mCmdBuffer->EndStatistics(surface->CurrentFrame());
+		mRenderedPixels[surface->CurrentFrame()] = static_cast<u64>(mRenderPass->RenderWidth()) * mRenderPass->RenderHeight();
+	}
+
+	/**
+	 * \brief Hands the results of the compute queue back to it and submits the scene command buffer once the compute
+	 * work of the frame has completed.
+	 */
+	void SceneRenderer::EndFrame(const std::shared_ptr<Surface>& surface)
+	{
+		const u32 currentFrame{ surface->CurrentFrame() };
+
+		for (const auto& buffer : mSharedBuffers[currentFrame])
+			mCmdBuffer->Release(buffer, CommandBufferUsage::Compute);
+
+		mCmdBuffer->EndTiming(currentFrame);
+		mCmdBuffer->End(currentFrame);
+
+		const std::vector<QueueDependency> dependencies{ { mComputeCmdBuffer, mComputeCmdBuffer->TimelineValue() } };
+		mCmdBuffer->Submit(currentFrame, dependencies, surface);
+		mGraphicsValues[currentFrame] = mCmdBuffer->TimelineValue();
+	}
+
+	/**
+	 * \brief Picks the render scale of the frame from the GPU time of the last completed use of the frame slot, measured
+	 * with BeginTiming and EndTiming around the whole frame on the scene command buffer.
+	 */
+	void SceneRenderer::UpdateResolution(const u32 currentFrame)
+	{
+		if (f64 begin, end; mCmdBuffer->Timing(currentFrame, begin, end))
+			mRenderPass->SetRenderScale(mResolution.Update(static_cast<f32>(end - begin)));
+		else
+			mRenderPass->SetRenderScale(mResolution.Scale());
+
+		mStats.RenderScale = mRenderPass->RenderScale();
+		mStats.GpuTime = mResolution.FrameTime();
+	}
+
+	/**
+	 * \brief Records the light culling and the particle simulation into their own graph and submits it to the compute
+	 * queue. Everything the graphics queue reads from them belongs to the frame slot, so the submission never waits for
+	 * the graphics of the previous frame, only for the one that last used the slot, which has already completed.
+	 */
+	void SceneRenderer::SubmitCompute(const u32 currentFrame)
+	{
+		mComputeCmdBuffer->Begin(currentFrame);
+		ReadComputeTiming(currentFrame);
+		mComputeCmdBuffer->BeginTiming(currentFrame);
+
+		//released by the last graphics submission of the slot
+		for (const auto& buffer : mSharedBuffers[currentFrame])
+			mComputeCmdBuffer->Acquire(buffer, CommandBufferUsage::Graphics);
+
+		mComputeGraph->Reset();
+
+		mLighting->AddPasses(*mComputeGraph, mLightCullingPipeline.get(), mCamera->View(), mCamera->Projection(), mCamera->Near(), mCamera->Far(), mRenderPass->RenderWidth(), mRenderPass->RenderHeight(), currentFrame);
+		mStats.Lights = mLighting->LightCount();
+
+		mParticleSystems.clear();
+		mScene->ExecuteSystem([&](const Entity& e)
+		{
+			if (e.HasComponents<Component::Transform, Component::ParticleSystem>())
+			{
+				const auto [transform, particles] = e.GetComponents<Component::Transform, Component::ParticleSystem>();
+
+				particles.System->AddPasses(*mComputeGraph, mParticleSimulationPipeline.get(), particles.Emitter, transform.Position, mDeltaTime, currentFrame);
+				mParticleSystems.push_back(particles.System.get());
+			}
+		});
+
+		mStats.ParticleSystems = static_cast<u32>(mParticleSystems.size());
+
+		mComputeGraph->Compile(currentFrame);
+		mComputeGraph->Execute(mComputeCmdBuffer);
+
+		//the buffers of a particle system removed since may only be referenced by the acquires above now, the list is
+		//kept until the slot comes around again and the one it replaces belongs to a completed submission
+		auto& shared{ mSharedBuffers[currentFrame] };
+		std::swap(shared, mAcquiredBuffers[currentFrame]);
+		shared.clear();
+		mLighting->GetSharedBuffers(currentFrame, shared);
+		for (const auto* system : mParticleSystems)
+			system->GetSharedBuffers(currentFrame, shared);
+
+		for (const auto& buffer : shared)
+			mComputeCmdBuffer->Release(buffer, CommandBufferUsage::Graphics);
+
+		mComputeCmdBuffer->EndTiming(currentFrame);
+		mComputeCmdBuffer->End(currentFrame);
+
+		//orders the acquires above after the releases of the graphics submission
+		std::vector<QueueDependency> dependencies{};
+		if (mGraphicsValues[currentFrame])
+			dependencies.push_back({ mCmdBuffer, mGraphicsValues[currentFrame] });
+		mComputeCmdBuffer->Submit(currentFrame, dependencies);
+
+		for (const auto& buffer : shared)
+			mCmdBuffer->Acquire(buffer, CommandBufferUsage::Compute);
+	}
+
+	/**
+	 * \brief Reads how long the compute work of the last completed use of the frame slot took and how much of it ran
+	 * alongside the graphics of the frame before, whose timestamps the previous slot holds. The timestamps of both
+	 * queues are compared directly, see CommandBuffer::Timing.
+	 */
+	void SceneRenderer::ReadComputeTiming(const u32 currentFrame)
+	{
+		f64 computeBegin, computeEnd;
+		if (!mComputeCmdBuffer->Timing(currentFrame, computeBegin, computeEnd))
+			return;
+
+		mStats.ComputeTime = static_cast<f32>(computeEnd - computeBegin);
+		mStats.ComputeOverlap = 0.0f;
+
+		//a single frame in flight never overlaps, the cpu waits for every frame before recording the next one
+		const u32 previousFrame{ (currentFrame + mFrameCount - 1) % mFrameCount };
+		if (f64 graphicsBegin, graphicsEnd; previousFrame != currentFrame && mCmdBuffer->Timing(previousFrame, graphicsBegin, graphicsEnd))
+			mStats.ComputeOverlap = static_cast<f32>(std::max(0.0, std::min(computeEnd, graphicsEnd) - std::max(computeBegin, graphicsBegin)));
+	}
+
+	/**
+	 * \brief Reads the fragment shader invocations counted the last time the frame slot was drawn.
+	 */
+	void SceneRenderer::ReadFragmentStatistics(const u32 currentFrame)
+	{
+		u64 invocations{ 0 };
+		if (!mCmdBuffer->FragmentInvocations(currentFrame, invocations) || !mRenderedPixels[currentFrame])
+			return;
+
+		mStats.FragmentInvocations = invocations;
+		mStats.Overdraw = static_cast<f32>(static_cast<f64>(invocations) / static_cast<f64>(mRenderedPixels[currentFrame]));
+	}
+
+	void SceneRenderer::DrawSkybox(const u32 currentFrame, const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		mSkyboxPipeline->Bind(cmd);
+		mSkyboxPipeline->BindDescriptorSet(mSkyboxDescriptorSet.get(), currentFrame, cmd);
+
+		GeometryPool::Get()->Bind(cmd);
+		GeometryPool::Get()->Draw(mSkyboxGeometry, cmd);
+	}
+
+	void SceneRenderer::DrawParticles(const u32 currentFrame, const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		if (mParticleSystems.empty())
+			return;
+
+		mParticlePipeline->Bind(cmd);
+		mParticlePipeline->BindDescriptorSet(mParticleDescriptorSet.get(), currentFrame, cmd);
+
+		for (const auto* system : mParticleSystems)
+			system->Draw(mParticlePipeline.get(), currentFrame, cmd);
 	}
 }
@@ -1,7 +1,14 @@
 #pragma once
 #include <memory>
 
+#include "ClusteredLighting.h"
+#include "DynamicResolution.h"
 #include "Mesh.h"
+#include "ParticleSystem.h"
+#include "PipelineLibrary.h"
+#include "RenderGraph.h"
+#include "RenderQueue.h"
+#include "ShadowMaps.h"
 #include "Core/Scene.h"
 #include "Rhi/Pipeline.h"
 #include "Rhi/RenderPass.h"
@@ -10,36 +17,118 @@
 
 namespace SnowEngine
 {
+	struct RenderStats
+	{
+		u32 DrawCount{ 0 };
+		u32 StateChanges{ 0 };
+		f32 RecordTime{ 0.0f }; //milliseconds spent recording scene draws
+		u32 RecordThreads{ 1 };
+		u32 ParticleSystems{ 0 };
+		u32 Lights{ 0 };
+		u32 StaticShadowCascades{ 0 }; //cached shadow cascades rendered again this frame
+		f32 RenderScale{ 1.0f };
+		f32 GpuTime{ 0.0f }; //milliseconds, smoothed, of the frames the render scale was picked from
+		u64 FragmentInvocations{ 0 }; //in the scene pass of the last completed use of the frame slot, zero if unsupported
+		f32 Overdraw{ 0.0f }; //fragment invocations per rendered pixel
+		u32 PendingPipelines{ 0 }; //permutations compiling in the background, their draws use a fallback
+		f32 ComputeTime{ 0.0f }; //milliseconds on the compute queue in the last completed use of the frame slot
+		f32 ComputeOverlap{ 0.0f }; //milliseconds of it that ran alongside the graphics of the previous frame
+	};
+
 	class SceneRenderer
 	{
 	public:
 		SceneRenderer(const std::shared_ptr<Surface>& surface);
+		~SceneRenderer();
+
+		void CreatePipelines();
 
 		void SetCamera(const std::shared_ptr<CameraController>& camera);
 
 		const std::shared_ptr<RenderPass>& GetRenderPass() const;
 		const std::shared_ptr<CommandBuffer>& GetCommandBuffer() const;
+		const RenderStats& Stats() const;
+		DynamicResolution& Resolution();
+		b8 DepthPrePass() const;
+		b8 SkyboxLast() const;
+		/** \brief Lays down the depth of the opaque meshes before shading them, so each covered pixel is shaded once. */
+		void SetDepthPrePass(b8 enabled);
+		/** \brief Draws the skybox after the opaque meshes, at the far plane, so only the uncovered pixels shade it. */
+		void SetSkyboxLast(b8 enabled);
 		void SetScene(const std::shared_ptr<Scene>& scene);
 
 		void Update(f32 dt);
-		void Draw(const std::shared_ptr<Surface>& surface) const;
+		void BeginFrame(u32 currentFrame);
+		void AddShadowPasses(RenderGraph& graph, u32 currentFrame);
+		void DeclareSceneReads(RenderGraphBuilder& builder) const;
+		void Draw(const std::shared_ptr<Surface>& surface);
+		void EndFrame(const std::shared_ptr<Surface>& surface);
 
 	private:
+		/** \brief Settings of a scene pipeline, depth only or shading, the latter testing for equal depth after a pre-pass. */
+		PipelineSettings SceneSettings(b8 depthOnly, b8 prePass, b8 doubleSided) const;
+		void UpdateResolution(u32 currentFrame);
+		void SubmitCompute(u32 currentFrame);
+		void ReadComputeTiming(u32 currentFrame);
+		void DrawSkybox(u32 currentFrame, const std::shared_ptr<CommandBuffer>& cmd) const;
+		void DrawParticles(u32 currentFrame, const std::shared_ptr<CommandBuffer>& cmd) const;
+		void ReadFragmentStatistics(u32 currentFrame);
+
 		std::shared_ptr<RenderPass> mRenderPass{ nullptr };
 		std::shared_ptr<Shader> mShader{ nullptr };
 		std::shared_ptr<Pipeline> mPipeline{ nullptr };
-		std::shared_ptr<DescriptorSet> mGlobalDescriptorSet{ nullptr };
+		std::shared_ptr<Pipeline> mDepthPipeline{ nullptr }; //depth only, the pre-pass
+		std::shared_ptr<Pipeline> mDepthEqualPipeline{ nullptr }; //shades what the pre-pass left visible
+		PipelineLibrary mPipelines; //the permutations of the scene pipelines, the ones above included
+		std::vector<std::shared_ptr<DescriptorSet>> mGlobalDescriptorSets; //of every frame slot, bound to the light buffers of the slot
+		bindingHandle mGlobalCamera{ DescriptorSet::sNoBinding };
 		std::shared_ptr<CommandBuffer> mCmdBuffer{ nullptr };
+		u32 mFrameCount;
+		b8 mDepthPrePass{ true };
+		b8 mSkyboxLast{ true };
+		std::vector<u64> mRenderedPixels; //of every frame slot, to turn the counted invocations into overdraw
 
 		std::shared_ptr<Shader> mSkyboxShader{ nullptr };
 		std::shared_ptr<Pipeline> mSkyboxPipeline{ nullptr };
 		std::shared_ptr<Image> mSkyboxImage{ nullptr };
 		std::shared_ptr<DescriptorSet> mSkyboxDescriptorSet{ nullptr };
-		std::shared_ptr<VertexBuffer> mSkyboxVertexBuffer{ nullptr };
-		std::shared_ptr<IndexBuffer> mSkyboxIndexBuffer{ nullptr };
+		bindingHandle mSkyboxCamera{ DescriptorSet::sNoBinding };
+		std::shared_ptr<CommandBuffer> mSkyboxCmdBuffer{ nullptr };
+		GeometryRange mSkyboxGeometry{};
+
+		std::shared_ptr<Shader> mParticleShader{ nullptr };
+		std::shared_ptr<Pipeline> mParticlePipeline{ nullptr };
+		std::shared_ptr<DescriptorSet> mParticleDescriptorSet{ nullptr };
+		bindingHandle mParticleCamera{ DescriptorSet::sNoBinding };
+		std::shared_ptr<Shader> mParticleSimulationShader{ nullptr };
+		std::shared_ptr<ComputePipeline> mParticleSimulationPipeline{ nullptr };
+		std::vector<ParticleSystem*> mParticleSystems; //systems simulated in the current frame
+		f32 mDeltaTime{ 0.0f };
+
+		//light culling and particle simulation, submitted to the compute queue ahead of the graphics of the frame
+		std::shared_ptr<CommandBuffer> mComputeCmdBuffer{ nullptr };
+		std::shared_ptr<RenderGraph> mComputeGraph{ nullptr };
+		std::vector<std::vector<std::shared_ptr<StorageBuffer>>> mSharedBuffers; //of every frame slot, handed from the compute queue to the graphics queue and back
+		std::vector<std::vector<std::shared_ptr<StorageBuffer>>> mAcquiredBuffers; //of every frame slot, alive until its compute submission completes
+		std::vector<u64> mGraphicsValues; //of every frame slot, timeline value of its last graphics submission
+
+		std::shared_ptr<Shader> mLightCullingShader{ nullptr };
+		std::shared_ptr<ComputePipeline> mLightCullingPipeline{ nullptr };
+		std::unique_ptr<ClusteredLighting> mLighting{ nullptr };
+
+		std::shared_ptr<Shader> mShadowShader{ nullptr };
+		std::shared_ptr<Pipeline> mShadowPipeline{ nullptr };
+		std::unique_ptr<CascadedShadowMaps> mShadows{ nullptr };
+		std::vector<ShadowCaster> mStaticCasters;
+		std::vector<ShadowCaster> mDynamicCasters;
+
+		DynamicResolution mResolution{};
 
 		std::shared_ptr<CameraController> mCamera{};
 
 		std::shared_ptr<Scene> mScene;
+
+		RenderQueue mQueue;
+		RenderStats mStats{};
 	};
 }
@@ -0,0 +1,246 @@
+#include "ShadowMaps.h"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Core/Hash.h"
+#include "Rhi/GeometryPool.h"
+
+namespace SnowEngine
+{
+	CascadedShadowMaps::CascadedShadowMaps(const u32 tileSize)
+		: mTileSize{ tileSize }
+	{
+		//2x2 cascades per atlas
+		mStaticAtlas = RenderPass::CreateDepth(2 * mTileSize, 2 * mTileSize);
+		mDynamicAtlas = RenderPass::CreateDepth(2 * mTileSize, 2 * mTileSize);
+
+		mConstants.Atlas = { mTileSize, 0, 0, 0 };
+		SetLight(mDirection, glm::vec3{ 0.0f });
+		Invalidate();
+	}
+
+	const std::shared_ptr<RenderPass>& CascadedShadowMaps::GetRenderPass() const { return mStaticAtlas; }
+
+	u32 CascadedShadowMaps::RenderedStaticCascades() const { return mRenderedStaticCascades; }
+
+	/**
+	 * \brief The static atlas keeps the direction it was rendered with until the light has turned far enough from it,
+	 * compared against that direction rather than the previous frame so a slowly turning light is caught as well.
+	 */
+	void CascadedShadowMaps::SetLight(const glm::vec3& direction, const glm::vec3& radiance)
+	{
+		mDirection = glm::normalize(direction);
+		const glm::vec3 up{ std::abs(mDirection.y) > 0.99f ? glm::vec3{ 0.0f, 0.0f, 1.0f } : glm::vec3{ 0.0f, 1.0f, 0.0f } };
+		mLightRotation = glm::lookAt(glm::vec3{ 0.0f }, mDirection, up);
+
+		if (glm::dot(mDirection, mStaticDirection) < 0.9999f)
+			Invalidate();
+
+		mConstants.Direction = glm::vec4{ mDirection, 0.0f };
+		mConstants.Radiance = glm::vec4{ radiance, 0.0f };
+	}
+
+	void CascadedShadowMaps::Invalidate()
+	{
+		mStaticDirection = mDirection;
+		mStaticRotation = mLightRotation;
+
+		for (auto& cascade : mCascades)
+			cascade.StaticRadius = 0.0f;
+	}
+
+	void CascadedShadowMaps::AddPasses(RenderGraph& graph, const Pipeline* pipeline, const glm::mat4& view, const glm::mat4& projection, const f32 nearPlane, const f32 farPlane, const std::vector<ShadowCaster>& staticCasters, const std::vector<ShadowCaster>& dynamicCasters)
+	{
+		mRenderedStaticCascades = 0;
+		mActive = mConstants.Radiance != glm::vec4{ 0.0f };
+		if (!mActive)
+			return;
+
+		if (const u64 signature{ Signature(staticCasters) }; signature != mStaticSignature)
+		{
+			mStaticSignature = signature;
+			Invalidate();
+		}
+
+		FitCascades(view, projection, nearPlane, farPlane);
+
+		mResources.StaticAtlas = graph.ImportImage("StaticShadowAtlas", mStaticAtlas->DepthImage().get());
+		mResources.DynamicAtlas = graph.ImportImage("DynamicShadowAtlas", mDynamicAtlas->DepthImage().get());
+
+		std::vector<std::pair<u32, glm::mat4>> dirty{};
+		std::array<glm::mat4, sCascadeCount> dynamicMatrices{};
+		for (u32 i{ 0 }; i < sCascadeCount; i++)
+		{
+			if (mCascades[i].Dirty)
+				dirty.emplace_back(i, mCascades[i].StaticViewProjection);
+
+			mCascades[i].Dirty = false;
+			dynamicMatrices[i] = mCascades[i].DynamicViewProjection;
+		}
+		mRenderedStaticCascades = static_cast<u32>(dirty.size());
+
+		const auto& resources{ mResources };
+		if (!dirty.empty())
+		{
+			graph.AddPass("ShadowStatic", [&](RenderGraphBuilder& builder)
+			{
+				builder.Write(resources.StaticAtlas, ResourceUsage::DepthAttachment);
+			},
+			[this, pipeline, dirty, &staticCasters](const std::shared_ptr<CommandBuffer>& cmd)
+			{
+				for (const auto& [cascade, viewProjection] : dirty)
+					RecordCascade(pipeline, *mStaticAtlas, cascade, viewProjection, staticCasters, cmd);
+			});
+		}
+
+		//cleared even without dynamic casters, the scene samples it regardless
+		graph.AddPass("ShadowDynamic", [&](RenderGraphBuilder& builder)
+		{
+			builder.Write(resources.DynamicAtlas, ResourceUsage::DepthAttachment);
+		},
+		[this, pipeline, dynamicMatrices, &dynamicCasters](const std::shared_ptr<CommandBuffer>& cmd)
+		{
+			for (u32 i{ 0 }; i < sCascadeCount; i++)
+				RecordCascade(pipeline, *mDynamicAtlas, i, dynamicMatrices[i], dynamicCasters, cmd);
+		});
+	}
+
+	void CascadedShadowMaps::DeclareReads(RenderGraphBuilder& builder) const
+	{
+		if (!mActive)
+			return;
+
+		builder.Read(mResources.StaticAtlas, ResourceUsage::ShaderRead);
+		builder.Read(mResources.DynamicAtlas, ResourceUsage::ShaderRead);
+	}
+
+	void CascadedShadowMaps::SetResources(DescriptorSet& set) const
+	{
+		//the atlases are read with texelFetch, the sampler only has to be valid
+		constexpr SamplerDesc sampler{ SamplerFilter::Nearest, SamplerFilter::Nearest, SamplerAddressMode::ClampToEdge, SamplerAddressMode::ClampToEdge, SamplerAddressMode::ClampToEdge, 1.0f, 0.0f, 0.0f };
+
+		set.SetImage("staticShadows", mStaticAtlas->DepthImage(), sampler);
+		set.SetImage("dynamicShadows", mDynamicAtlas->DepthImage(), sampler);
+	}
+
+	void CascadedShadowMaps::SetUniforms(const DescriptorSet& set, const u32 currentFrame) const
+	{
+		set.SetUniform("DirectionalLight", &mConstants, currentFrame);
+	}
+
+	/**
+	 * \brief Splits the view up to the shadow distance and fits a sphere around every slice, the sphere keeps the
+	 * cascade size constant while the camera turns. Static cascades are refitted only when the sphere leaves them.
+	 */
+	void CascadedShadowMaps::FitCascades(const glm::mat4& view, const glm::mat4& projection, const f32 nearPlane, const f32 farPlane)
+	{
+		const f32 shadowFar{ std::min(farPlane, sShadowDistance) };
+		const f32 tanX{ 1.0f / projection[0][0] };
+		const f32 tanY{ 1.0f / std::abs(projection[1][1]) };
+		const glm::mat4 inverseView{ glm::inverse(view) };
+
+		f32 splitNear{ nearPlane };
+		for (u32 i{ 0 }; i < sCascadeCount; i++)
+		{
+			const f32 t{ static_cast<f32>(i + 1) / sCascadeCount };
+			const f32 splitFar{ sSplitLambda * nearPlane * std::pow(shadowFar / nearPlane, t) + (1.0f - sSplitLambda) * (nearPlane + (shadowFar - nearPlane) * t) };
+
+			std::array<glm::vec3, 8> corners{};
+			glm::vec3 center{ 0.0f };
+			for (u32 c{ 0 }; c < 8; c++)
+			{
+				const f32 depth{ c < 4 ? splitNear : splitFar };
+				const f32 x{ c & 1 ? tanX : -tanX };
+				const f32 y{ c & 2 ? tanY : -tanY };
+
+				corners[c] = glm::vec3{ inverseView * glm::vec4{ x * depth, y * depth, -depth, 1.0f } };
+				center += corners[c] / 8.0f;
+			}
+
+			f32 radius{ 0.0f };
+			for (const auto& corner : corners)
+				radius = std::max(radius, glm::length(corner - center));
+			radius = std::ceil(radius * 16.0f) / 16.0f;
+
+			const glm::vec3 lightCenter{ mLightRotation * glm::vec4{ center, 1.0f } };
+			auto& cascade{ mCascades[i] };
+
+			//snapped to whole texels so moving the camera does not make the edges shimmer
+			const f32 texel{ 2.0f * radius / mTileSize };
+			const glm::vec3 dynamicCenter{ glm::floor(glm::vec2{ lightCenter } / texel) * texel, lightCenter.z };
+			cascade.DynamicViewProjection = LightProjection(mLightRotation, dynamicCenter, radius);
+
+			//the static cascades all live in the space of the direction the static atlas was rendered with
+			const glm::vec3 staticLightCenter{ mStaticRotation * glm::vec4{ center, 1.0f } };
+			const f32 staticRadius{ radius * (1.0f + sStaticMargin) };
+			const glm::vec3 offset{ glm::abs(staticLightCenter - cascade.StaticCenter) };
+			if (cascade.StaticRadius != staticRadius || std::max({ offset.x, offset.y, offset.z }) + radius > staticRadius)
+			{
+				const f32 staticTexel{ 2.0f * staticRadius / mTileSize };
+				cascade.StaticCenter = glm::vec3{ glm::floor(glm::vec2{ staticLightCenter } / staticTexel) * staticTexel, staticLightCenter.z };
+				cascade.StaticRadius = staticRadius;
+				cascade.StaticViewProjection = LightProjection(mStaticRotation, cascade.StaticCenter, staticRadius);
+				cascade.Dirty = true;
+			}
+
+			mConstants.StaticViewProjection[i] = cascade.StaticViewProjection;
+			mConstants.DynamicViewProjection[i] = cascade.DynamicViewProjection;
+			mConstants.Splits[i] = splitFar;
+			mConstants.TexelSizes[i] = 2.0f * cascade.StaticRadius / mTileSize;
+
+			splitNear = splitFar;
+		}
+	}
+
+	/**
+	 * \brief Orthographic projection around a light space sphere, deepened towards the light to catch casters outside it.
+	 */
+	glm::mat4 CascadedShadowMaps::LightProjection(const glm::mat4& rotation, const glm::vec3& center, const f32 radius)
+	{
+		return glm::orthoRH_ZO(center.x - radius, center.x + radius, center.y - radius, center.y + radius, -center.z - radius - sCasterDistance, -center.z + radius) * rotation;
+	}
+
+	void CascadedShadowMaps::RecordCascade(const Pipeline* pipeline, RenderPass& atlas, const u32 cascade, const glm::mat4& viewProjection, const std::vector<ShadowCaster>& casters, const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		struct CasterConstants
+		{
+			glm::mat4 ViewProjection;
+			glm::mat4 Model;
+		};
+
+		//clears the tile of the cascade only
+		atlas.BeginRegion(cmd, (cascade % 2) * mTileSize, (cascade / 2) * mTileSize, mTileSize, mTileSize);
+
+		if (!casters.empty())
+		{
+			pipeline->Bind(cmd);
+			GeometryPool::Get()->Bind(cmd);
+
+			for (const auto& [mesh, model] : casters)
+			{
+				const CasterConstants constants{ viewProjection, model };
+				pipeline->PushConstants(&constants, sizeof(CasterConstants), cmd);
+				GeometryPool::Get()->Draw(mesh->GetGeometry(), cmd);
+			}
+		}
+
+		atlas.End(cmd);
+	}
+
+	/**
+	 * \brief FNV-1a over the meshes and transforms of the casters.
+	 */
+	u64 CascadedShadowMaps::Signature(const std::vector<ShadowCaster>& casters)
+	{
+		Hasher hash;
+		for (const auto& caster : casters)
+		{
+			hash.Mix(caster.Mesh);
+			hash.Mix(caster.Model);
+		}
+
+		return hash.Get();
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Mesh.h"
+#include "RenderGraph.h"
+#include "Core/Types.h"
+#include "Rhi/DescriptorSet.h"
+#include "Rhi/Pipeline.h"
+#include "Rhi/RenderPass.h"
+
+namespace SnowEngine
+{
+	struct ShadowCaster
+	{
+		const SnowEngine::Mesh* Mesh;
+		glm::mat4 Model;
+	};
+
+	/**
+	 * \brief Cascaded shadow maps of a directional light split in two atlases. Static casters are rendered into a cached
+	 * atlas whose cascades are fitted with a margin and snapped to their texels, a cascade is only rendered again once the
+	 * view moves past the margin, the light turns or the static casters change. Dynamic casters are rendered every frame
+	 * into a second atlas with tightly fitted cascades and the two are combined when sampled.
+	 */
+	class CascadedShadowMaps
+	{
+	public:
+		CascadedShadowMaps(u32 tileSize = 1024);
+
+		CascadedShadowMaps(const CascadedShadowMaps&) = delete;
+		CascadedShadowMaps& operator=(const CascadedShadowMaps&) = delete;
+
+		/** \brief Render pass the caster pipeline is created with, both atlases share its layout. */
+		const std::shared_ptr<RenderPass>& GetRenderPass() const;
+		/** \brief Static cascades rendered by the last AddPasses call. */
+		u32 RenderedStaticCascades() const;
+
+		/** \brief Sets the light for the next frame, a zero radiance disables it and its shadows. */
+		void SetLight(const glm::vec3& direction, const glm::vec3& radiance);
+		/** \brief Forces every static cascade to be rendered again. */
+		void Invalidate();
+
+		/**
+		 * \brief Fits the cascades to the view and adds the shadow passes, they must precede the scene pass.
+		 * The casters are read when the graph executes and must stay alive until then.
+		 */
+		void AddPasses(RenderGraph& graph, const Pipeline* pipeline, const glm::mat4& view, const glm::mat4& projection, f32 nearPlane, f32 farPlane, const std::vector<ShadowCaster>& staticCasters, const std::vector<ShadowCaster>& dynamicCasters);
+		void DeclareReads(RenderGraphBuilder& builder) const;
+
+		void SetResources(DescriptorSet& set) const;
+		void SetUniforms(const DescriptorSet& set, u32 currentFrame) const;
+
+		static constexpr u32 sCascadeCount{ 4 };
+
+	private:
+		struct Cascade
+		{
+			glm::mat4 StaticViewProjection{ 1.0f };
+			glm::mat4 DynamicViewProjection{ 1.0f };
+			glm::vec3 StaticCenter{ 0.0f }; //static light space, snapped to the texels of the static tile
+			f32 StaticRadius{ 0.0f };
+			b8 Dirty{ true };
+		};
+
+		struct LightConstants
+		{
+			glm::mat4 StaticViewProjection[sCascadeCount];
+			glm::mat4 DynamicViewProjection[sCascadeCount];
+			glm::vec4 Splits; //view depth where every cascade ends
+			glm::vec4 Direction;
+			glm::vec4 Radiance;
+			glm::vec4 TexelSizes; //world size of a static texel in every cascade, scales the normal offset
+			glm::uvec4 Atlas; //tile size
+		};
+
+		struct GraphResources
+		{
+			RenderGraphResource StaticAtlas;
+			RenderGraphResource DynamicAtlas;
+		};
+
+		void FitCascades(const glm::mat4& view, const glm::mat4& projection, f32 nearPlane, f32 farPlane);
+		static glm::mat4 LightProjection(const glm::mat4& rotation, const glm::vec3& center, f32 radius);
+		void RecordCascade(const Pipeline* pipeline, RenderPass& atlas, u32 cascade, const glm::mat4& viewProjection, const std::vector<ShadowCaster>& casters, const std::shared_ptr<CommandBuffer>& cmd) const;
+		static u64 Signature(const std::vector<ShadowCaster>& casters);
+
+		std::shared_ptr<RenderPass> mStaticAtlas{ nullptr };
+		std::shared_ptr<RenderPass> mDynamicAtlas{ nullptr };
+
+		std::array<Cascade, sCascadeCount> mCascades{};
+		LightConstants mConstants{};
+		GraphResources mResources{};
+		glm::mat4 mLightRotation{ 1.0f };
+		glm::mat4 mStaticRotation{ 1.0f }; //of the direction the static atlas was rendered with
+		glm::vec3 mDirection{ 0.0f, -1.0f, 0.0f };
+		glm::vec3 mStaticDirection{ 0.0f, -1.0f, 0.0f };
+		u64 mStaticSignature{ 0 };
+		u32 mTileSize;
+		u32 mRenderedStaticCascades{ 0 };
+		b8 mActive{ false }; //the passes were added to the current graph
+
+		static constexpr f32 sShadowDistance{ 100.0f };
+		static constexpr f32 sSplitLambda{ 0.75f }; //blend between logarithmic and uniform splits
+		static constexpr f32 sStaticMargin{ 0.5f }; //extra radius of the static cascades, relative to the tight one
+		static constexpr f32 sCasterDistance{ 50.0f }; //how far behind a cascade towards the light casters are still caught
+	};
+}
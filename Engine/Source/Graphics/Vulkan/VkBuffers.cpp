@@ -3,6 +3,7 @@
 #include "VkCore.h"
 #include "VkSurface.h"
 #include "VkCommandBuffer.h"
+#include "Core/Logger.h"
 
 namespace SnowEngine
 {
@@ -14,10 +15,16 @@ namespace SnowEngine
 		createInfo.usage = usage;
 		createInfo.sharingMode = vk::SharingMode::eExclusive;
 
+		const b8 hostVisible{ memoryUsage == VMA_MEMORY_USAGE_CPU_ONLY || memoryUsage == VMA_MEMORY_USAGE_CPU_TO_GPU || memoryUsage == VMA_MEMORY_USAGE_GPU_TO_CPU };
+
 		VmaAllocationCreateInfo allocInfo{};
 		allocInfo.usage = memoryUsage;
+		allocInfo.flags = hostVisible ? VMA_ALLOCATION_CREATE_MAPPED_BIT : 0;
+
+		VmaAllocationInfo allocationInfo{};
+		vmaCreateBuffer(VkCore::Get()->Allocator(), reinterpret_cast<VkBufferCreateInfo*>(&createInfo), &allocInfo, reinterpret_cast<::VkBuffer*>(&mBuffer), &mAllocation, &allocationInfo);
 
-		vmaCreateBuffer(VkCore::Get()->Allocator(), reinterpret_cast<VkBufferCreateInfo*>(&createInfo), &allocInfo, reinterpret_cast<::VkBuffer*>(&mBuffer), &mAllocation, nullptr);
+		mMapped = static_cast<u8*>(allocationInfo.pMappedData);
 	}
 
 	VkBuffer::~VkBuffer()
@@ -29,12 +36,41 @@ namespace SnowEngine
 
 	u32 VkBuffer::Size() const { return mSize; }
 
+	u8* VkBuffer::Mapped() const { return mMapped; }
+
 	void VkBuffer::InsertData(const void* data, const u32 size, const u32 offset) const
 	{
-		void* gpuMemory;
-		vmaMapMemory(VkCore::Get()->Allocator(), mAllocation, &gpuMemory);
-		memcpy(static_cast<u8*>(gpuMemory) + offset, data, size ? size : mSize);
-		vmaUnmapMemory(VkCore::Get()->Allocator(), mAllocation);
+		Write(data, size ? size : mSize - offset, offset);
+	}
+
+	/**
+	 * \brief Copies a sub-range into the persistently mapped memory and flushes it for non-coherent heaps.
+	 */
+	void VkBuffer::Write(const void* data, const u32 size, const u32 offset) const
+	{
+		if (!mMapped)
+		{
+			LOG_ERROR("Writing to a buffer that is not host visible");
+			return;
+		}
+
+		memcpy(mMapped + offset, data, size);
+		vmaFlushAllocation(VkCore::Get()->Allocator(), mAllocation, offset, size);
+	}
+
+	/**
+	 * \brief Copies a sub-range out of the persistently mapped memory, invalidating it first for non-coherent heaps.
+	 */
+	void VkBuffer::Read(void* data, const u32 size, const u32 offset) const
+	{
+		if (!mMapped)
+		{
+			LOG_ERROR("Reading from a buffer that is not host visible");
+			return;
+		}
+
+		vmaInvalidateAllocation(VkCore::Get()->Allocator(), mAllocation, offset, size);
+		memcpy(data, mMapped + offset, size);
 	}
 
 	void VkBuffer::CopyBuffer(const vk::Buffer src, const vk::Buffer dst, const vk::DeviceSize size)
@@ -87,7 +123,7 @@ namespace SnowEngine
 	std::vector<vk::VertexInputAttributeDescription> VkVertexBuffer::AttributeDescriptions()
 	{
 		std::vector<vk::VertexInputAttributeDescription> attributeDescriptions{};
-		attributeDescriptions.resize(3);
+		attributeDescriptions.resize(4);
 
 		attributeDescriptions[0].binding = 0;
 		attributeDescriptions[0].location = 0;
@@ -104,6 +140,11 @@ namespace SnowEngine
 		attributeDescriptions[2].format = vk::Format::eR32G32Sfloat;
 		attributeDescriptions[2].offset = offsetof(Vertex, Uv);
 
+		attributeDescriptions[3].binding = 0;
+		attributeDescriptions[3].location = 3;
+		attributeDescriptions[3].format = vk::Format::eR32G32B32Sfloat;
+		attributeDescriptions[3].offset = offsetof(Vertex, Normal);
+
 		return attributeDescriptions;
 	}
 
@@ -131,26 +172,13 @@ namespace SnowEngine
 		vkCmd->CurrentBuffer().drawIndexed(mCount, 1, 0, 0, 0);
 	}
 
-	VkUniformBuffer::VkUniformBuffer(const u32 size, const u32 frameCount)
-	{
-		for (u32 i{ 0 }; i < frameCount; i++)
-			mBuffers.push_back(std::make_unique<VkBuffer>(size, vk::BufferUsageFlagBits::eUniformBuffer, VMA_MEMORY_USAGE_CPU_TO_GPU));
-	}
-
-	const std::vector<std::unique_ptr<VkBuffer>>& VkUniformBuffer::Buffers() const { return mBuffers; }
-
-	void VkUniformBuffer::InsertData(const void* data, const u32 frameIndex) const
-	{
-		mBuffers.at(frameIndex)->InsertData(data);
-	}
-
-	VkStorageBuffer::VkStorageBuffer(const u32 size)
+	VkStorageBuffer::VkStorageBuffer(const u32 size, const b8 hostVisible)
 		: mSize{ size }
 	{
 		mBuffers = std::make_unique<VkBuffer>(
 			mSize,
-			vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eStorageBuffer,
-			VMA_MEMORY_USAGE_GPU_ONLY);
+			vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+			hostVisible ? VMA_MEMORY_USAGE_CPU_TO_GPU : VMA_MEMORY_USAGE_GPU_ONLY);
 	}
 
 	u32 VkStorageBuffer::Size() const { return mSize; }
@@ -173,4 +201,26 @@ namespace SnowEngine
 		const vk::DeviceSize deviceSize{ staging.Size() };
 		VkBuffer::CopyBuffer(staging.Buffer(), mBuffers->Buffer(), deviceSize);
 	}
+
+	void VkStorageBuffer::GetData(void* data) const
+	{
+		const VkBuffer staging{ mSize, vk::BufferUsageFlagBits::eTransferDst, VMA_MEMORY_USAGE_GPU_TO_CPU };
+
+		const vk::DeviceSize deviceSize{ mSize };
+		VkBuffer::CopyBuffer(mBuffers->Buffer(), staging.Buffer(), deviceSize);
+
+		staging.Read(data, mSize, 0);
+	}
+
+	void VkStorageBuffer::Write(const void* data, const u32 size, const u32 offset) const
+	{
+		mBuffers->Write(data, size, offset);
+	}
+
+	void VkStorageBuffer::DrawIndirect(const u32 offset, const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		const auto& vkCmd = std::static_pointer_cast<VkCommandBuffer>(cmd);
+
+		vkCmd->CurrentBuffer().drawIndirect(mBuffers->Buffer(), offset, 1, sizeof(vk::DrawIndirectCommand));
+	}
 }
@@ -16,14 +16,24 @@ namespace SnowEngine
 
 		vk::Buffer Buffer() const;
 		u32 Size() const;
+		u8* Mapped() const;
 
 		void InsertData(const void* data, u32 size = 0, u32 offset = 0) const;
+		void Write(const void* data, u32 size, u32 offset) const;
+		void Read(void* data, u32 size, u32 offset) const;
+
+		template<typename T>
+		void Write(const u32 offset, const T& value) const
+		{
+			Write(&value, sizeof(T), offset);
+		}
 
 		static void CopyBuffer(vk::Buffer src, vk::Buffer dst, vk::DeviceSize size);
 
 	protected:
 		vk::Buffer mBuffer;
 		VmaAllocation mAllocation;
+		u8* mMapped{ nullptr };
 		u32 mSize;
 	};
 
@@ -54,29 +64,20 @@ namespace SnowEngine
 		u32 mCount;
 	};
 
-	class VkUniformBuffer
-	{
-	public:
-		VkUniformBuffer(u32 size, u32 frameCount);
-
-		const std::vector<std::unique_ptr<VkBuffer>>& Buffers() const;
-
-		void InsertData(const void* data, u32 frameIndex) const;
-
-	private:
-		std::vector<std::unique_ptr<VkBuffer>> mBuffers;
-	};
-
 	class VkStorageBuffer : public StorageBuffer
 	{
 	public:
-		VkStorageBuffer(u32 size);
+		VkStorageBuffer(u32 size, b8 hostVisible);
 
 		u32 Size() const;
 		const std::unique_ptr<VkBuffer>& Buffers() const;
 
 		void SetData(const std::shared_ptr<StorageBuffer>& other) const override;
 		void SetData(const void* data) const override;
+		void GetData(void* data) const override;
+		void Write(const void* data, u32 size, u32 offset) const override;
+
+		void DrawIndirect(u32 offset, const std::shared_ptr<CommandBuffer>& cmd) const override;
 
 	private:
 		std::unique_ptr<VkBuffer> mBuffers;
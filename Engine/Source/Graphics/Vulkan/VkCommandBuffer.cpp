@@ -1,16 +1,25 @@
 #include "VkCommandBuffer.h"
 
+#include "VkBuffers.h"
+#include "VkRenderPass.h"
 #include "VkSurface.h"
 
 namespace SnowEngine
 {
-	VkCommandBuffer::VkCommandBuffer(const u32 frameCount, const CommandBufferUsage usage)
-		: mUsage{ usage }
+	VkCommandBuffer::VkCommandBuffer(const u32 frameCount, const CommandBufferUsage usage, const CommandBufferLevel level)
+		: mUsage{ usage }, mLevel{ level }
 	{
 		GetQueue();
 		CreatePool();
 		CreateBuffers(frameCount);
-		CreateSyncData(frameCount);
+
+		//secondary buffers are never submitted, the fence of the primary that executes them guards their reuse
+		if (mLevel == CommandBufferLevel::Primary)
+		{
+			CreateSyncData(frameCount);
+			CreateQueryPool(frameCount);
+			CreateStatisticsPool(frameCount);
+		}
 	}
 
 	vk::Semaphore VkCommandBuffer::FinishedSemaphore(const u32 frameIndex) const { return mFrames[frameIndex].Finished; }
@@ -19,18 +28,70 @@ namespace SnowEngine
 
 	vk::CommandBuffer VkCommandBuffer::CurrentBuffer() const { return mBuffers[VkSurface::BoundSurface()->CurrentFrame()]; }
 
+	CommandBufferUsage VkCommandBuffer::Usage() const { return mUsage; }
+
+	/**
+	 * \brief Blocks until the last submission of the given frame has completed, without resetting it.
+	 */
+	void VkCommandBuffer::Wait(const u32 frameIndex) const
+	{
+		vk::Result result = VkCore::Get()->Device().waitForFences(mFrames[frameIndex].InFlight, true, std::numeric_limits<u64>::max());
+	}
+
 	void VkCommandBuffer::Begin(const u32 currentFrame) const
 	{
-		vk::Result result = VkCore::Get()->Device().waitForFences(mFrames[currentFrame].InFlight, true, std::numeric_limits<u64>::max());
+		Wait(currentFrame);
 
 		//TODO: resource updates here
 
 		VkCore::Get()->Device().resetFences(mFrames[currentFrame].InFlight);
 
+		ReadTimestamps(currentFrame);
+		ReadStatistics(currentFrame);
+
+		vk::CommandBufferBeginInfo beginInfo{};
+
+		mBuffers[currentFrame].reset();
+		mBuffers[currentFrame].begin(beginInfo);
+	}
+
+	/**
+	 * \brief Begins a secondary buffer that continues the first subpass of the given render pass.
+	 * Viewport and scissor are not inherited from the primary buffer, so they are set here to the render area of the pass.
+	 */
+	void VkCommandBuffer::Begin(const u32 currentFrame, const std::shared_ptr<RenderPass>& renderPass) const
+	{
+		const auto& vkRenderPass = std::static_pointer_cast<VkRenderPass>(renderPass);
+
+		vk::CommandBufferInheritanceInfo inheritanceInfo{};
+		inheritanceInfo.renderPass = vkRenderPass->RenderPass();
+		inheritanceInfo.subpass = 0;
+		inheritanceInfo.framebuffer = vkRenderPass->CurrentFramebuffer();
+		if (VkCore::Get()->PipelineStatistics())
+			inheritanceInfo.pipelineStatistics = vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations;
+
 		vk::CommandBufferBeginInfo beginInfo{};
+		beginInfo.flags = vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+		beginInfo.pInheritanceInfo = &inheritanceInfo;
 
 		mBuffers[currentFrame].reset();
 		mBuffers[currentFrame].begin(beginInfo);
+
+		const u32 width{ vkRenderPass->RenderWidth() };
+		const u32 height{ vkRenderPass->RenderHeight() };
+		mBuffers[currentFrame].setViewport(0, { { 0.0f, 0.0f, static_cast<f32>(width), static_cast<f32>(height), 0.0f, 1.0f } });
+		mBuffers[currentFrame].setScissor(0, vk::Rect2D{ {{0, 0}, width, height } });
+	}
+
+	void VkCommandBuffer::Execute(const u32 currentFrame, const std::vector<std::shared_ptr<CommandBuffer>>& secondaries) const
+	{
+		std::vector<vk::CommandBuffer> buffers{};
+		buffers.reserve(secondaries.size());
+		for (const auto& secondary : secondaries)
+			buffers.emplace_back(std::static_pointer_cast<VkCommandBuffer>(secondary)->Buffer(currentFrame));
+
+		if (!buffers.empty())
+			mBuffers[currentFrame].executeCommands(buffers);
 	}
 
 	void VkCommandBuffer::End(const u32 currentFrame) const
@@ -78,11 +139,14 @@ namespace SnowEngine
 			stages.emplace_back(vk::PipelineStageFlagBits::eColorAttachmentOutput);
 		}
 
+		//presentation waits on the semaphore of the acquired image, the image may be presented after this frame slot is reused
+		const vk::Semaphore signal{ surface != nullptr ? std::static_pointer_cast<const VkSurface>(surface)->RenderFinishedSemaphore() : mFrames[currentFrame].Finished };
+
 		vk::SubmitInfo submitInfo;
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = &mBuffers[currentFrame];
 		submitInfo.signalSemaphoreCount = 1;
-		submitInfo.pSignalSemaphores = &mFrames[currentFrame].Finished;
+		submitInfo.pSignalSemaphores = &signal;
 		submitInfo.waitSemaphoreCount = static_cast<u32>(wait.size());
 		submitInfo.pWaitSemaphores = wait.data();
 		submitInfo.pWaitDstStageMask = stages.data();
@@ -90,20 +154,224 @@ namespace SnowEngine
 		mQueue.second.submit(submitInfo, mFrames[currentFrame].InFlight);
 	}
 
-	void VkCommandBuffer::GetQueue()
+	/**
+	 * \brief Submits after the given submissions of other command buffers, possibly on other queues, have completed.
+	 * Every call signals the next value of the command buffer timeline, see TimelineValue.
+	 * \param surface When not null the submission also waits for the acquired image and signals the semaphore presentation waits on.
+	 */
+	void VkCommandBuffer::Submit(const u32 currentFrame, const std::vector<QueueDependency>& dependencies, const std::shared_ptr<const Surface>& surface) const
+	{
+		std::vector<vk::Semaphore> wait{};
+		std::vector<vk::PipelineStageFlags> stages{};
+		std::vector<u64> waitValues{};
+
+		for (const auto& [cmd, value] : dependencies)
+		{
+			wait.emplace_back(std::static_pointer_cast<const VkCommandBuffer>(cmd)->mTimeline);
+			stages.emplace_back(GetStages(mUsage));
+			waitValues.emplace_back(value);
+		}
+
+		std::vector<vk::Semaphore> signal{ mTimeline };
+		std::vector<u64> signalValues{ ++mTimelineValue };
+
+		if (surface != nullptr)
+		{
+			const auto& vkSurface = std::static_pointer_cast<const VkSurface>(surface);
+			wait.emplace_back(vkSurface->ImageAvailableSemaphore());
+			stages.emplace_back(vk::PipelineStageFlagBits::eColorAttachmentOutput);
+			waitValues.emplace_back(0); //ignored for binary semaphores
+
+			signal.emplace_back(vkSurface->RenderFinishedSemaphore());
+			signalValues.emplace_back(0);
+		}
+
+		vk::TimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.waitSemaphoreValueCount = static_cast<u32>(waitValues.size());
+		timelineInfo.pWaitSemaphoreValues = waitValues.data();
+		timelineInfo.signalSemaphoreValueCount = static_cast<u32>(signalValues.size());
+		timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+		vk::SubmitInfo submitInfo;
+		submitInfo.pNext = &timelineInfo;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &mBuffers[currentFrame];
+		submitInfo.signalSemaphoreCount = static_cast<u32>(signal.size());
+		submitInfo.pSignalSemaphores = signal.data();
+		submitInfo.waitSemaphoreCount = static_cast<u32>(wait.size());
+		submitInfo.pWaitSemaphores = wait.data();
+		submitInfo.pWaitDstStageMask = stages.data();
+
+		mQueue.second.submit(submitInfo, mFrames[currentFrame].InFlight);
+	}
+
+	/**
+	 * \brief Timeline value signalled by the last submission, to be waited on through a QueueDependency.
+	 */
+	u64 VkCommandBuffer::TimelineValue() const { return mTimelineValue; }
+
+	/**
+	 * \brief Releases the buffer from this queue family to the family of destination, after the writes of this command buffer.
+	 * Must be paired with an Acquire recorded on the destination queue. Does nothing when both queues share a family.
+	 */
+	void VkCommandBuffer::Release(const std::shared_ptr<StorageBuffer>& buffer, const CommandBufferUsage destination) const
+	{
+		const u32 destinationFamily{ GetQueue(destination).first };
+		if (destinationFamily == mQueue.first)
+			return;
+
+		vk::BufferMemoryBarrier barrier{};
+		barrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eTransferWrite;
+		barrier.srcQueueFamilyIndex = mQueue.first;
+		barrier.dstQueueFamilyIndex = destinationFamily;
+		barrier.buffer = std::static_pointer_cast<VkStorageBuffer>(buffer)->Buffers()->Buffer();
+		barrier.offset = 0;
+		barrier.size = VK_WHOLE_SIZE;
+
+		CurrentBuffer().pipelineBarrier(GetStages(mUsage), vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, barrier, {});
+	}
+
+	/**
+	 * \brief Acquires the buffer released by a command buffer of the source usage, the release must be waited on through a QueueDependency.
+	 */
+	void VkCommandBuffer::Acquire(const std::shared_ptr<StorageBuffer>& buffer, const CommandBufferUsage source) const
+	{
+		const u32 sourceFamily{ GetQueue(source).first };
+		if (sourceFamily == mQueue.first)
+			return;
+
+		vk::BufferMemoryBarrier barrier{};
+		barrier.dstAccessMask = GetReadAccess(mUsage);
+		barrier.srcQueueFamilyIndex = sourceFamily;
+		barrier.dstQueueFamilyIndex = mQueue.first;
+		barrier.buffer = std::static_pointer_cast<VkStorageBuffer>(buffer)->Buffers()->Buffer();
+		barrier.offset = 0;
+		barrier.size = VK_WHOLE_SIZE;
+
+		CurrentBuffer().pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, GetStages(mUsage), {}, {}, barrier, {});
+	}
+
+	void VkCommandBuffer::ComputeBarrier() const
+	{
+		vk::MemoryBarrier barrier{};
+		barrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
+		barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eIndirectCommandRead;
+
+		CurrentBuffer().pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eDrawIndirect, {}, barrier, {}, {});
+	}
+
+	void VkCommandBuffer::BeginTiming(const u32 currentFrame) const
+	{
+		if (!mQueryPool)
+			return;
+
+		mBuffers[currentFrame].resetQueryPool(mQueryPool, currentFrame * 2, 2);
+		mBuffers[currentFrame].writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, mQueryPool, currentFrame * 2);
+		mTimed[currentFrame] = true;
+	}
+
+	void VkCommandBuffer::EndTiming(const u32 currentFrame) const
+	{
+		if (!mQueryPool)
+			return;
+
+		mBuffers[currentFrame].writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, mQueryPool, currentFrame * 2 + 1);
+	}
+
+	/**
+	 * \brief GPU timestamps, in milliseconds, written by BeginTiming and EndTiming during the last completed use of frameIndex.
+	 * Timestamps of different queues are compared directly, which holds on desktop drivers sharing one device clock.
+	 * \return False if the frame was not timed or the queue does not support timestamps.
+	 */
+	b8 VkCommandBuffer::Timing(const u32 frameIndex, f64& begin, f64& end) const
+	{
+		const auto& [first, last] = mTimestamps[frameIndex];
+		if (last == 0)
+			return false;
+
+		begin = static_cast<f64>(first) * mTimestampPeriod / 1000000.0;
+		end = static_cast<f64>(last) * mTimestampPeriod / 1000000.0;
+		return true;
+	}
+
+	void VkCommandBuffer::BeginStatistics(const u32 currentFrame) const
+	{
+		if (!mStatisticsPool)
+			return;
+
+		mBuffers[currentFrame].resetQueryPool(mStatisticsPool, currentFrame, 1);
+		mBuffers[currentFrame].beginQuery(mStatisticsPool, currentFrame, {});
+		mCounted[currentFrame] = true;
+	}
+
+	void VkCommandBuffer::EndStatistics(const u32 currentFrame) const
+	{
+		if (!mStatisticsPool)
+			return;
+
+		mBuffers[currentFrame].endQuery(mStatisticsPool, currentFrame);
+	}
+
+	/**
+	 * \brief Fragment shader invocations counted by BeginStatistics and EndStatistics during the last completed use of frameIndex.
+	 * \return False if the frame was not counted or the device does not support pipeline statistics.
+	 */
+	b8 VkCommandBuffer::FragmentInvocations(const u32 frameIndex, u64& invocations) const
+	{
+		if (mInvocations.empty() || mInvocations[frameIndex] == ~0ull)
+			return false;
+
+		invocations = mInvocations[frameIndex];
+		return true;
+	}
+
+	vkQueue VkCommandBuffer::GetQueue(const CommandBufferUsage usage)
+	{
+		switch (usage)
+		{
+		case CommandBufferUsage::Compute:
+			return VkCore::Get()->Queues().Compute;
+		case CommandBufferUsage::Graphics:
+		case CommandBufferUsage::Copy:
+			return VkCore::Get()->Queues().Graphics;
+		}
+
+		return VkCore::Get()->Queues().Graphics;
+	}
+
+	vk::PipelineStageFlags VkCommandBuffer::GetStages(const CommandBufferUsage usage)
+	{
+		switch (usage)
+		{
+		case CommandBufferUsage::Compute:
+			return vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer;
+		case CommandBufferUsage::Graphics:
+			return vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader;
+		case CommandBufferUsage::Copy:
+			return vk::PipelineStageFlagBits::eTransfer;
+		}
+
+		return vk::PipelineStageFlagBits::eAllCommands;
+	}
+
+	vk::AccessFlags VkCommandBuffer::GetReadAccess(const CommandBufferUsage usage)
 	{
-		switch (mUsage)
+		switch (usage)
 		{
 		case CommandBufferUsage::Compute:
-			mQueue = VkCore::Get()->Queues().Compute;
-			break;
+			return vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eTransferRead;
 		case CommandBufferUsage::Graphics:
-			mQueue = VkCore::Get()->Queues().Graphics;
-			break;
+			return vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eShaderRead;
 		case CommandBufferUsage::Copy:
-			mQueue = VkCore::Get()->Queues().Graphics;
-			break;
+			return vk::AccessFlagBits::eTransferRead;
 		}
+
+		return vk::AccessFlagBits::eMemoryRead;
+	}
+
+	void VkCommandBuffer::GetQueue()
+	{
+		mQueue = GetQueue(mUsage);
 	}
 
 	void VkCommandBuffer::CreatePool()
@@ -119,7 +387,7 @@ namespace SnowEngine
 	{
 		vk::CommandBufferAllocateInfo commandBufferAllocateInfo{};
 		commandBufferAllocateInfo.commandPool = mPool;
-		commandBufferAllocateInfo.level = vk::CommandBufferLevel::ePrimary;
+		commandBufferAllocateInfo.level = mLevel == CommandBufferLevel::Primary ? vk::CommandBufferLevel::ePrimary : vk::CommandBufferLevel::eSecondary;
 		commandBufferAllocateInfo.commandBufferCount = frameCount;
 
 		mBuffers = VkCore::Get()->Device().allocateCommandBuffers(commandBufferAllocateInfo);
@@ -129,6 +397,15 @@ namespace SnowEngine
 	{
 		vk::SemaphoreCreateInfo semaphoreCreateInfo{};
 
+		vk::SemaphoreTypeCreateInfo timelineTypeInfo{};
+		timelineTypeInfo.semaphoreType = vk::SemaphoreType::eTimeline;
+		timelineTypeInfo.initialValue = 0;
+
+		vk::SemaphoreCreateInfo timelineCreateInfo{};
+		timelineCreateInfo.pNext = &timelineTypeInfo;
+
+		mTimeline = VkCore::Get()->Device().createSemaphore(timelineCreateInfo);
+
 		vk::FenceCreateInfo fenceCreateInfo{};
 		fenceCreateInfo.flags = vk::FenceCreateFlagBits::eSignaled;
 
@@ -139,4 +416,75 @@ namespace SnowEngine
 			finished = VkCore::Get()->Device().createSemaphore(semaphoreCreateInfo);
 		}
 	}
-}
+
+	void VkCommandBuffer::CreateQueryPool(const u32 frameCount)
+	{
+		const auto queueFamilies{ VkCore::Get()->PhysicalDevice().getQueueFamilyProperties() };
+		const u32 validBits{ queueFamilies[mQueue.first].timestampValidBits };
+
+		mTimestamps.resize(frameCount, { 0, 0 });
+		mTimed.resize(frameCount, false);
+
+		if (validBits == 0)
+			return;
+
+		mTimestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+		mTimestampPeriod = VkCore::Get()->PhysicalDevice().getProperties().limits.timestampPeriod;
+
+		vk::QueryPoolCreateInfo createInfo{};
+		createInfo.queryType = vk::QueryType::eTimestamp;
+		createInfo.queryCount = frameCount * 2;
+
+		mQueryPool = VkCore::Get()->Device().createQueryPool(createInfo);
+	}
+
+	void VkCommandBuffer::CreateStatisticsPool(const u32 frameCount)
+	{
+		//pipeline statistics are only available on graphics queues
+		mInvocations.resize(frameCount, ~0ull);
+		mCounted.resize(frameCount, false);
+		if (mUsage != CommandBufferUsage::Graphics || !VkCore::Get()->PipelineStatistics())
+			return;
+
+		vk::QueryPoolCreateInfo statisticsInfo{};
+		statisticsInfo.queryType = vk::QueryType::ePipelineStatistics;
+		statisticsInfo.queryCount = frameCount;
+		statisticsInfo.pipelineStatistics = vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations;
+
+		mStatisticsPool = VkCore::Get()->Device().createQueryPool(statisticsInfo);
+	}
+
+	/**
+	 * \brief Reads back the timestamps of the previous use of frameIndex, its fence must have been waited on.
+	 */
+	void VkCommandBuffer::ReadTimestamps(const u32 frameIndex) const
+	{
+		if (!mQueryPool || !mTimed[frameIndex])
+		{
+			mTimestamps[frameIndex] = { 0, 0 };
+			return;
+		}
+
+		std::array<u64, 2> values{};
+		const vk::Result result{ VkCore::Get()->Device().getQueryPoolResults(mQueryPool, frameIndex * 2, 2, sizeof(values), values.data(), sizeof(u64), vk::QueryResultFlagBits::e64) };
+
+		mTimestamps[frameIndex] = result == vk::Result::eSuccess ? std::array<u64, 2>{ values[0] & mTimestampMask, values[1] & mTimestampMask } : std::array<u64, 2>{ 0, 0 };
+		mTimed[frameIndex] = false;
+	}
+
+	void VkCommandBuffer::ReadStatistics(const u32 frameIndex) const
+	{
+		if (!mStatisticsPool || !mCounted[frameIndex])
+		{
+			if (!mInvocations.empty())
+				mInvocations[frameIndex] = ~0ull;
+			return;
+		}
+
+		u64 invocations{ 0 };
+		const vk::Result result{ VkCore::Get()->Device().getQueryPoolResults(mStatisticsPool, frameIndex, 1, sizeof(invocations), &invocations, sizeof(u64), vk::QueryResultFlagBits::e64) };
+
+		mInvocations[frameIndex] = result == vk::Result::eSuccess ? invocations : ~0ull;
+		mCounted[frameIndex] = false;
+	}
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <vulkan/vulkan.hpp>
 
 #include "Core/Types.h"
@@ -14,22 +15,48 @@ namespace SnowEngine
 	class VkCommandBuffer : public CommandBuffer
 	{
 	public:
-		VkCommandBuffer(u32 frameCount, CommandBufferUsage usage);
+		VkCommandBuffer(u32 frameCount, CommandBufferUsage usage, CommandBufferLevel level);
 
 		vk::Semaphore FinishedSemaphore(u32 frameIndex) const;
 		vk::CommandBuffer Buffer(u32 frameIndex) const;
 		vk::CommandBuffer CurrentBuffer() const;
+		CommandBufferUsage Usage() const;
 
+		void Wait(u32 frameIndex) const;
 		void Begin(u32 currentFrame) const override;
+		void Begin(u32 currentFrame, const std::shared_ptr<RenderPass>& renderPass) const override;
+		void Execute(u32 currentFrame, const std::vector<std::shared_ptr<CommandBuffer>>& secondaries) const override;
 		void End(u32 currentFrame) const override;
 		void Submit(u32 currentFrame, const std::shared_ptr<const CommandBuffer>& previousCmd) const override;
 		void Submit(u32 currentFrame, const std::shared_ptr<const Surface>& surface) const override;
+		void Submit(u32 currentFrame, const std::vector<QueueDependency>& dependencies, const std::shared_ptr<const Surface>& surface = nullptr) const override;
+		u64 TimelineValue() const override;
+
+		void Release(const std::shared_ptr<StorageBuffer>& buffer, CommandBufferUsage destination) const override;
+		void Acquire(const std::shared_ptr<StorageBuffer>& buffer, CommandBufferUsage source) const override;
+		void ComputeBarrier() const override;
+
+		void BeginTiming(u32 currentFrame) const override;
+		void EndTiming(u32 currentFrame) const override;
+		b8 Timing(u32 frameIndex, f64& begin, f64& end) const override;
+
+		void BeginStatistics(u32 currentFrame) const override;
+		void EndStatistics(u32 currentFrame) const override;
+		b8 FragmentInvocations(u32 frameIndex, u64& invocations) const override;
 
 	private:
+		static vkQueue GetQueue(CommandBufferUsage usage);
+		static vk::PipelineStageFlags GetStages(CommandBufferUsage usage);
+		static vk::AccessFlags GetReadAccess(CommandBufferUsage usage);
+
 		void GetQueue();
 		void CreatePool();
 		void CreateBuffers(u32 frameCount);
 		void CreateSyncData(u32 frameCount);
+		void CreateQueryPool(u32 frameCount);
+		void CreateStatisticsPool(u32 frameCount);
+		void ReadTimestamps(u32 frameIndex) const;
+		void ReadStatistics(u32 frameIndex) const;
 
 		struct SyncData
 		{
@@ -37,9 +64,20 @@ namespace SnowEngine
 			vk::Semaphore Finished;
 		};
 		std::vector<SyncData> mFrames;
+		vk::Semaphore mTimeline;
+		mutable u64 mTimelineValue{ 0 };
+		vk::QueryPool mQueryPool;
+		mutable std::vector<std::array<u64, 2>> mTimestamps;
+		mutable std::vector<b8> mTimed;
+		u64 mTimestampMask{ 0 };
+		f64 mTimestampPeriod{ 0.0 }; //nanoseconds per tick
+		vk::QueryPool mStatisticsPool;
+		mutable std::vector<u64> mInvocations;
+		mutable std::vector<b8> mCounted;
 		vk::CommandPool mPool;
 		std::vector<vk::CommandBuffer> mBuffers;
 		vkQueue mQueue;
 		CommandBufferUsage mUsage;
+		CommandBufferLevel mLevel;
 	};
 }
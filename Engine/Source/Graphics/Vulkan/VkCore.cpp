@@ -2,11 +2,19 @@
 
 #define VMA_IMPLEMENTATION
 #include <vma/vk_mem_alloc.h>
+#include <algorithm>
 #include <set>
 #include <GLFW/glfw3.h>
 #include "Core/Types.h"
 #include "VkValidationLayer.h"
+#include "VkGeometryPool.h"
+#include "VkDescriptorAllocator.h"
+#include "VkLayoutCache.h"
+#include "VkPipelineCache.h"
+#include "VkSamplerCache.h"
+#include "VkUniformAllocator.h"
 #include "Core/Window.h"
+#include "Graphics/Rhi/Surface.h"
 
 namespace SnowEngine
 {
@@ -23,6 +31,11 @@ namespace SnowEngine
 
 	VkCore* VkCore::sInstance{ nullptr };
 
+	static constexpr u32 sUniformFrameSize{ 4 * 1024 * 1024 };
+	static constexpr u32 sGeometryVertexCapacity{ 1024 * 1024 };
+	static constexpr u32 sGeometryIndexCapacity{ 4 * 1024 * 1024 };
+	static constexpr const char* sPipelineCacheDirectory{ "D:/Dev/SnowEngine/Engine/Cache" };
+
 	b8 VkQueues::IsComplete() const
 	{
 		return Graphics.first != UINT32_MAX
@@ -45,6 +58,18 @@ namespace SnowEngine
 
 	VkCore::~VkCore()
 	{
+		mDevice.waitIdle();
+		for (auto& [frame, release] : mDeferred)
+			release();
+		mDeferred.clear();
+
+		mUniformAllocator.reset();
+		mDescriptorAllocator.reset();
+		mLayoutCache.reset();
+		mSamplerCache.reset();
+		mGeometryPool.reset();
+		mPipelineCache.reset(); //saved to disk
+
 		vmaDestroyAllocator(mAllocator);
 
 		DestroyDebugUtilsMessengerEXT(mInstance, mMessenger, nullptr);
@@ -58,10 +83,104 @@ namespace SnowEngine
 
 	VkQueues VkCore::Queues() const { return mQueues; }
 
+	/**
+	 * \brief True when compute work is submitted to a different queue family than graphics and can run alongside it.
+	 */
+	b8 VkCore::AsyncCompute() const { return mQueues.Compute.first != mQueues.Graphics.first; }
+
+	/**
+	 * \brief True when pipeline statistics can be queried, also while executing secondary buffers.
+	 */
+	b8 VkCore::PipelineStatistics() const { return mPipelineStatistics; }
+
 	VmaAllocator VkCore::Allocator() const { return mAllocator; }
 
+	/**
+	 * \brief Created by the surface with its frames in flight, uniforms written before there is a surface get a region for
+	 * as many frames as a surface may have.
+	 */
+	VkUniformAllocator& VkCore::UniformAllocator() const
+	{
+		CreateUniformAllocator(Surface::sMaxFramesInFlight);
+		return *mUniformAllocator;
+	}
+
+	void VkCore::CreateUniformAllocator(const u32 framesInFlight) const
+	{
+		//descriptor sets reference the buffer, so it is never replaced
+		if (!mUniformAllocator)
+			mUniformAllocator = std::make_unique<VkUniformAllocator>(sUniformFrameSize, framesInFlight);
+	}
+
+	VkDescriptorAllocator& VkCore::DescriptorAllocator() const
+	{
+		if (!mDescriptorAllocator)
+			mDescriptorAllocator = std::make_unique<VkDescriptorAllocator>(Surface::sMaxFramesInFlight);
+
+		return *mDescriptorAllocator;
+	}
+
+	VkLayoutCache& VkCore::LayoutCache() const
+	{
+		if (!mLayoutCache)
+			mLayoutCache = std::make_unique<VkLayoutCache>();
+
+		return *mLayoutCache;
+	}
+
+	VkSamplerCache& VkCore::SamplerCache() const
+	{
+		if (!mSamplerCache)
+			mSamplerCache = std::make_unique<VkSamplerCache>(mSamplerAnisotropy ? mPhysicalDevice.getProperties().limits.maxSamplerAnisotropy : 1.0f);
+
+		return *mSamplerCache;
+	}
+
+	VkGeometryPool& VkCore::GeometryPool() const
+	{
+		if (!mGeometryPool)
+			mGeometryPool = std::make_unique<VkGeometryPool>(sGeometryVertexCapacity, sGeometryIndexCapacity);
+
+		return *mGeometryPool;
+	}
+
+	VkPipelineCache& VkCore::PipelineCache() const { return *mPipelineCache; }
+
+	void VkCore::Defer(std::function<void()>&& release) const
+	{
+		std::lock_guard lock{ mDeferredMutex };
+		mDeferred.emplace_back(mFrame, std::move(release));
+	}
+
+	/**
+	 * \brief Frames retire in order, a frame has completed once the one framesInFlight later begins. What was deferred
+	 * during a frame is released then, what was deferred between two frames waits for the one before.
+	 */
+	void VkCore::RetireFrame(const u32 framesInFlight) const
+	{
+		std::vector<std::function<void()>> retired{};
+		{
+			std::lock_guard lock{ mDeferredMutex };
+			mFrame++;
+
+			const auto end{ std::stable_partition(mDeferred.begin(), mDeferred.end(), [&](const auto& deferred) { return deferred.first + framesInFlight > mFrame; }) };
+			for (auto it{ end }; it != mDeferred.end(); ++it)
+				retired.emplace_back(std::move(it->second));
+			mDeferred.erase(end, mDeferred.end());
+		}
+
+		for (const auto& release : retired)
+			release();
+	}
+
 	void VkCore::DeviceWaitIdle() const { mDevice.waitIdle(); }
 
+	b8 VkCore::DeviceSubgroupOperations() const { return mSubgroupOperations; }
+
+	PipelineCacheStats VkCore::DevicePipelineCacheStatistics() const { return mPipelineCache->Stats(); }
+
+	void VkCore::DeviceSetColdPipelineCache(const b8 cold) const { mPipelineCache->SetScratch(cold); }
+
 	void VkCore::SubmitInstantCommand(std::function<void(vk::CommandBuffer cmd)>&& command) const
 	{
 		vk::CommandBufferAllocateInfo allocInfo{};
@@ -98,6 +217,7 @@ namespace SnowEngine
 		CreateLogicalDevice();
 		CreateAllocator();
 		CreateInstantCommandPool();
+		CreatePipelineCache();
 	}
 
 	void VkCore::CreateInstance()
@@ -144,12 +264,29 @@ namespace SnowEngine
 			{
 				mPhysicalDevice = device;
 				mQueues = queues;
-				return;
+				break;
 			}
 		}
 
-		mPhysicalDevice = devices[0];
-		mQueues = {};
+		if (!mPhysicalDevice)
+		{
+			mPhysicalDevice = devices[0];
+			mQueues = {};
+		}
+
+		vk::PhysicalDeviceSubgroupProperties subgroupProperties{};
+		vk::PhysicalDeviceProperties2 properties2{};
+		properties2.pNext = &subgroupProperties;
+		mPhysicalDevice.getProperties2(&properties2);
+
+		const vk::SubgroupFeatureFlags operations{ vk::SubgroupFeatureFlagBits::eBasic | vk::SubgroupFeatureFlagBits::eArithmetic };
+		mSubgroupOperations = (subgroupProperties.supportedStages & vk::ShaderStageFlagBits::eCompute) && (subgroupProperties.supportedOperations & operations) == operations;
+
+		const vk::PhysicalDeviceFeatures features{ mPhysicalDevice.getFeatures() };
+		mPipelineStatistics = features.pipelineStatisticsQuery && features.inheritedQueries;
+		mSamplerAnisotropy = features.samplerAnisotropy;
+
+		mCreationFeedback = CheckExtensionSupport(mPhysicalDevice, { VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME });
 	}
 
 	void VkCore::CreateLogicalDevice()
@@ -174,10 +311,19 @@ namespace SnowEngine
 		}
 
 		vk::PhysicalDeviceFeatures enabledFeatures{};
+		enabledFeatures.pipelineStatisticsQuery = mPipelineStatistics;
+		enabledFeatures.inheritedQueries = mPipelineStatistics;
+		enabledFeatures.samplerAnisotropy = mSamplerAnisotropy;
 		const auto enabledLayers{ GetRequiredLayers() };
-		const auto enabledExtensions{ GetDeviceExtensions() };
+		auto enabledExtensions{ GetDeviceExtensions() };
+		if (mCreationFeedback)
+			enabledExtensions.emplace_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+
+		vk::PhysicalDeviceVulkan12Features enabledVulkan12Features{};
+		enabledVulkan12Features.timelineSemaphore = VK_TRUE;
 
 		vk::DeviceCreateInfo createInfo{};
+		createInfo.pNext = &enabledVulkan12Features;
 		createInfo.pEnabledFeatures = &enabledFeatures;
 		createInfo.queueCreateInfoCount = static_cast<u32>(queueCreateInfos.size());
 		createInfo.pQueueCreateInfos = queueCreateInfos.data();
@@ -213,6 +359,11 @@ namespace SnowEngine
 		mInstantCommandPool = mDevice.createCommandPool(createInfo);
 	}
 
+	void VkCore::CreatePipelineCache()
+	{
+		mPipelineCache = std::make_unique<VkPipelineCache>(mDevice, mPhysicalDevice.getProperties(), sPipelineCacheDirectory, mCreationFeedback);
+	}
+
 	std::pair<b8, VkQueues> VkCore::IsDeviceSuitable(const vk::PhysicalDevice& device) const
 	{
 		b8 suitable{ true };
@@ -223,28 +374,32 @@ namespace SnowEngine
 		glfwCreateWindowSurface(mInstance, window->Handle(), nullptr, &surface);
 
 		const std::vector<vk::QueueFamilyProperties> queueFamilies{ device.getQueueFamilyProperties() };
-		u32 i{ 0 };
-		for (const auto& queueFamily : queueFamilies)
+		for (u32 i{ 0 }; i < queueFamilies.size(); i++)
 		{
-			if (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics)
+			const vk::QueueFlags flags{ queueFamilies[i].queueFlags };
+
+			if (flags & vk::QueueFlagBits::eGraphics && queues.Graphics.first == UINT32_MAX)
 				queues.Graphics.first = i;
 
-			if (device.getSurfaceSupportKHR(i, surface))
+			//presenting from the graphics family avoids a transfer of the swapchain images
+			if (device.getSurfaceSupportKHR(i, surface) && (queues.Present.first == UINT32_MAX || i == queues.Graphics.first))
 				queues.Present.first = i;
 
-			if (queueFamily.queueFlags & vk::QueueFlagBits::eCompute)
+			//a compute only family runs asynchronously to graphics, the graphics family is the fallback
+			if (flags & vk::QueueFlagBits::eCompute && (queues.Compute.first == UINT32_MAX || !(flags & vk::QueueFlagBits::eGraphics)))
 				queues.Compute.first = i;
-
-			if (queues.IsComplete())
-				break;
-
-			i++;
 		}
 
 		const vk::PhysicalDeviceProperties properties{ device.getProperties() };
 		const vk::PhysicalDeviceFeatures features{ device.getFeatures() };
 
+		vk::PhysicalDeviceVulkan12Features vulkan12Features{};
+		vk::PhysicalDeviceFeatures2 features2{};
+		features2.pNext = &vulkan12Features;
+		device.getFeatures2(&features2);
+
 		suitable &= CheckExtensionSupport(device, GetDeviceExtensions());
+		suitable &= vulkan12Features.timelineSemaphore == VK_TRUE;
 		suitable &= queues.IsComplete();
 
 		return { suitable, queues };
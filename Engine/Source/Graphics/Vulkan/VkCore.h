@@ -1,5 +1,6 @@
 #pragma once
 #include <functional>
+#include <mutex>
 #include <vulkan/vulkan.hpp>
 #include <vma/vk_mem_alloc.h>
 
@@ -8,6 +9,13 @@
 
 namespace SnowEngine
 {
+	class VkDescriptorAllocator;
+	class VkGeometryPool;
+	class VkLayoutCache;
+	class VkSamplerCache;
+	class VkPipelineCache;
+	class VkUniformAllocator;
+
 	struct VkQueues
 	{
 		std::pair<u32, vk::Queue> Graphics = { UINT32_MAX, nullptr };
@@ -27,10 +35,27 @@ namespace SnowEngine
 		const vk::PhysicalDevice& PhysicalDevice() const;
 		const vk::Instance& Instance() const;
 		VkQueues Queues() const;
+		b8 AsyncCompute() const;
+		b8 PipelineStatistics() const;
 		VmaAllocator Allocator() const;
+		VkUniformAllocator& UniformAllocator() const;
+		/** \brief Creates the uniform allocator with a region per frame in flight, unless it already exists. */
+		void CreateUniformAllocator(u32 framesInFlight) const;
+		VkDescriptorAllocator& DescriptorAllocator() const;
+		VkLayoutCache& LayoutCache() const;
+		VkSamplerCache& SamplerCache() const;
+		VkGeometryPool& GeometryPool() const;
+		VkPipelineCache& PipelineCache() const;
 
 		void DeviceWaitIdle() const override;
+		b8 DeviceSubgroupOperations() const override;
+		PipelineCacheStats DevicePipelineCacheStatistics() const override;
+		void DeviceSetColdPipelineCache(b8 cold) const override;
 		void SubmitInstantCommand(std::function<void(vk::CommandBuffer cmd)>&& command) const;
+		/** \brief Runs release once every frame that may still use what it releases has retired. */
+		void Defer(std::function<void()>&& release) const;
+		/** \brief Called by the surface once the previous use of the frame slot it begins has completed. */
+		void RetireFrame(u32 framesInFlight) const;
 
 		static const VkCore* Get();
 
@@ -42,6 +67,7 @@ namespace SnowEngine
 		void CreateLogicalDevice();
 		void CreateAllocator();
 		void CreateInstantCommandPool();
+		void CreatePipelineCache();
 
 		std::pair<b8, VkQueues> IsDeviceSuitable(const vk::PhysicalDevice& device) const;
 		static b8 CheckExtensionSupport(const vk::PhysicalDevice& device, const std::vector<const char*>& extensions);
@@ -54,8 +80,21 @@ namespace SnowEngine
 		vk::PhysicalDevice mPhysicalDevice;
 		vk::Device mDevice;
 		VkQueues mQueues;
+		b8 mSubgroupOperations{ false };
+		b8 mPipelineStatistics{ false };
+		b8 mCreationFeedback{ false };
+		b8 mSamplerAnisotropy{ false };
 		VmaAllocator mAllocator;
 		vk::CommandPool mInstantCommandPool;
+		mutable std::unique_ptr<VkUniformAllocator> mUniformAllocator;
+		mutable std::unique_ptr<VkDescriptorAllocator> mDescriptorAllocator;
+		mutable std::unique_ptr<VkLayoutCache> mLayoutCache;
+		mutable std::unique_ptr<VkSamplerCache> mSamplerCache;
+		mutable std::unique_ptr<VkGeometryPool> mGeometryPool;
+		std::unique_ptr<VkPipelineCache> mPipelineCache;
+		mutable std::vector<std::pair<u64, std::function<void()>>> mDeferred; //frame they were deferred in
+		mutable std::mutex mDeferredMutex;
+		mutable u64 mFrame{ 0 };
 		static VkCore* sInstance;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "VkDescriptorAllocator.h"
+
+#include <algorithm>
+#include <array>
+
+#include "VkCore.h"
+#include "Core/Logger.h"
+
+namespace SnowEngine
+{
+	//descriptors of every type reserved per set in a pool, the pools are shared by every layout so they are sized by
+	//ratio rather than exactly
+	static constexpr std::array<std::pair<vk::DescriptorType, u32>, 3> sDescriptorsPerSet
+	{ {
+		{ vk::DescriptorType::eUniformBufferDynamic, 2 },
+		{ vk::DescriptorType::eCombinedImageSampler, 4 },
+		{ vk::DescriptorType::eStorageBuffer, 4 }
+	} };
+
+	VkDescriptorAllocator::VkDescriptorAllocator(const u32 frameCount)
+		: mTransient(frameCount) { }
+
+	VkDescriptorAllocator::~VkDescriptorAllocator()
+	{
+		const vk::Device device{ VkCore::Get()->Device() };
+
+		for (const auto pool : mPersistent.Pools)
+			device.destroyDescriptorPool(pool);
+
+		for (const auto& list : mTransient)
+		{
+			for (const auto pool : list.Pools)
+				device.destroyDescriptorPool(pool);
+		}
+	}
+
+	VkDescriptorAllocation VkDescriptorAllocator::Allocate(const std::vector<vk::DescriptorSetLayout>& layouts)
+	{
+		std::lock_guard lock{ mMutex };
+
+		VkDescriptorAllocation allocation{};
+		if (!TryAllocate(mPersistent, true, layouts, allocation))
+			LOG_ERROR("Descriptor allocator failed to allocate %u sets, their layouts need more descriptors than a pool reserves", static_cast<u32>(layouts.size()));
+
+		return allocation;
+	}
+
+	void VkDescriptorAllocator::Free(const VkDescriptorAllocation& allocation)
+	{
+		if (!allocation.Pool)
+			return;
+
+		std::lock_guard lock{ mMutex };
+		VkCore::Get()->Device().freeDescriptorSets(allocation.Pool, allocation.Sets);
+	}
+
+	vk::DescriptorSet VkDescriptorAllocator::AllocateTransient(const vk::DescriptorSetLayout layout, const u32 frameIndex)
+	{
+		std::lock_guard lock{ mMutex };
+
+		VkDescriptorAllocation allocation{};
+		if (!TryAllocate(mTransient.at(frameIndex), false, { layout }, allocation))
+		{
+			LOG_ERROR("Descriptor allocator failed to allocate a transient set, its layout needs more descriptors than a pool reserves");
+			return nullptr;
+		}
+
+		return allocation.Sets.front();
+	}
+
+	void VkDescriptorAllocator::Reset(const u32 frameIndex)
+	{
+		std::lock_guard lock{ mMutex };
+
+		PoolList& list{ mTransient.at(frameIndex) };
+		for (const auto pool : list.Pools)
+			VkCore::Get()->Device().resetDescriptorPool(pool);
+
+		list.Current = 0;
+	}
+
+	u32 VkDescriptorAllocator::PoolCount() const
+	{
+		std::lock_guard lock{ mMutex };
+
+		u32 count{ static_cast<u32>(mPersistent.Pools.size()) };
+		for (const auto& list : mTransient)
+			count += static_cast<u32>(list.Pools.size());
+
+		return count;
+	}
+
+	/**
+	 * \brief Allocates from the current pool of the list, moving on to the following ones and finally to a new pool,
+	 * twice as large as the last one, when a pool is out of memory or fragmented.
+	 */
+	b8 VkDescriptorAllocator::TryAllocate(PoolList& list, const b8 freeable, const std::vector<vk::DescriptorSetLayout>& layouts, VkDescriptorAllocation& allocation)
+	{
+		const vk::Device device{ VkCore::Get()->Device() };
+
+		allocation.Sets.resize(layouts.size());
+
+		vk::DescriptorSetAllocateInfo allocInfo{};
+		allocInfo.descriptorSetCount = static_cast<u32>(layouts.size());
+		allocInfo.pSetLayouts = layouts.data();
+
+		for (u32 i{ 0 }; i < list.Pools.size(); i++)
+		{
+			//freed sets make room in earlier pools, so the search wraps around the list
+			const u32 index{ (list.Current + i) % static_cast<u32>(list.Pools.size()) };
+			allocInfo.descriptorPool = list.Pools[index];
+
+			const vk::Result result{ device.allocateDescriptorSets(&allocInfo, allocation.Sets.data()) };
+			if (result == vk::Result::eSuccess)
+			{
+				list.Current = index;
+				allocation.Pool = list.Pools[index];
+				return true;
+			}
+
+			if (result != vk::Result::eErrorOutOfPoolMemory && result != vk::Result::eErrorFragmentedPool)
+				break;
+		}
+
+		if (!list.Pools.empty())
+			list.SetsPerPool = std::min(list.SetsPerPool * 2, sMaxSetsPerPool);
+
+		const u32 setCount{ std::max(list.SetsPerPool, static_cast<u32>(layouts.size())) };
+		list.Pools.push_back(CreatePool(setCount, freeable));
+		list.Current = static_cast<u32>(list.Pools.size()) - 1;
+
+		allocInfo.descriptorPool = list.Pools.back();
+		if (device.allocateDescriptorSets(&allocInfo, allocation.Sets.data()) != vk::Result::eSuccess)
+		{
+			allocation.Sets.clear();
+			return false;
+		}
+
+		allocation.Pool = list.Pools.back();
+		return true;
+	}
+
+	vk::DescriptorPool VkDescriptorAllocator::CreatePool(const u32 setCount, const b8 freeable) const
+	{
+		std::vector<vk::DescriptorPoolSize> sizes{};
+		for (const auto& [type, count] : sDescriptorsPerSet)
+			sizes.emplace_back(type, count * setCount);
+
+		vk::DescriptorPoolCreateInfo createInfo{};
+		createInfo.flags = freeable ? vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet : vk::DescriptorPoolCreateFlags{};
+		createInfo.poolSizeCount = static_cast<u32>(sizes.size());
+		createInfo.pPoolSizes = sizes.data();
+		createInfo.maxSets = setCount;
+
+		return VkCore::Get()->Device().createDescriptorPool(createInfo);
+	}
+}
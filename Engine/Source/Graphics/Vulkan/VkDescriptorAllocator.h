@@ -0,0 +1,64 @@
+#pragma once
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "Core/Types.h"
+
+namespace SnowEngine
+{
+	/** \brief Sets allocated together by VkDescriptorAllocator::Allocate, handed back to it as a whole. */
+	struct VkDescriptorAllocation
+	{
+		vk::DescriptorPool Pool{ nullptr };
+		std::vector<vk::DescriptorSet> Sets;
+	};
+
+	/**
+	 * \brief Descriptor sets allocated from a few shared pools instead of a pool per set.
+	 * Persistent sets come from pools allowing them to be freed one by one. Transient sets live for a single frame and
+	 * come from the pools of their frame slot, created without individual freeing and reset as a whole when the slot
+	 * begins again.
+	 * When a pool runs out of memory or is too fragmented the next one is tried, a new larger pool is created once every
+	 * pool failed.
+	 */
+	class VkDescriptorAllocator
+	{
+	public:
+		VkDescriptorAllocator(u32 frameCount);
+		~VkDescriptorAllocator();
+
+		VkDescriptorAllocator(const VkDescriptorAllocator&) = delete;
+		VkDescriptorAllocator& operator=(const VkDescriptorAllocator&) = delete;
+
+		/** \return An allocation without pool nor sets when even a new pool cannot hold the layouts. */
+		VkDescriptorAllocation Allocate(const std::vector<vk::DescriptorSetLayout>& layouts);
+		/** \brief Frees the sets right away, the gpu must be done with them. */
+		void Free(const VkDescriptorAllocation& allocation);
+
+		/** \brief Allocates a set valid until the frame slot is reset, null when even a new pool cannot hold it. */
+		vk::DescriptorSet AllocateTransient(vk::DescriptorSetLayout layout, u32 frameIndex);
+		/** \brief Returns every transient set of the frame slot, the gpu must be done with them. */
+		void Reset(u32 frameIndex);
+
+		u32 PoolCount() const;
+
+	private:
+		struct PoolList
+		{
+			std::vector<vk::DescriptorPool> Pools;
+			u32 Current{ 0 }; //first pool tried
+			u32 SetsPerPool{ sInitialSetsPerPool };
+		};
+
+		b8 TryAllocate(PoolList& list, b8 freeable, const std::vector<vk::DescriptorSetLayout>& layouts, VkDescriptorAllocation& allocation);
+		vk::DescriptorPool CreatePool(u32 setCount, b8 freeable) const;
+
+		PoolList mPersistent;
+		std::vector<PoolList> mTransient; //by frame slot
+		mutable std::mutex mMutex;
+
+		static constexpr u32 sInitialSetsPerPool{ 128 };
+		static constexpr u32 sMaxSetsPerPool{ 4096 };
+	};
+}
@@ -2,187 +2,170 @@
 
 #include "VkCore.h"
 #include "VkImage.h"
+#include "VkSamplerCache.h"
+#include "VkUniformAllocator.h"
 
 namespace SnowEngine
 {
-	VkDescriptorSet::VkDescriptorSet(const VkDescriptorSetLayout& layout, const u32 frameCount)
-		: mLayout{ layout }, mFrameCount{ frameCount }
+	VkDescriptorSet::VkDescriptorSet(const VkDescriptorSetLayout& layout, const u32 frameCount, const u32 transientFrame)
+		: mLayout{ layout }, mFrameCount{ frameCount }, mTransientFrame{ transientFrame }
 	{
-		CreatePool();
 		CreateSets();
 		CreateBuffers();
 	}
 
+	VkDescriptorSet::~VkDescriptorSet()
+	{
+		//transient sets go back with the reset of their frame slot
+		if (mTransientFrame != sPersistent)
+			return;
+
+		//command buffers of the frames in flight may still use the sets
+		VkCore::Get()->Defer([allocation = mAllocation]
+		{
+			VkCore::Get()->DescriptorAllocator().Free(allocation);
+		});
+	}
+
 	const std::vector<vk::DescriptorSet>& VkDescriptorSet::Sets() const {	return mSets; }
 
+	vk::DescriptorSet VkDescriptorSet::Set(const u32 frameIndex) const { return mSets.at(Copy(frameIndex)); }
+
 	set VkDescriptorSet::SetIndex() const { return mLayout.SetIndex; }
 
-	void VkDescriptorSet::SetUniform(const std::string& name, const void* data, const u32 currentFrame) const
+	const std::vector<u32>& VkDescriptorSet::DynamicOffsets(const u32 frameIndex) const { return mDynamicOffsets.at(Copy(frameIndex)); }
+
+	bindingHandle VkDescriptorSet::Resolve(const std::string& name) const
 	{
-		for (const auto& [binding, resource] : mLayout.Resources)
+		for (u32 i{ 0 }; i < mSlots.size(); i++)
 		{
-			if (resource.Name == name && resource.Type == VkResourceType::Uniform)
-				mUniforms.at(binding)->InsertData(data, currentFrame);
+			if (mSlots[i].Resource->Name == name)
+				return i;
 		}
+
+		return sNoBinding;
 	}
 
-	void VkDescriptorSet::SetImage(const std::string& name, const std::shared_ptr<Image>& image)
+	void VkDescriptorSet::SetUniform(const bindingHandle handle, const void* data, const u32 currentFrame) const
 	{
-		const auto vkImage{ reinterpret_cast<const VkImage*>(image.get()) };
-		for (const auto& [binding, resource] : mLayout.Resources)
-		{
-			if (resource.Name == name && resource.Type == VkResourceType::Image)
-			{
-				vk::DescriptorImageInfo imageInfo{};
-				imageInfo.imageLayout = vkImage->Layout();
-				imageInfo.imageView = vkImage->View();
-				imageInfo.sampler = mImages.at(binding).second;
-
-				for (const auto set : mSets)
-				{
-					vk::WriteDescriptorSet write{};
-					write.dstSet = set;
-					write.dstBinding = binding;
-					write.dstArrayElement = 0;
-					write.descriptorType = vk::DescriptorType::eCombinedImageSampler;
-					write.descriptorCount = 1;
-					write.pImageInfo = &imageInfo;
-
-					VkCore::Get()->Device().updateDescriptorSets(write, nullptr);
-				}
-
-				mImages.at(binding).first = image;
-			}
-		}
+		if (const auto slot{ GetSlot(handle, VkResourceType::Uniform) })
+			mDynamicOffsets[Copy(currentFrame)][slot->Offset] = VkCore::Get()->UniformAllocator().Allocate(data, slot->Resource->Size);
 	}
 
-	void VkDescriptorSet::SetStorageBuffer(const std::string& name, const std::shared_ptr<StorageBuffer>& buffer)
+	void VkDescriptorSet::SetImage(const bindingHandle handle, const std::shared_ptr<Image>& image, const SamplerDesc& sampler)
 	{
-		for (const auto& [binding, resource] : mLayout.Resources)
-		{
-			if (resource.Name == name && resource.Type == VkResourceType::StorageBuffer)
-			{
-				mStorageBuffers[binding] = std::static_pointer_cast<VkStorageBuffer>(buffer);
+		const auto slot{ GetSlot(handle, VkResourceType::Image) };
+		if (!slot)
+			return;
 
- 				for (u32 i{ 0 }; i < mSets.size(); i++)
-				{
-					vk::DescriptorBufferInfo bufferInfo{};
-					bufferInfo.buffer = mStorageBuffers[binding]->Buffers()->Buffer();
-					bufferInfo.offset = 0;
-					bufferInfo.range = mStorageBuffers[binding]->Buffers()->Size();
+		const auto vkImage{ reinterpret_cast<const VkImage*>(image.get()) };
 
-					vk::WriteDescriptorSet descriptorWrite{};
-					descriptorWrite.pBufferInfo = &bufferInfo;
-					descriptorWrite.descriptorType = vk::DescriptorType::eStorageBuffer;
-					descriptorWrite.descriptorCount = 1;
-					descriptorWrite.dstBinding = binding;
-					descriptorWrite.dstArrayElement = 0;
-					descriptorWrite.dstSet = mSets.at(i);
+		vk::DescriptorImageInfo imageInfo{};
+		imageInfo.imageLayout = vkImage->Layout();
+		imageInfo.imageView = vkImage->View();
+		imageInfo.sampler = VkCore::Get()->SamplerCache().Sampler(sampler);
 
-					VkCore::Get()->Device().updateDescriptorSets(descriptorWrite, nullptr);
-				}
-			}
+		for (const auto set : mSets)
+		{
+			vk::WriteDescriptorSet write{};
+			write.dstSet = set;
+			write.dstBinding = slot->Binding;
+			write.dstArrayElement = 0;
+			write.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+			write.descriptorCount = 1;
+			write.pImageInfo = &imageInfo;
+
+			VkCore::Get()->Device().updateDescriptorSets(write, nullptr);
 		}
 
+		mImages.at(slot->Binding) = image;
 	}
 
-	void VkDescriptorSet::CreatePool()
+	void VkDescriptorSet::SetStorageBuffer(const bindingHandle handle, const std::shared_ptr<StorageBuffer>& buffer)
 	{
-		std::vector<vk::DescriptorPoolSize> sizes{};
-		u32 uniformCount{ 0 }, imageCount{ 0 }, storageBufferCount{ 0 };
-		for(const auto& [binding, resource] : mLayout.Resources)
-		{
-			if (resource.Type == VkResourceType::Uniform)
-				uniformCount++;
-			else if (resource.Type == VkResourceType::Image)
-				imageCount++;
-			else if (resource.Type == VkResourceType::StorageBuffer)
-				storageBufferCount++;
-		}
-
-		uniformCount *= mFrameCount;
-		imageCount *= mFrameCount;
-		storageBufferCount *= mFrameCount;
-
-		if (uniformCount)
-			sizes.emplace_back(vk::DescriptorType::eUniformBuffer, uniformCount);
-		if (imageCount)
-			sizes.emplace_back(vk::DescriptorType::eCombinedImageSampler, imageCount);
-		if (storageBufferCount)
-			sizes.emplace_back(vk::DescriptorType::eStorageBuffer, storageBufferCount);
+		const auto slot{ GetSlot(handle, VkResourceType::StorageBuffer) };
+		if (!slot)
+			return;
 
-		vk::DescriptorPoolCreateInfo createInfo{};
-		createInfo.poolSizeCount = static_cast<u32>(sizes.size());
-		createInfo.pPoolSizes = sizes.data();
-		createInfo.maxSets = mFrameCount;
+		const binding binding{ slot->Binding };
+		mStorageBuffers[binding] = std::static_pointer_cast<VkStorageBuffer>(buffer);
 
-		mPool = VkCore::Get()->Device().createDescriptorPool(createInfo);
+		for (u32 i{ 0 }; i < mSets.size(); i++)
+		{
+			vk::DescriptorBufferInfo bufferInfo{};
+			bufferInfo.buffer = mStorageBuffers[binding]->Buffers()->Buffer();
+			bufferInfo.offset = 0;
+			bufferInfo.range = mStorageBuffers[binding]->Buffers()->Size();
+
+			vk::WriteDescriptorSet descriptorWrite{};
+			descriptorWrite.pBufferInfo = &bufferInfo;
+			descriptorWrite.descriptorType = vk::DescriptorType::eStorageBuffer;
+			descriptorWrite.descriptorCount = 1;
+			descriptorWrite.dstBinding = binding;
+			descriptorWrite.dstArrayElement = 0;
+			descriptorWrite.dstSet = mSets.at(i);
+
+			VkCore::Get()->Device().updateDescriptorSets(descriptorWrite, nullptr);
+		}
 	}
 
 	void VkDescriptorSet::CreateSets()
 	{
-		const std::vector<vk::DescriptorSetLayout> layouts{ mFrameCount, mLayout.CreateLayout() };
-		vk::DescriptorSetAllocateInfo allocInfo{};
-		allocInfo.descriptorPool = mPool;
-		allocInfo.descriptorSetCount = static_cast<u32>(layouts.size());
-		allocInfo.pSetLayouts = layouts.data();
+		if (mTransientFrame != sPersistent)
+		{
+			if (const vk::DescriptorSet set{ VkCore::Get()->DescriptorAllocator().AllocateTransient(mLayout.Layout(), mTransientFrame) })
+				mSets.push_back(set);
 
-		mSets = VkCore::Get()->Device().allocateDescriptorSets(allocInfo);
+			return;
+		}
+
+		const std::vector<vk::DescriptorSetLayout> layouts{ mFrameCount, mLayout.Layout() };
+
+		mAllocation = VkCore::Get()->DescriptorAllocator().Allocate(layouts);
+		mSets = mAllocation.Sets;
 	}
 
 	void VkDescriptorSet::CreateBuffers()
 	{
 		for (const auto& [binding, resource] : mLayout.Resources)
 		{
+			//dynamic offsets are ordered by binding number, which is the map order
+			mSlots.push_back({ binding, &resource, resource.Type == VkResourceType::Uniform ? mUniformCount++ : 0 });
+
 			if (resource.Type == VkResourceType::Uniform)
 			{
-				mUniforms.insert({ binding, std::make_unique<VkUniformBuffer>(resource.Size, mFrameCount) });
-
-				u32 i{ 0 };
-				for (const auto& buffer : mUniforms.at(binding)->Buffers())
+				for (const auto set : mSets)
 				{
 					vk::DescriptorBufferInfo bufferInfo{};
-					bufferInfo.buffer = buffer->Buffer();
+					bufferInfo.buffer = VkCore::Get()->UniformAllocator().Buffer();
 					bufferInfo.offset = 0;
-					bufferInfo.range = buffer->Size();
+					bufferInfo.range = resource.Size;
 
 					vk::WriteDescriptorSet descriptorWrite{};
 					descriptorWrite.pBufferInfo = &bufferInfo;
-					descriptorWrite.descriptorType = vk::DescriptorType::eUniformBuffer;
+					descriptorWrite.descriptorType = vk::DescriptorType::eUniformBufferDynamic;
 					descriptorWrite.descriptorCount = 1;
 					descriptorWrite.dstBinding = binding;
 					descriptorWrite.dstArrayElement = 0;
-					descriptorWrite.dstSet = mSets.at(i);
+					descriptorWrite.dstSet = set;
 
 					VkCore::Get()->Device().updateDescriptorSets(descriptorWrite, nullptr);
-
-					i++;
 				}
 			}
 
 			if (resource.Type == VkResourceType::Image)
 			{
-				vk::SamplerCreateInfo createInfo{};
-				createInfo.magFilter = vk::Filter::eLinear;
-				createInfo.minFilter = vk::Filter::eLinear;
-				createInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
-				createInfo.addressModeV = vk::SamplerAddressMode::eRepeat;
-				createInfo.addressModeW = vk::SamplerAddressMode::eRepeat;
-				createInfo.mipLodBias = 0.0f;
-				createInfo.anisotropyEnable = VK_FALSE;
-				createInfo.maxAnisotropy = 1.0f;
-				createInfo.compareEnable = VK_FALSE;
-				createInfo.compareOp = vk::CompareOp::eAlways;
-				createInfo.minLod = 0.0f;
-				createInfo.maxLod = 1.0f;
-				createInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
-
-				mImages.insert({ binding, { nullptr, VkCore::Get()->Device().createSampler(createInfo) } });
+				mImages.insert({ binding, nullptr });
 			}
 
-			if (resource.Type == VkResourceType::StorageBuffer)
+			//transient sets are filled right away, a placeholder buffer for each one would be wasted
+			if (resource.Type == VkResourceType::StorageBuffer && mTransientFrame != sPersistent)
+			{
+				mStorageBuffers.insert({ binding, nullptr });
+			}
+			else if (resource.Type == VkResourceType::StorageBuffer)
 			{
-				mStorageBuffers.insert({ binding, std::make_unique<VkStorageBuffer>(64) });
+				mStorageBuffers.insert({ binding, std::make_unique<VkStorageBuffer>(64, false) });
 
 				for (u32 i{ 0 }; i < mSets.size(); i++)
 				{
@@ -203,5 +186,19 @@ namespace SnowEngine
 				}
 			}
 		}
+
+		mDynamicOffsets.resize(mFrameCount, std::vector<u32>(mUniformCount, 0));
+	}
+
+	/** \brief Transient sets hold a single copy, whatever the frame. */
+	u32 VkDescriptorSet::Copy(const u32 frameIndex) const { return mTransientFrame != sPersistent ? 0 : frameIndex; }
+
+	/** \return Null when the handle is not resolved or names a resource of another type. */
+	const VkDescriptorSet::Slot* VkDescriptorSet::GetSlot(const bindingHandle handle, const VkResourceType type) const
+	{
+		if (handle >= mSlots.size() || mSlots[handle].Resource->Type != type)
+			return nullptr;
+
+		return &mSlots[handle];
 	}
 }
@@ -2,6 +2,7 @@
 #include <vulkan/vulkan.hpp>
 
 #include "VkBuffers.h"
+#include "VkDescriptorAllocator.h"
 #include "VkShader.h"
 #include "Graphics/Rhi/DescriptorSet.h"
 #include "Graphics/Rhi/Image.h"
@@ -11,26 +12,49 @@ namespace SnowEngine
 	class VkDescriptorSet : public DescriptorSet
 	{
 	public:
-		VkDescriptorSet(const VkDescriptorSetLayout& layout, u32 frameCount);
+		/** \param transientFrame Frame slot a transient set is allocated for, sPersistent for a set with a copy per frame. */
+		VkDescriptorSet(const VkDescriptorSetLayout& layout, u32 frameCount, u32 transientFrame = sPersistent);
+		~VkDescriptorSet() override;
 
 		const std::vector<vk::DescriptorSet>& Sets() const;
+		vk::DescriptorSet Set(u32 frameIndex) const;
 		set SetIndex() const;
+		const std::vector<u32>& DynamicOffsets(u32 frameIndex) const;
 
-		void SetUniform(const std::string& name, const void* data, u32 currentFrame) const override;
-		void SetImage(const std::string& name, const std::shared_ptr<Image>& image) override;
-		void SetStorageBuffer(const std::string& name, const std::shared_ptr<StorageBuffer>& buffer) override;
+		bindingHandle Resolve(const std::string& name) const override;
+
+		using DescriptorSet::SetUniform;
+		using DescriptorSet::SetImage;
+		using DescriptorSet::SetStorageBuffer;
+		void SetUniform(bindingHandle handle, const void* data, u32 currentFrame) const override;
+		void SetImage(bindingHandle handle, const std::shared_ptr<Image>& image, const SamplerDesc& sampler = {}) override;
+		void SetStorageBuffer(bindingHandle handle, const std::shared_ptr<StorageBuffer>& buffer) override;
 
 	private:
-		void CreatePool();
+		//resources in binding order, a handle is an index in it
+		struct Slot
+		{
+			binding Binding;
+			const VkResource* Resource;
+			u32 Offset; //index of the dynamic offset of a uniform
+		};
+
 		void CreateSets();
 		void CreateBuffers();
+		const Slot* GetSlot(bindingHandle handle, VkResourceType type) const;
+		u32 Copy(u32 frameIndex) const;
 
-		vk::DescriptorPool mPool;
+		VkDescriptorAllocation mAllocation;
 		std::vector<vk::DescriptorSet> mSets;
-		std::map<binding, std::unique_ptr<VkUniformBuffer>> mUniforms;
+		std::vector<Slot> mSlots;
+		u32 mUniformCount{ 0 };
+		mutable std::vector<std::vector<u32>> mDynamicOffsets;
 		std::map<binding, std::shared_ptr<VkStorageBuffer>> mStorageBuffers;
-		std::map<binding, std::pair<std::shared_ptr<Image>, vk::Sampler>> mImages;
+		std::map<binding, std::shared_ptr<Image>> mImages;
 		const VkDescriptorSetLayout& mLayout;
 		u32 mFrameCount;
+		u32 mTransientFrame;
+
+		static constexpr u32 sPersistent{ ~0u };
 	};
 }
@@ -0,0 +1,101 @@
+#include "VkGeometryPool.h"
+
+#include "VkCore.h"
+#include "VkCommandBuffer.h"
+#include "Core/Logger.h"
+
+namespace SnowEngine
+{
+	VkGeometryPool::VkGeometryPool(const u32 vertexCapacity, const u32 indexCapacity)
+		: mVertexBuffer{ vertexCapacity * static_cast<u32>(sizeof(Vertex)), vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst, VMA_MEMORY_USAGE_GPU_ONLY },
+		  mIndexBuffer{ indexCapacity * static_cast<u32>(sizeof(u32)), vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst, VMA_MEMORY_USAGE_GPU_ONLY },
+		  mVertexAllocator{ vertexCapacity }, mIndexAllocator{ indexCapacity } { }
+
+	/**
+	 * \brief Reserves a range of the shared buffers and uploads the geometry through a single staging copy.
+	 */
+	b8 VkGeometryPool::Allocate(const Vertex* vertices, const u32 vertexCount, const u32* indices, const u32 indexCount, GeometryRange& range)
+	{
+		u64 vertexOffset{ 0 }, firstIndex{ 0 };
+		if (!mVertexAllocator.Allocate(vertexCount, vertexOffset))
+		{
+			LOG_ERROR("Geometry pool out of vertex memory: %u vertices requested", vertexCount);
+			return false;
+		}
+
+		if (indexCount && !mIndexAllocator.Allocate(indexCount, firstIndex))
+		{
+			mVertexAllocator.Free(vertexOffset, vertexCount);
+			LOG_ERROR("Geometry pool out of index memory: %u indices requested", indexCount);
+			return false;
+		}
+
+		range.VertexOffset = static_cast<u32>(vertexOffset);
+		range.VertexCount = vertexCount;
+		range.FirstIndex = static_cast<u32>(firstIndex);
+		range.IndexCount = indexCount;
+
+		const u32 vertexSize{ vertexCount * static_cast<u32>(sizeof(Vertex)) };
+		const u32 indexSize{ indexCount * static_cast<u32>(sizeof(u32)) };
+
+		const VkBuffer staging{ vertexSize + indexSize, vk::BufferUsageFlagBits::eTransferSrc, VMA_MEMORY_USAGE_CPU_ONLY };
+		staging.Write(vertices, vertexSize, 0);
+		if (indexCount)
+			staging.Write(indices, indexSize, vertexSize);
+
+		VkCore::Get()->SubmitInstantCommand([&](const vk::CommandBuffer cmd)
+		{
+			vk::BufferCopy vertexRegion{};
+			vertexRegion.srcOffset = 0;
+			vertexRegion.dstOffset = vertexOffset * sizeof(Vertex);
+			vertexRegion.size = vertexSize;
+
+			cmd.copyBuffer(staging.Buffer(), mVertexBuffer.Buffer(), vertexRegion);
+
+			if (!indexCount)
+				return;
+
+			vk::BufferCopy indexRegion{};
+			indexRegion.srcOffset = vertexSize;
+			indexRegion.dstOffset = firstIndex * sizeof(u32);
+			indexRegion.size = indexSize;
+
+			cmd.copyBuffer(staging.Buffer(), mIndexBuffer.Buffer(), indexRegion);
+		});
+
+		return true;
+	}
+
+	/**
+	 * \brief The range is reused only once the frames in flight that may still draw from it have retired.
+	 */
+	void VkGeometryPool::Free(const GeometryRange& range)
+	{
+		VkCore::Get()->Defer([this, range]
+		{
+			mVertexAllocator.Free(range.VertexOffset, range.VertexCount);
+			mIndexAllocator.Free(range.FirstIndex, range.IndexCount);
+		});
+	}
+
+	void VkGeometryPool::Bind(const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		const auto& vkCmd = std::static_pointer_cast<VkCommandBuffer>(cmd);
+
+		vkCmd->CurrentBuffer().bindVertexBuffers(0, mVertexBuffer.Buffer(), { 0 });
+		vkCmd->CurrentBuffer().bindIndexBuffer(mIndexBuffer.Buffer(), 0, vk::IndexType::eUint32);
+	}
+
+	void VkGeometryPool::Draw(const GeometryRange& range, const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		const auto& vkCmd = std::static_pointer_cast<VkCommandBuffer>(cmd);
+
+		if (range.IndexCount)
+		{
+			vkCmd->CurrentBuffer().drawIndexed(range.IndexCount, 1, range.FirstIndex, static_cast<i32>(range.VertexOffset), 0);
+			return;
+		}
+
+		vkCmd->CurrentBuffer().draw(range.VertexCount, 1, range.VertexOffset, 0);
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+
+#include "VkBuffers.h"
+#include "Graphics/FreeListAllocator.h"
+#include "Graphics/Rhi/GeometryPool.h"
+
+namespace SnowEngine
+{
+	class VkGeometryPool : public GeometryPool
+	{
+	public:
+		VkGeometryPool(u32 vertexCapacity, u32 indexCapacity);
+
+		b8 Allocate(const Vertex* vertices, u32 vertexCount, const u32* indices, u32 indexCount, GeometryRange& range) override;
+		void Free(const GeometryRange& range) override;
+
+		void Bind(const std::shared_ptr<CommandBuffer>& cmd) const override;
+		void Draw(const GeometryRange& range, const std::shared_ptr<CommandBuffer>& cmd) const override;
+
+	private:
+		VkBuffer mVertexBuffer;
+		VkBuffer mIndexBuffer;
+		FreeListAllocator mVertexAllocator;
+		FreeListAllocator mIndexAllocator;
+	};
+}
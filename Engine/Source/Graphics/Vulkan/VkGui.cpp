@@ -4,15 +4,18 @@
 #include <backends/imgui_impl_vulkan.h>
 #include "VkCore.h"
 #include "VkCommandBuffer.h"
+#include "VkSamplerCache.h"
 
 namespace SnowEngine
 {
+	//the scene is shown at about its own resolution, so neither mips nor anisotropy are of any use
+	static constexpr SamplerDesc sSceneSampler{ SamplerFilter::Linear, SamplerFilter::Nearest, SamplerAddressMode::ClampToEdge, SamplerAddressMode::ClampToEdge, SamplerAddressMode::ClampToEdge, 1.0f, 0.0f, 0.0f };
+
 	VkGui::VkGui(std::shared_ptr<const VkSurface> surface, std::shared_ptr<VkRenderPass> scene)
 		: mRenderPass{ surface, false }, mSurface{ std::move(surface) }, mScene{ std::move(scene) }
 	{
 		CreateDescriptorPool();
 		InitImGui();
-		CreateSampler();
 
 		mSceneImages.resize(mScene->Images().size());
 		for (u32 i = 0; i < mScene->Images().size(); i++)
@@ -54,7 +57,17 @@ namespace SnowEngine
 				});
 			}
 			else
-			 ImGui::Image(mSceneImages[mSurface->CurrentFrame()], ImGui::GetContentRegionAvail());
+			{
+				//the scene covers only the top left of its target when rendered at a lower scale, that region is stretched
+				//over the panel by the linear sampler and the uvs stop half a texel short of the texels left stale
+				const auto edge = [](const u32 rendered, const u32 size)
+				{
+					return rendered < size ? (static_cast<f32>(rendered) - 0.5f) / static_cast<f32>(size) : 1.0f;
+				};
+				const ImVec2 uv{ edge(mScene->RenderWidth(), mScene->Width()), edge(mScene->RenderHeight(), mScene->Height()) };
+
+				ImGui::Image(mSceneImages[mSurface->CurrentFrame()], ImGui::GetContentRegionAvail(), { 0.0f, 0.0f }, uv);
+			}
 		}
 		ImGui::PopStyleVar(1);
 
@@ -92,26 +105,6 @@ namespace SnowEngine
 		mDescriptorPool = VkCore::Get()->Device().createDescriptorPool(createInfo);
 	}
 
-	void VkGui::CreateSampler()
-	{
-		vk::SamplerCreateInfo createInfo{};
-		createInfo.magFilter = vk::Filter::eLinear;
-		createInfo.minFilter = vk::Filter::eLinear;
-		createInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
-		createInfo.addressModeV = vk::SamplerAddressMode::eRepeat;
-		createInfo.addressModeW = vk::SamplerAddressMode::eRepeat;
-		createInfo.mipLodBias = 0.0f;
-		createInfo.anisotropyEnable = VK_FALSE;
-		createInfo.maxAnisotropy = 1.0f;
-		createInfo.compareEnable = VK_FALSE;
-		createInfo.compareOp = vk::CompareOp::eAlways;
-		createInfo.minLod = 0.0f;
-		createInfo.maxLod = 1.0f;
-		createInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
-
-		mSampler = VkCore::Get()->Device().createSampler(createInfo);
-	}
-
 	void VkGui::InitImGui() const
 	{
 		ImGui::CreateContext();
@@ -146,6 +139,6 @@ namespace SnowEngine
 
 	void VkGui::CreateSceneImage(const VkImage& image, const u32 frameIndex)
 	{
-		mSceneImages[frameIndex] = ImGui_ImplVulkan_AddTexture(mSampler, image.View(), static_cast<VkImageLayout>(image.Layout()));
+		mSceneImages[frameIndex] = ImGui_ImplVulkan_AddTexture(VkCore::Get()->SamplerCache().Sampler(sSceneSampler), image.View(), static_cast<VkImageLayout>(image.Layout()));
 	}
 }
@@ -19,7 +19,6 @@ namespace SnowEngine
 
 	private:
 		void CreateDescriptorPool();
-		void CreateSampler();
 		void InitImGui() const;
 		void CreateSceneImage(const VkImage& image, u32 frameIndex);
 
@@ -28,6 +27,5 @@ namespace SnowEngine
 		std::shared_ptr<const VkSurface> mSurface;
 		std::shared_ptr<VkRenderPass> mScene;
 		std::vector<ImTextureID> mSceneImages;
-		vk::Sampler mSampler;
 	};
 }
@@ -27,21 +27,85 @@ namespace SnowEngine
 	}
 
 	VkImage::VkImage(const u32 width, const u32 height, const vk::Format format, const vk::ImageUsageFlags usage, const vk::ImageLayout layout, const vk::ImageAspectFlags aspect)
-		: mFormat{ format }
+		: mFormat{ format }, mAspect{ aspect }
 	{
 		CreateImage(width, height, usage, layout);
 		CreateView(aspect);
 	}
 
+	/**
+	 * \brief Creates an image without memory, it is usable once BindMemory is called.
+	 * Used for transient images that share an allocation with other images.
+	 */
+	VkImage::VkImage(const u32 width, const u32 height, const vk::Format format, const vk::ImageUsageFlags usage, const vk::ImageAspectFlags aspect)
+		: mFormat{ format }, mAspect{ aspect }, mOwnsMemory{ false }
+	{
+		vk::ImageCreateInfo createInfo{};
+		createInfo.imageType = vk::ImageType::e2D;
+		createInfo.extent = vk::Extent3D{ width, height, 1 };
+		createInfo.mipLevels = 1;
+		createInfo.arrayLayers = 1;
+		createInfo.format = mFormat;
+		createInfo.tiling = vk::ImageTiling::eOptimal;
+		createInfo.initialLayout = vk::ImageLayout::eUndefined;
+		createInfo.usage = usage;
+		createInfo.sharingMode = vk::SharingMode::eExclusive;
+		createInfo.samples = vk::SampleCountFlagBits::e1;
+
+		mImage = VkCore::Get()->Device().createImage(createInfo);
+	}
+
 	VkImage::~VkImage()
 	{
-		vmaDestroyImage(VkCore::Get()->Allocator(), mImage, mAllocation);
+		if (mView)
+			VkCore::Get()->Device().destroyImageView(mView);
+
+		if (mOwnsMemory)
+			vmaDestroyImage(VkCore::Get()->Allocator(), mImage, mAllocation);
+		else
+			VkCore::Get()->Device().destroyImage(mImage);
 	}
 
 	vk::ImageLayout VkImage::Layout() const { return mLayout; }
 
 	vk::ImageView VkImage::View() const { return mView; }
 
+	vk::MemoryRequirements VkImage::MemoryRequirements() const { return VkCore::Get()->Device().getImageMemoryRequirements(mImage); }
+
+	void VkImage::BindMemory(const VmaAllocation memory)
+	{
+		vmaBindImageMemory(VkCore::Get()->Allocator(), memory, mImage);
+		CreateView(mAspect);
+	}
+
+	/**
+	 * \brief Records the layout the image was left in by commands the image does not see, e.g. a render pass final layout.
+	 */
+	void VkImage::SetLayout(const vk::ImageLayout layout) { mLayout = layout; }
+
+	/**
+	 * \brief Fills the layout and subresource part of a barrier to newLayout, access masks are left to the caller.
+	 * \param discard The current contents are not needed, the transition starts from an undefined layout.
+	 */
+	vk::ImageMemoryBarrier VkImage::TransitionBarrier(const vk::ImageLayout newLayout, const b8 discard)
+	{
+		vk::ImageMemoryBarrier barrier{};
+		barrier.oldLayout = discard ? vk::ImageLayout::eUndefined : mLayout;
+		barrier.newLayout = newLayout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = mImage;
+		barrier.subresourceRange.aspectMask = mAspect;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = mArrayLayers;
+
+		mLayout = newLayout;
+
+		return barrier;
+	}
+
 	void VkImage::CreateImage(const u32 width, const u32 height, const vk::ImageUsageFlags usage, const vk::ImageLayout layout, const u32 arrayLayers)
 	{
 		vk::ImageCreateInfo createInfo{};
@@ -66,7 +130,9 @@ namespace SnowEngine
 
 		auto res = vmaCreateImage(VkCore::Get()->Allocator(), reinterpret_cast<VkImageCreateInfo*>(&createInfo), &allocInfo, reinterpret_cast<::VkImage*>(&mImage), &mAllocation, nullptr);
 
-		ChangeLayout(layout, arrayLayers);
+		mArrayLayers = arrayLayers;
+		if (layout != mLayout)
+			ChangeLayout(layout, arrayLayers);
 	}
 
 	void VkImage::CreateImage(const std::vector<std::filesystem::path>& sources)
@@ -86,10 +152,13 @@ namespace SnowEngine
 		}
 
 		mFormat = vk::Format::eR8G8B8A8Srgb;
-		CreateImage(width, height, vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled, vk::ImageLayout::eTransferDstOptimal, sources.size());
+		CreateImage(width, height, vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled, vk::ImageLayout::eUndefined, sources.size());
 
+		//both transitions and the copies share one submission
 		VkCore::Get()->SubmitInstantCommand([&](const vk::CommandBuffer cmd)
 		{
+			ChangeLayout(vk::ImageLayout::eTransferDstOptimal, sources.size(), cmd);
+
 			for (u32 i{ 0 }; i < sources.size(); i++)
 			{
 				vk::BufferImageCopy region{};
@@ -105,13 +174,15 @@ namespace SnowEngine
 
 				cmd.copyBufferToImage(buffers[i].Buffer(), mImage, vk::ImageLayout::eTransferDstOptimal, region);
 			}
-		});
 
-		ChangeLayout(vk::ImageLayout::eShaderReadOnlyOptimal, sources.size());
+			ChangeLayout(vk::ImageLayout::eShaderReadOnlyOptimal, sources.size(), cmd);
+		});
 	}
 
 	void VkImage::CreateView(const vk::ImageAspectFlags aspect, const u32 arrayLayers)
 	{
+		mAspect = aspect;
+
 		vk::ImageViewCreateInfo createInfo{};
 		createInfo.image = mImage;
 		createInfo.viewType = arrayLayers == 6 ? vk::ImageViewType::eCube : vk::ImageViewType::e2D;//TODO: argument
@@ -125,7 +196,10 @@ namespace SnowEngine
 		mView = VkCore::Get()->Device().createImageView(createInfo);
 	}
 
-	void VkImage::ChangeLayout(const vk::ImageLayout newLayout, const u32 arrayLayers)
+	/**
+	 * \brief Transitions the image, recording into cmd when given, otherwise with its own blocking submission.
+	 */
+	void VkImage::ChangeLayout(const vk::ImageLayout newLayout, const u32 arrayLayers, const vk::CommandBuffer cmd)
 	{
 		vk::ImageMemoryBarrier barrier{};
 		barrier.oldLayout = mLayout;
@@ -156,7 +230,7 @@ namespace SnowEngine
 			barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
 			destinationStage = vk::PipelineStageFlagBits::eFragmentShader;
 
-			barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+			barrier.subresourceRange.aspectMask = mAspect; //sampled depth images end up here as well
 		}
 		else if (newLayout == vk::ImageLayout::eTransferDstOptimal) {
 			barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
@@ -171,10 +245,17 @@ namespace SnowEngine
 			barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eDepth;
 		}
 
-		VkCore::Get()->SubmitInstantCommand([&](const vk::CommandBuffer cmd) 
+		if (cmd)
 		{
 			cmd.pipelineBarrier(sourceStage, destinationStage, {}, 0, nullptr, 0, nullptr, 1, &barrier);
-		});
+		}
+		else
+		{
+			VkCore::Get()->SubmitInstantCommand([&](const vk::CommandBuffer instantCmd)
+			{
+				instantCmd.pipelineBarrier(sourceStage, destinationStage, {}, 0, nullptr, 0, nullptr, 1, &barrier);
+			});
+		}
 
 		mLayout = newLayout;
 	}
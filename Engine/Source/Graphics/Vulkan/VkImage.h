@@ -14,21 +14,30 @@ namespace SnowEngine
 		VkImage(const std::filesystem::path& source);
 		VkImage(const std::array<std::filesystem::path, 6>& sources);
 		VkImage(u32 width, u32 height, vk::Format format, vk::ImageUsageFlags usage, vk::ImageLayout layout, vk::ImageAspectFlags aspect);
+		VkImage(u32 width, u32 height, vk::Format format, vk::ImageUsageFlags usage, vk::ImageAspectFlags aspect);
 		~VkImage() override;
 
 		vk::ImageLayout Layout() const;
 		vk::ImageView View() const;
+		vk::MemoryRequirements MemoryRequirements() const;
+
+		void BindMemory(VmaAllocation memory);
+		void SetLayout(vk::ImageLayout layout);
+		vk::ImageMemoryBarrier TransitionBarrier(vk::ImageLayout newLayout, b8 discard);
 
 	private:
 		void CreateImage(u32 width, u32 height, vk::ImageUsageFlags usage, vk::ImageLayout layout, u32 arrayLayers = 1);
 		void CreateImage(const std::vector<std::filesystem::path>& sources);
 		void CreateView(vk::ImageAspectFlags aspect, u32 arrayLayers = 1);
-		void ChangeLayout(vk::ImageLayout newLayout, u32 arrayLayers);
+		void ChangeLayout(vk::ImageLayout newLayout, u32 arrayLayers, vk::CommandBuffer cmd = nullptr);
 
 		vk::ImageLayout mLayout{ vk::ImageLayout::eUndefined };
 		vk::Format mFormat;
 		vk::Image mImage;
 		vk::ImageView mView;
-		VmaAllocation mAllocation;
+		VmaAllocation mAllocation{ nullptr };
+		vk::ImageAspectFlags mAspect{ vk::ImageAspectFlagBits::eColor };
+		u32 mArrayLayers{ 1 };
+		b8 mOwnsMemory{ true };
 	};
 }
@@ -0,0 +1,134 @@
+#include "VkLayoutCache.h"
+
+#include "VkCore.h"
+#include "Core/Hash.h"
+
+namespace SnowEngine
+{
+	static b8 SameBindings(const std::vector<vk::DescriptorSetLayoutBinding>& a, const std::vector<vk::DescriptorSetLayoutBinding>& b)
+	{
+		if (a.size() != b.size())
+			return false;
+
+		for (u64 i{ 0 }; i < a.size(); i++)
+		{
+			if (a[i].binding != b[i].binding || a[i].descriptorType != b[i].descriptorType || a[i].descriptorCount != b[i].descriptorCount || a[i].stageFlags != b[i].stageFlags)
+				return false;
+		}
+
+		return true;
+	}
+
+	VkLayoutCache::~VkLayoutCache()
+	{
+		const vk::Device device{ VkCore::Get()->Device() };
+
+		for (const auto& [hash, entries] : mPipelineLayouts)
+		{
+			for (const auto& entry : entries)
+				device.destroyPipelineLayout(entry.Layout);
+		}
+
+		for (const auto& [hash, entries] : mSetLayouts)
+		{
+			for (const auto& entry : entries)
+				device.destroyDescriptorSetLayout(entry.Layout);
+		}
+	}
+
+	vk::DescriptorSetLayout VkLayoutCache::SetLayout(const std::vector<vk::DescriptorSetLayoutBinding>& bindings)
+	{
+		std::lock_guard lock{ mMutex };
+
+		auto& entries{ mSetLayouts[Hash(bindings)] };
+		for (const auto& entry : entries)
+		{
+			if (SameBindings(entry.Bindings, bindings))
+				return entry.Layout;
+		}
+
+		vk::DescriptorSetLayoutCreateInfo createInfo{};
+		createInfo.bindingCount = static_cast<u32>(bindings.size());
+		createInfo.pBindings = bindings.data();
+
+		const vk::DescriptorSetLayout layout{ VkCore::Get()->Device().createDescriptorSetLayout(createInfo) };
+		entries.push_back({ bindings, layout });
+
+		return layout;
+	}
+
+	vk::PipelineLayout VkLayoutCache::PipelineLayout(const std::vector<vk::DescriptorSetLayout>& setLayouts, const vk::PushConstantRange& pushConstants)
+	{
+		std::lock_guard lock{ mMutex };
+
+		auto& entries{ mPipelineLayouts[Hash(setLayouts, pushConstants)] };
+		for (const auto& entry : entries)
+		{
+			if (entry.SetLayouts == setLayouts && entry.PushConstants == pushConstants)
+				return entry.Layout;
+		}
+
+		vk::PipelineLayoutCreateInfo createInfo;
+		createInfo.setLayoutCount = static_cast<u32>(setLayouts.size());
+		createInfo.pSetLayouts = setLayouts.data();
+		createInfo.pushConstantRangeCount = pushConstants.size ? 1 : 0;
+		createInfo.pPushConstantRanges = &pushConstants;
+
+		const vk::PipelineLayout layout{ VkCore::Get()->Device().createPipelineLayout(createInfo) };
+		entries.push_back({ setLayouts, pushConstants, layout });
+
+		return layout;
+	}
+
+	u32 VkLayoutCache::SetLayoutCount() const
+	{
+		std::lock_guard lock{ mMutex };
+
+		u32 count{ 0 };
+		for (const auto& [hash, entries] : mSetLayouts)
+			count += static_cast<u32>(entries.size());
+
+		return count;
+	}
+
+	u32 VkLayoutCache::PipelineLayoutCount() const
+	{
+		std::lock_guard lock{ mMutex };
+
+		u32 count{ 0 };
+		for (const auto& [hash, entries] : mPipelineLayouts)
+			count += static_cast<u32>(entries.size());
+
+		return count;
+	}
+
+	/**
+	 * \brief FNV-1a over the bindings, immutable samplers are not used by the engine and are left out.
+	 */
+	u64 VkLayoutCache::Hash(const std::vector<vk::DescriptorSetLayoutBinding>& bindings)
+	{
+		Hasher hash;
+		for (const auto& binding : bindings)
+		{
+			hash.Mix(binding.binding);
+			hash.Mix(binding.descriptorType);
+			hash.Mix(binding.descriptorCount);
+			hash.Mix(static_cast<u32>(binding.stageFlags));
+		}
+
+		return hash.Get();
+	}
+
+	u64 VkLayoutCache::Hash(const std::vector<vk::DescriptorSetLayout>& setLayouts, const vk::PushConstantRange& pushConstants)
+	{
+		Hasher hash;
+		for (const auto setLayout : setLayouts)
+			hash.Mix(static_cast<::VkDescriptorSetLayout>(setLayout));
+
+		hash.Mix(static_cast<u32>(pushConstants.stageFlags));
+		hash.Mix(pushConstants.offset);
+		hash.Mix(pushConstants.size);
+
+		return hash.Get();
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "Core/Types.h"
+
+namespace SnowEngine
+{
+	/**
+	 * \brief Descriptor set layouts and pipeline layouts shared by every user asking for an identical one, hashed by
+	 * their bindings, set layouts and push constants. The layouts live as long as the cache, so handles compare equal
+	 * exactly when the layouts are identical.
+	 */
+	class VkLayoutCache
+	{
+	public:
+		VkLayoutCache() = default;
+		~VkLayoutCache();
+
+		VkLayoutCache(const VkLayoutCache&) = delete;
+		VkLayoutCache& operator=(const VkLayoutCache&) = delete;
+
+		vk::DescriptorSetLayout SetLayout(const std::vector<vk::DescriptorSetLayoutBinding>& bindings);
+		/** \param pushConstants A zero size range means no push constants. */
+		vk::PipelineLayout PipelineLayout(const std::vector<vk::DescriptorSetLayout>& setLayouts, const vk::PushConstantRange& pushConstants);
+
+		u32 SetLayoutCount() const;
+		u32 PipelineLayoutCount() const;
+
+	private:
+		struct SetLayoutEntry
+		{
+			std::vector<vk::DescriptorSetLayoutBinding> Bindings;
+			vk::DescriptorSetLayout Layout;
+		};
+
+		struct PipelineLayoutEntry
+		{
+			std::vector<vk::DescriptorSetLayout> SetLayouts;
+			vk::PushConstantRange PushConstants;
+			vk::PipelineLayout Layout;
+		};
+
+		static u64 Hash(const std::vector<vk::DescriptorSetLayoutBinding>& bindings);
+		static u64 Hash(const std::vector<vk::DescriptorSetLayout>& setLayouts, const vk::PushConstantRange& pushConstants);
+
+		std::unordered_map<u64, std::vector<SetLayoutEntry>> mSetLayouts;
+		std::unordered_map<u64, std::vector<PipelineLayoutEntry>> mPipelineLayouts;
+		mutable std::mutex mMutex; //pipelines are created on the thread pool
+	};
+}
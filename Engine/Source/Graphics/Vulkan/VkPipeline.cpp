@@ -1,6 +1,8 @@
 #include "VkPipeline.h"
 
 #include "VkCore.h"
+#include "VkLayoutCache.h"
+#include "VkPipelineCache.h"
 #include "VkBuffers.h"
 #include "VkDescriptorSet.h"
 #include "VkCommandBuffer.h"
@@ -14,6 +16,12 @@ namespace SnowEngine
 		CreateFixedFunctions(settings);
 	}
 
+	VkPipeline::~VkPipeline()
+	{
+		//the layout is shared through the layout cache
+		VkCore::Get()->Device().destroyPipeline(mPipeline);
+	}
+
 	void VkPipeline::Bind(const std::shared_ptr<CommandBuffer>& cmd) const
 	{
 		const auto& vkCmd = std::static_pointer_cast<VkCommandBuffer>(cmd);
@@ -26,23 +34,47 @@ namespace SnowEngine
 		const auto& vkCmd = std::static_pointer_cast<VkCommandBuffer>(cmd);
 
 		const auto vkDescriptorSet{ reinterpret_cast<const VkDescriptorSet*>(set) };
-		vkCmd->CurrentBuffer().bindDescriptorSets(vk::PipelineBindPoint::eGraphics, mLayout, vkDescriptorSet->SetIndex(), vkDescriptorSet->Sets().at(currentFrame), nullptr);
+		if (vkDescriptorSet->Sets().empty())
+			return;
+
+		vkCmd->CurrentBuffer().bindDescriptorSets(vk::PipelineBindPoint::eGraphics, mLayout, vkDescriptorSet->SetIndex(), vkDescriptorSet->Set(currentFrame), vkDescriptorSet->DynamicOffsets(currentFrame));
+	}
+
+	/**
+	 * \brief Layouts are compatible for a set when the push constants and every set layout up to it are identical, the
+	 * cached layouts make that a comparison of handles.
+	 */
+	u32 VkPipeline::CompatibleSets(const Pipeline* other) const
+	{
+		const auto vkOther{ static_cast<const VkPipeline*>(other) };
+		if (vkOther->mLayout == mLayout)
+			return static_cast<u32>(mSetLayouts.size());
+
+		if (vkOther->mShader->PushConstants() != mShader->PushConstants())
+			return 0;
+
+		u32 count{ 0 };
+		while (count < mSetLayouts.size() && count < vkOther->mSetLayouts.size() && mSetLayouts[count] == vkOther->mSetLayouts[count])
+			count++;
+
+		return count;
+	}
+
+	void VkPipeline::PushConstants(const void* data, const u32 size, const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		const auto& vkCmd = std::static_pointer_cast<VkCommandBuffer>(cmd);
+
+		const auto& range{ mShader->PushConstants() };
+		vkCmd->CurrentBuffer().pushConstants(mLayout, range.stageFlags, range.offset, std::min(size, range.size), data);
 	}
 
 	void VkPipeline::CreateLayout()
 	{
-		std::vector<vk::DescriptorSetLayout> layouts{};
-		layouts.reserve(mShader->Layouts().size());
+		mSetLayouts.reserve(mShader->Layouts().size());
 		for (const auto& [set, layout] : mShader->Layouts())
-			layouts.emplace_back(layout.CreateLayout());
+			mSetLayouts.emplace_back(layout.Layout());
 
-		vk::PipelineLayoutCreateInfo createInfo;
-		createInfo.setLayoutCount = static_cast<u32>(layouts.size());
-		createInfo.pSetLayouts = layouts.data();
-		createInfo.pushConstantRangeCount = 0;
-		createInfo.pPushConstantRanges = nullptr;
-
-		mLayout = VkCore::Get()->Device().createPipelineLayout(createInfo);
+		mLayout = VkCore::Get()->LayoutCache().PipelineLayout(mSetLayouts, mShader->PushConstants());
 	}
 
 	void VkPipeline::CreateFixedFunctions(const PipelineSettings& settings)
@@ -57,13 +89,16 @@ namespace SnowEngine
 		const auto attributeDescriptions{ VkVertexBuffer::AttributeDescriptions() };
 
 		vk::PipelineVertexInputStateCreateInfo vertexInputInfo;
-		vertexInputInfo.vertexBindingDescriptionCount = 1;
-		vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-		vertexInputInfo.vertexAttributeDescriptionCount = static_cast<u32>(attributeDescriptions.size());
-		vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+		if (settings.VertexInput)
+		{
+			vertexInputInfo.vertexBindingDescriptionCount = 1;
+			vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+			vertexInputInfo.vertexAttributeDescriptionCount = static_cast<u32>(attributeDescriptions.size());
+			vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+		}
 
 		vk::PipelineInputAssemblyStateCreateInfo inputAssemblyInfo;
-		inputAssemblyInfo.topology = vk::PrimitiveTopology::eTriangleList;
+		inputAssemblyInfo.topology = GetTopology(settings.Topology);
 		inputAssemblyInfo.primitiveRestartEnable = false;
 
 		vk::Viewport viewport;
@@ -91,10 +126,10 @@ namespace SnowEngine
 		rasterizerInfo.lineWidth = 1.0f;
 		rasterizerInfo.cullMode = settings.BackfaceCulling ? vk::CullModeFlagBits::eBack : vk::CullModeFlagBits::eNone;
 		rasterizerInfo.frontFace = vk::FrontFace::eCounterClockwise;
-		rasterizerInfo.depthBiasEnable = false;
-		rasterizerInfo.depthBiasConstantFactor = 0.0f;
+		rasterizerInfo.depthBiasEnable = settings.DepthBiasConstant != 0.0f || settings.DepthBiasSlope != 0.0f;
+		rasterizerInfo.depthBiasConstantFactor = settings.DepthBiasConstant;
 		rasterizerInfo.depthBiasClamp = 0.0f;
-		rasterizerInfo.depthBiasSlopeFactor = 0.0f;
+		rasterizerInfo.depthBiasSlopeFactor = settings.DepthBiasSlope;
 
 		vk::PipelineMultisampleStateCreateInfo multisampleInfo;
 		multisampleInfo.sampleShadingEnable = false;
@@ -105,20 +140,20 @@ namespace SnowEngine
 		multisampleInfo.alphaToOneEnable = false;
 
 		vk::PipelineColorBlendAttachmentState colorBlendAttachment;
-		colorBlendAttachment.colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
-											  vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
-		colorBlendAttachment.blendEnable = false;
-		colorBlendAttachment.srcColorBlendFactor = vk::BlendFactor::eOne;
-		colorBlendAttachment.dstColorBlendFactor = vk::BlendFactor::eZero;
+		colorBlendAttachment.colorWriteMask = settings.ColorWrite ? vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+																	vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA : vk::ColorComponentFlags{};
+		colorBlendAttachment.blendEnable = settings.Blend != BlendMode::None;
+		colorBlendAttachment.srcColorBlendFactor = settings.Blend != BlendMode::None ? vk::BlendFactor::eSrcAlpha : vk::BlendFactor::eOne;
+		colorBlendAttachment.dstColorBlendFactor = settings.Blend == BlendMode::Alpha ? vk::BlendFactor::eOneMinusSrcAlpha : settings.Blend == BlendMode::Additive ? vk::BlendFactor::eOne : vk::BlendFactor::eZero;
 		colorBlendAttachment.colorBlendOp = vk::BlendOp::eAdd;
 		colorBlendAttachment.srcAlphaBlendFactor = vk::BlendFactor::eOne;
-		colorBlendAttachment.dstAlphaBlendFactor = vk::BlendFactor::eZero;
+		colorBlendAttachment.dstAlphaBlendFactor = colorBlendAttachment.dstColorBlendFactor;
 		colorBlendAttachment.alphaBlendOp = vk::BlendOp::eAdd;
 
 		vk::PipelineColorBlendStateCreateInfo colorBlendInfo;
 		colorBlendInfo.logicOpEnable = false;
 		colorBlendInfo.logicOp = vk::LogicOp::eCopy;
-		colorBlendInfo.attachmentCount = 1;
+		colorBlendInfo.attachmentCount = mRenderPass->HasColor() ? 1 : 0;
 		colorBlendInfo.pAttachments = &colorBlendAttachment;
 		colorBlendInfo.blendConstants[0] = 0.0f;
 		colorBlendInfo.blendConstants[1] = 0.0f;
@@ -128,11 +163,16 @@ namespace SnowEngine
 		vk::PipelineDepthStencilStateCreateInfo depthStencilInfo;
 		depthStencilInfo.depthTestEnable = settings.DepthTest;
 		depthStencilInfo.depthWriteEnable = settings.DepthWrite;
-		depthStencilInfo.depthCompareOp = vk::CompareOp::eLess;
+		depthStencilInfo.depthCompareOp = GetCompareOp(settings.DepthCompare);
 		depthStencilInfo.depthBoundsTestEnable = false;
 		depthStencilInfo.stencilTestEnable = false;
 		
-		const auto shaderStages = mShader->ShaderStageInfos();
+		auto shaderStages = mShader->ShaderStageInfos();
+
+		//without color writes the fragment shader has nothing to output, the layout still matches the full shader so
+		//the same descriptor sets bind to both pipelines
+		if (!settings.ColorWrite)
+			std::erase_if(shaderStages, [](const vk::PipelineShaderStageCreateInfo& info) { return info.stage == vk::ShaderStageFlagBits::eFragment; });
 
 		vk::GraphicsPipelineCreateInfo createInfo;
 		createInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
@@ -151,7 +191,47 @@ namespace SnowEngine
 		createInfo.basePipelineHandle = nullptr;
 		createInfo.basePipelineIndex = -1;
 
-		mPipeline = VkCore::Get()->Device().createGraphicsPipeline(nullptr, createInfo).value;
+		mPipeline = VkCore::Get()->PipelineCache().CreatePipeline(createInfo);
+	}
+
+	vk::CompareOp VkPipeline::GetCompareOp(const CompareOp op)
+	{
+		switch (op)
+		{
+		case CompareOp::Never:
+			return vk::CompareOp::eNever;
+		case CompareOp::Less:
+			return vk::CompareOp::eLess;
+		case CompareOp::Equal:
+			return vk::CompareOp::eEqual;
+		case CompareOp::LessOrEqual:
+			return vk::CompareOp::eLessOrEqual;
+		case CompareOp::Greater:
+			return vk::CompareOp::eGreater;
+		case CompareOp::NotEqual:
+			return vk::CompareOp::eNotEqual;
+		case CompareOp::GreaterOrEqual:
+			return vk::CompareOp::eGreaterOrEqual;
+		case CompareOp::Always:
+			return vk::CompareOp::eAlways;
+		}
+
+		return vk::CompareOp::eLess;
+	}
+
+	vk::PrimitiveTopology VkPipeline::GetTopology(const PrimitiveTopology topology)
+	{
+		switch (topology)
+		{
+		case PrimitiveTopology::TriangleList:
+			return vk::PrimitiveTopology::eTriangleList;
+		case PrimitiveTopology::LineList:
+			return vk::PrimitiveTopology::eLineList;
+		case PrimitiveTopology::PointList:
+			return vk::PrimitiveTopology::ePointList;
+		}
+
+		return vk::PrimitiveTopology::eTriangleList;
 	}
 
 	VkComputePipeline::VkComputePipeline(std::shared_ptr<const VkShader> shader)
@@ -161,6 +241,12 @@ namespace SnowEngine
 		CreatePipeline();
 	}
 
+	VkComputePipeline::~VkComputePipeline()
+	{
+		//the layout is shared through the layout cache
+		VkCore::Get()->Device().destroyPipeline(mPipeline);
+	}
+
 	void VkComputePipeline::Dispatch(const u32 x, const u32 y, const u32 z, const std::shared_ptr<CommandBuffer>& cmd) const
 	{
 		const auto& vkCmd = std::static_pointer_cast<VkCommandBuffer>(cmd);
@@ -169,28 +255,41 @@ namespace SnowEngine
 		vkCmd->CurrentBuffer().dispatch(x, y, z);
 	}
 
+	void VkComputePipeline::DispatchIndirect(const std::shared_ptr<StorageBuffer>& arguments, const u32 offset, const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		const auto& vkCmd = std::static_pointer_cast<VkCommandBuffer>(cmd);
+		const auto& vkArguments = std::static_pointer_cast<VkStorageBuffer>(arguments);
+
+		vkCmd->CurrentBuffer().bindPipeline(vk::PipelineBindPoint::eCompute, mPipeline);
+		vkCmd->CurrentBuffer().dispatchIndirect(vkArguments->Buffers()->Buffer(), offset);
+	}
+
 	void VkComputePipeline::BindDescriptorSet(const DescriptorSet* set, const u32 currentFrame, const std::shared_ptr<CommandBuffer>& cmd) const
 	{
 		const auto& vkCmd = std::static_pointer_cast<VkCommandBuffer>(cmd);
 
 		const auto vkDescriptorSet{ reinterpret_cast<const VkDescriptorSet*>(set) };
-		vkCmd->CurrentBuffer().bindDescriptorSets(vk::PipelineBindPoint::eCompute, mLayout, vkDescriptorSet->SetIndex(), vkDescriptorSet->Sets().at(currentFrame), nullptr);
+		if (vkDescriptorSet->Sets().empty())
+			return;
+
+		vkCmd->CurrentBuffer().bindDescriptorSets(vk::PipelineBindPoint::eCompute, mLayout, vkDescriptorSet->SetIndex(), vkDescriptorSet->Set(currentFrame), vkDescriptorSet->DynamicOffsets(currentFrame));
+	}
+
+	void VkComputePipeline::PushConstants(const void* data, const u32 size, const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		const auto& vkCmd = std::static_pointer_cast<VkCommandBuffer>(cmd);
+
+		const auto& range{ mShader->PushConstants() };
+		vkCmd->CurrentBuffer().pushConstants(mLayout, range.stageFlags, range.offset, std::min(size, range.size), data);
 	}
 
 	void VkComputePipeline::CreateLayout()
 	{
-		std::vector<vk::DescriptorSetLayout> layouts{};
-		layouts.reserve(mShader->Layouts().size());
+		mSetLayouts.reserve(mShader->Layouts().size());
 		for (const auto& [set, layout] : mShader->Layouts())
-			layouts.emplace_back(layout.CreateLayout());
-
-		vk::PipelineLayoutCreateInfo createInfo;
-		createInfo.setLayoutCount = static_cast<u32>(layouts.size());
-		createInfo.pSetLayouts = layouts.data();
-		createInfo.pushConstantRangeCount = 0;
-		createInfo.pPushConstantRanges = nullptr;
+			mSetLayouts.emplace_back(layout.Layout());
 
-		mLayout = VkCore::Get()->Device().createPipelineLayout(createInfo);
+		mLayout = VkCore::Get()->LayoutCache().PipelineLayout(mSetLayouts, mShader->PushConstants());
 	}
 
 	void VkComputePipeline::CreatePipeline()
@@ -199,6 +298,6 @@ namespace SnowEngine
 		pipelineInfo.layout = mLayout;
 		pipelineInfo.stage = mShader->ShaderStageInfos().front();
 
-		mPipeline = VkCore::Get()->Device().createComputePipeline(nullptr, pipelineInfo).value;
+		mPipeline = VkCore::Get()->PipelineCache().CreatePipeline(pipelineInfo);
 	}
 }
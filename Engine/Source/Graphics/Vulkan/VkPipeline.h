@@ -9,16 +9,23 @@ namespace SnowEngine
 	{
 	public:
 		VkPipeline(const PipelineSettings& settings);
+		~VkPipeline() override;
 
 		void Bind(const std::shared_ptr<CommandBuffer>& cmd) const override;
 		void BindDescriptorSet(const DescriptorSet* set, u32 currentFrame, const std::shared_ptr<CommandBuffer>& cmd) const override;
+		void PushConstants(const void* data, u32 size, const std::shared_ptr<CommandBuffer>& cmd) const override;
+		u32 CompatibleSets(const Pipeline* other) const override;
 
 	private:
+		static vk::CompareOp GetCompareOp(CompareOp op);
+		static vk::PrimitiveTopology GetTopology(PrimitiveTopology topology);
+
 		void CreateLayout();
 		void CreateFixedFunctions(const PipelineSettings& settings);
 
 		std::shared_ptr<const VkShader> mShader;
 		std::shared_ptr<const VkRenderPass> mRenderPass;
+		std::vector<vk::DescriptorSetLayout> mSetLayouts;
 		vk::PipelineLayout mLayout;
 		vk::Pipeline mPipeline;
 	};
@@ -27,15 +34,19 @@ namespace SnowEngine
 	{
 	public:
 		VkComputePipeline(std::shared_ptr<const VkShader> shader);
+		~VkComputePipeline() override;
 
 		void Dispatch(u32 x, u32 y, u32 z, const std::shared_ptr<CommandBuffer>& cmd) const override;
+		void DispatchIndirect(const std::shared_ptr<StorageBuffer>& arguments, u32 offset, const std::shared_ptr<CommandBuffer>& cmd) const override;
 		void BindDescriptorSet(const DescriptorSet* set, u32 currentFrame, const std::shared_ptr<CommandBuffer>& cmd) const override;
+		void PushConstants(const void* data, u32 size, const std::shared_ptr<CommandBuffer>& cmd) const override;
 
 	private:
 		void CreateLayout();
 		void CreatePipeline();
 
 		std::shared_ptr<const VkShader> mShader;
+		std::vector<vk::DescriptorSetLayout> mSetLayouts;
 		vk::PipelineLayout mLayout;
 		vk::Pipeline mPipeline;
 	};
@@ -0,0 +1,203 @@
+#include "VkPipelineCache.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "Core/Hash.h"
+#include "Core/Logger.h"
+
+namespace SnowEngine
+{
+	VkPipelineCache::VkPipelineCache(const vk::Device device, const vk::PhysicalDeviceProperties& properties, const std::filesystem::path& directory, const b8 creationFeedback)
+		: mDevice{ device }, mProperties{ properties }
+	{
+		mPath = directory / ("pipelines_" + std::to_string(mProperties.vendorID) + "_" + std::to_string(mProperties.deviceID) + "_" + std::to_string(mProperties.driverVersion) + ".bin");
+		mStats.Feedback = creationFeedback;
+
+		const std::vector<u8> data{ Load() };
+		mStats.Loaded = !data.empty();
+
+		vk::PipelineCacheCreateInfo createInfo{};
+		createInfo.initialDataSize = data.size();
+		createInfo.pInitialData = data.data();
+
+		mCache = mDevice.createPipelineCache(createInfo);
+	}
+
+	VkPipelineCache::~VkPipelineCache()
+	{
+		Save();
+
+		SetScratch(false);
+		mDevice.destroyPipelineCache(mCache);
+	}
+
+	vk::Pipeline VkPipelineCache::CreatePipeline(const vk::GraphicsPipelineCreateInfo& createInfo) { return Create(createInfo); }
+
+	vk::Pipeline VkPipelineCache::CreatePipeline(const vk::ComputePipelineCreateInfo& createInfo) { return Create(createInfo); }
+
+	PipelineCacheStats VkPipelineCache::Stats() const
+	{
+		std::lock_guard lock{ mMutex };
+		return mStats;
+	}
+
+	void VkPipelineCache::SetScratch(const b8 scratch)
+	{
+		std::unique_lock lock{ mScratchMutex };
+		if (mScratchCache)
+			mDevice.destroyPipelineCache(mScratchCache);
+
+		mScratchCache = scratch ? mDevice.createPipelineCache({}) : nullptr;
+	}
+
+	/**
+	 * \brief Writes the cache next to a temporary file first, so an interrupted save never leaves a truncated cache.
+	 */
+	void VkPipelineCache::Save() const
+	{
+		const auto data{ mDevice.getPipelineCacheData(mCache) };
+		const std::vector<u8> bytes{ data.begin(), data.end() };
+		if (bytes.empty())
+			return;
+
+		const FileHeader header{ CreateHeader(bytes) };
+
+		std::error_code error{};
+		std::filesystem::create_directories(mPath.parent_path(), error);
+
+		std::filesystem::path temporary{ mPath };
+		temporary += ".tmp";
+
+		{
+			std::ofstream file{ temporary, std::ios::binary | std::ios::trunc };
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+			if (!file)
+			{
+				LOG_WARNING("Failed to write the pipeline cache %s", temporary.string().c_str());
+				return;
+			}
+		}
+
+		std::filesystem::rename(temporary, mPath, error);
+		if (error)
+			LOG_WARNING("Failed to replace the pipeline cache %s", mPath.string().c_str());
+	}
+
+	/**
+	 * \brief Creates the pipeline through the cache, timing it and chaining creation feedback when the device reports
+	 * whether the cache was hit.
+	 */
+	template<typename CreateInfo>
+	vk::Pipeline VkPipelineCache::Create(CreateInfo createInfo)
+	{
+		vk::PipelineCreationFeedbackEXT feedback{};
+		vk::PipelineCreationFeedbackCreateInfoEXT feedbackInfo{};
+		feedbackInfo.pPipelineCreationFeedback = &feedback;
+
+		if (mStats.Feedback)
+		{
+			feedbackInfo.pNext = createInfo.pNext;
+			createInfo.pNext = &feedbackInfo;
+		}
+
+		const auto begin{ std::chrono::steady_clock::now() };
+
+		vk::Pipeline pipeline{};
+		{
+			std::shared_lock scratchLock{ mScratchMutex };
+			const vk::PipelineCache cache{ mScratchCache ? mScratchCache : mCache };
+
+			if constexpr (std::is_same_v<CreateInfo, vk::GraphicsPipelineCreateInfo>)
+				pipeline = mDevice.createGraphicsPipeline(cache, createInfo).value;
+			else
+				pipeline = mDevice.createComputePipeline(cache, createInfo).value;
+		}
+
+		const f64 time{ std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - begin).count() };
+
+		std::lock_guard lock{ mMutex };
+		mStats.Pipelines++;
+		mStats.CreationTime += time;
+		if (feedback.flags & vk::PipelineCreationFeedbackFlagBitsEXT::eValid && feedback.flags & vk::PipelineCreationFeedbackFlagBitsEXT::eApplicationPipelineCacheHit)
+			mStats.Hits++;
+
+		return pipeline;
+	}
+
+	/**
+	 * \brief Reads the cache file of the current device.
+	 * \return The data to create the cache with, empty when there is no file or it does not belong to this device.
+	 */
+	std::vector<u8> VkPipelineCache::Load() const
+	{
+		std::ifstream file{ mPath, std::ios::ate | std::ios::binary };
+		if (!file.is_open())
+			return {};
+
+		const u64 fileSize{ static_cast<u64>(file.tellg()) };
+		if (fileSize < sizeof(FileHeader))
+		{
+			LOG_WARNING("Pipeline cache %s is truncated, starting cold", mPath.string().c_str());
+			return {};
+		}
+
+		FileHeader header{};
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+		const b8 sameDevice{ header.VendorId == mProperties.vendorID && header.DeviceId == mProperties.deviceID && header.DriverVersion == mProperties.driverVersion && std::memcmp(header.CacheUuid, mProperties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0 };
+		if (header.Magic != sMagic || header.Version != sVersion || !sameDevice || header.DataSize != fileSize - sizeof(FileHeader))
+		{
+			LOG_WARNING("Pipeline cache %s was written by another version or device, starting cold", mPath.string().c_str());
+			return {};
+		}
+
+		std::vector<u8> data(header.DataSize);
+		file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+		if (!file || Checksum(data) != header.Checksum)
+		{
+			LOG_WARNING("Pipeline cache %s is damaged, starting cold", mPath.string().c_str());
+			return {};
+		}
+
+		//the driver validates its own header as well, checked here so a rejected cache is reported as cold
+		VkPipelineCacheHeaderVersionOne driverHeader{};
+		if (data.size() < sizeof(driverHeader))
+			return {};
+
+		std::memcpy(&driverHeader, data.data(), sizeof(driverHeader));
+		if (driverHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE || driverHeader.vendorID != mProperties.vendorID || driverHeader.deviceID != mProperties.deviceID || std::memcmp(driverHeader.pipelineCacheUUID, mProperties.pipelineCacheUUID.data(), VK_UUID_SIZE) != 0)
+			return {};
+
+		return data;
+	}
+
+	VkPipelineCache::FileHeader VkPipelineCache::CreateHeader(const std::vector<u8>& data) const
+	{
+		FileHeader header{};
+		header.Magic = sMagic;
+		header.Version = sVersion;
+		header.VendorId = mProperties.vendorID;
+		header.DeviceId = mProperties.deviceID;
+		header.DriverVersion = mProperties.driverVersion;
+		std::memcpy(header.CacheUuid, mProperties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+		header.DataSize = data.size();
+		header.Checksum = Checksum(data);
+
+		return header;
+	}
+
+	u64 VkPipelineCache::Checksum(const std::vector<u8>& data)
+	{
+		Hasher hash;
+		hash.Mix(data.data(), data.size());
+
+		return hash.Get();
+	}
+}
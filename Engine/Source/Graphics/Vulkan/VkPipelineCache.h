@@ -0,0 +1,68 @@
+#pragma once
+#include <filesystem>
+#include <mutex>
+#include <shared_mutex>
+#include <vulkan/vulkan.hpp>
+
+#include "Core/Types.h"
+#include "Graphics/Rhi/Core.h"
+
+namespace SnowEngine
+{
+	/**
+	 * \brief Pipeline cache persisted between runs. The file is named after the vendor, the device and the driver
+	 * version and starts with a header that is validated against the current device before its data is handed to the
+	 * driver, a mismatching or damaged file is ignored and replaced on the next save.
+	 */
+	class VkPipelineCache
+	{
+	public:
+		VkPipelineCache(vk::Device device, const vk::PhysicalDeviceProperties& properties, const std::filesystem::path& directory, b8 creationFeedback);
+		~VkPipelineCache();
+
+		VkPipelineCache(const VkPipelineCache&) = delete;
+		VkPipelineCache& operator=(const VkPipelineCache&) = delete;
+
+		vk::Pipeline CreatePipeline(const vk::GraphicsPipelineCreateInfo& createInfo);
+		vk::Pipeline CreatePipeline(const vk::ComputePipelineCreateInfo& createInfo);
+
+		PipelineCacheStats Stats() const;
+		/**
+		 * \brief Routes creation to an empty cache that is dropped when unset, the persistent one is left untouched.
+		 * Waits for the pipelines being created on other threads, they may still use the previous scratch cache.
+		 */
+		void SetScratch(b8 scratch);
+		void Save() const;
+
+	private:
+		struct FileHeader
+		{
+			u32 Magic;
+			u32 Version;
+			u32 VendorId;
+			u32 DeviceId;
+			u32 DriverVersion;
+			u8 CacheUuid[VK_UUID_SIZE];
+			u64 DataSize;
+			u64 Checksum; //FNV-1a of the data
+		};
+
+		template<typename CreateInfo>
+		vk::Pipeline Create(CreateInfo createInfo);
+		std::vector<u8> Load() const;
+		FileHeader CreateHeader(const std::vector<u8>& data) const;
+		static u64 Checksum(const std::vector<u8>& data);
+
+		vk::Device mDevice;
+		vk::PipelineCache mCache;
+		vk::PipelineCache mScratchCache{ nullptr };
+		vk::PhysicalDeviceProperties mProperties;
+		std::filesystem::path mPath;
+		mutable std::mutex mMutex; //guards the statistics, the cache itself is synchronized by the driver
+		std::shared_mutex mScratchMutex; //held shared for each creation and exclusively while the scratch cache is replaced
+		PipelineCacheStats mStats{};
+
+		static constexpr u32 sMagic{ 0x43505353 }; //"SSPC"
+		static constexpr u32 sVersion{ 1 };
+	};
+}
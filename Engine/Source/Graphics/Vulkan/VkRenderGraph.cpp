@@ -0,0 +1,288 @@
+#include "VkRenderGraph.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "VkBuffers.h"
+#include "VkCommandBuffer.h"
+#include "VkCore.h"
+
+namespace SnowEngine
+{
+	static const vk::AccessFlags sWriteAccess{ vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite | vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eTransferWrite };
+	static const vk::PipelineStageFlags sComputeStages{ vk::PipelineStageFlagBits::eTopOfPipe | vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eBottomOfPipe };
+
+	static u32 UsageBit(const ResourceUsage usage) { return 1u << static_cast<u32>(usage); }
+
+	VkRenderGraph::VkRenderGraph(const u32 frameCount)
+		: RenderGraph{ frameCount }
+	{
+		mFrames.resize(frameCount);
+	}
+
+	VkRenderGraph::~VkRenderGraph()
+	{
+		for (auto& frame : mFrames)
+			ReleaseTransients(frame);
+	}
+
+	/**
+	 * \brief Transient images are kept per frame in flight and only recreated when the compiled graph changes shape.
+	 * Must be called after the fence of currentFrame has been waited on.
+	 */
+	void VkRenderGraph::AllocateTransients(const u32 currentFrame, const std::vector<ResourceNode*>& transients)
+	{
+		auto& frame{ mFrames[currentFrame] };
+
+		std::vector<TransientKey> keys{};
+		keys.reserve(transients.size());
+		for (const auto* transient : transients)
+			keys.push_back({ transient->Desc, transient->Usages, transient->FirstPass, transient->LastPass });
+
+		if (keys != frame.Keys)
+		{
+			ReleaseTransients(frame);
+			frame.Keys = std::move(keys);
+			CreateTransients(frame);
+		}
+
+		for (u32 i{ 0 }; i < transients.size(); i++)
+		{
+			transients[i]->Image = frame.Images[i].get();
+			transients[i]->AliasSlot = frame.Slots[i];
+		}
+
+		mStats.TransientBytes = frame.AllocatedBytes;
+		mStats.UnaliasedBytes = frame.UnaliasedBytes;
+	}
+
+	/**
+	 * \brief Merges every barrier of a pass into a single pipelineBarrier call.
+	 */
+	void VkRenderGraph::RecordBarriers(const std::vector<RenderGraphBarrier>& barriers, const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		const auto& vkCmd = std::static_pointer_cast<VkCommandBuffer>(cmd);
+
+		vk::PipelineStageFlags srcStages{};
+		vk::PipelineStageFlags dstStages{};
+		std::vector<vk::ImageMemoryBarrier> imageBarriers{};
+		std::vector<vk::BufferMemoryBarrier> bufferBarriers{};
+
+		for (const auto& [resource, before, after, discard] : barriers)
+		{
+			const auto& node{ mResources[resource] };
+			const UsageInfo src{ GetUsageInfo(before) };
+			const UsageInfo dst{ GetUsageInfo(after) };
+
+			srcStages |= src.Stage;
+			dstStages |= dst.Stage;
+
+			if (node.Image)
+			{
+				auto& barrier{ imageBarriers.emplace_back(static_cast<VkImage*>(node.Image)->TransitionBarrier(dst.Layout, discard)) };
+				barrier.srcAccessMask = src.Access & sWriteAccess;
+				barrier.dstAccessMask = dst.Access;
+			}
+			else if (node.Buffer)
+			{
+				auto& barrier{ bufferBarriers.emplace_back() };
+				barrier.srcAccessMask = src.Access & sWriteAccess;
+				barrier.dstAccessMask = dst.Access;
+				barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+				barrier.buffer = static_cast<VkStorageBuffer*>(node.Buffer)->Buffers()->Buffer();
+				barrier.offset = 0;
+				barrier.size = VK_WHOLE_SIZE;
+			}
+		}
+
+		if (imageBarriers.empty() && bufferBarriers.empty())
+			return;
+
+		//a compute queue rejects the graphics stages, the shader accesses recorded there all come from compute shaders
+		if (vkCmd->Usage() == CommandBufferUsage::Compute)
+		{
+			srcStages &= sComputeStages;
+			dstStages &= sComputeStages;
+		}
+
+		vkCmd->CurrentBuffer().pipelineBarrier(srcStages, dstStages, {}, {}, bufferBarriers, imageBarriers);
+	}
+
+	b8 VkRenderGraph::TransientKey::operator==(const TransientKey& other) const
+	{
+		return Desc.Width == other.Desc.Width && Desc.Height == other.Desc.Height && Desc.Format == other.Desc.Format &&
+			Usages == other.Usages && FirstPass == other.FirstPass && LastPass == other.LastPass;
+	}
+
+	VkRenderGraph::UsageInfo VkRenderGraph::GetUsageInfo(const ResourceUsage usage)
+	{
+		const vk::PipelineStageFlags shaderStages{ vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eComputeShader };
+
+		switch (usage)
+		{
+		case ResourceUsage::None:
+			return { vk::PipelineStageFlagBits::eTopOfPipe, {}, vk::ImageLayout::eUndefined };
+		case ResourceUsage::ColorAttachment:
+			return { vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite, vk::ImageLayout::eColorAttachmentOptimal };
+		case ResourceUsage::DepthAttachment:
+			return { vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests, vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite, vk::ImageLayout::eDepthStencilAttachmentOptimal };
+		case ResourceUsage::ShaderRead:
+			return { shaderStages, vk::AccessFlagBits::eShaderRead, vk::ImageLayout::eShaderReadOnlyOptimal };
+		case ResourceUsage::StorageRead:
+			return { shaderStages, vk::AccessFlagBits::eShaderRead, vk::ImageLayout::eGeneral };
+		case ResourceUsage::StorageWrite:
+			return { shaderStages, vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite, vk::ImageLayout::eGeneral };
+		case ResourceUsage::TransferSrc:
+			return { vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferRead, vk::ImageLayout::eTransferSrcOptimal };
+		case ResourceUsage::TransferDst:
+			return { vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite, vk::ImageLayout::eTransferDstOptimal };
+		case ResourceUsage::VertexBuffer:
+			return { vk::PipelineStageFlagBits::eVertexInput, vk::AccessFlagBits::eVertexAttributeRead, vk::ImageLayout::eUndefined };
+		case ResourceUsage::IndexBuffer:
+			return { vk::PipelineStageFlagBits::eVertexInput, vk::AccessFlagBits::eIndexRead, vk::ImageLayout::eUndefined };
+		case ResourceUsage::IndirectBuffer:
+			return { vk::PipelineStageFlagBits::eDrawIndirect, vk::AccessFlagBits::eIndirectCommandRead, vk::ImageLayout::eUndefined };
+		case ResourceUsage::Present:
+			return { vk::PipelineStageFlagBits::eBottomOfPipe, {}, vk::ImageLayout::ePresentSrcKHR };
+		}
+
+		return { vk::PipelineStageFlagBits::eAllCommands, vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite, vk::ImageLayout::eGeneral };
+	}
+
+	vk::Format VkRenderGraph::GetFormat(const ImageFormat format)
+	{
+		switch (format)
+		{
+		case ImageFormat::Rgba8Unorm:
+			return vk::Format::eR8G8B8A8Unorm;
+		case ImageFormat::Bgra8Srgb:
+			return vk::Format::eB8G8R8A8Srgb;
+		case ImageFormat::Rgba16Float:
+			return vk::Format::eR16G16B16A16Sfloat;
+		case ImageFormat::R32Float:
+			return vk::Format::eR32Sfloat;
+		case ImageFormat::Depth32:
+			return vk::Format::eD32Sfloat;
+		}
+
+		return vk::Format::eUndefined;
+	}
+
+	vk::ImageUsageFlags VkRenderGraph::GetImageUsage(const u32 usages)
+	{
+		vk::ImageUsageFlags flags{};
+		if (usages & UsageBit(ResourceUsage::ColorAttachment))
+			flags |= vk::ImageUsageFlagBits::eColorAttachment;
+		if (usages & UsageBit(ResourceUsage::DepthAttachment))
+			flags |= vk::ImageUsageFlagBits::eDepthStencilAttachment;
+		if (usages & UsageBit(ResourceUsage::ShaderRead))
+			flags |= vk::ImageUsageFlagBits::eSampled;
+		if (usages & (UsageBit(ResourceUsage::StorageRead) | UsageBit(ResourceUsage::StorageWrite)))
+			flags |= vk::ImageUsageFlagBits::eStorage;
+		if (usages & UsageBit(ResourceUsage::TransferSrc))
+			flags |= vk::ImageUsageFlagBits::eTransferSrc;
+		if (usages & UsageBit(ResourceUsage::TransferDst))
+			flags |= vk::ImageUsageFlagBits::eTransferDst;
+
+		return flags;
+	}
+
+	/**
+	 * \brief Creates the images of frame.Keys and packs them into as few allocations as possible.
+	 * Greedy interval colouring, largest images first: an image joins the first allocation whose images are
+	 * never alive in the same pass and whose memory types are compatible.
+	 */
+	void VkRenderGraph::CreateTransients(TransientFrame& frame) const
+	{
+		const auto& keys{ frame.Keys };
+
+		std::vector<vk::MemoryRequirements> requirements{};
+		requirements.reserve(keys.size());
+		for (const auto& [desc, usages, firstPass, lastPass] : keys)
+		{
+			const vk::ImageAspectFlags aspect{ desc.Format == ImageFormat::Depth32 ? vk::ImageAspectFlagBits::eDepth : vk::ImageAspectFlagBits::eColor };
+
+			const auto& image{ frame.Images.emplace_back(std::make_unique<VkImage>(desc.Width, desc.Height, GetFormat(desc.Format), GetImageUsage(usages), aspect)) };
+			requirements.push_back(image->MemoryRequirements());
+			frame.UnaliasedBytes += requirements.back().size;
+		}
+
+		std::vector<u32> order(keys.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&](const u32 a, const u32 b) { return requirements[a].size > requirements[b].size; });
+
+		struct Slot
+		{
+			vk::MemoryRequirements Requirements;
+			std::vector<u32> Occupants;
+		};
+		std::vector<Slot> slots{};
+
+		frame.Slots.assign(keys.size(), 0);
+		for (const u32 index : order)
+		{
+			const auto& requirement{ requirements[index] };
+
+			u32 slotIndex{ 0 };
+			for (; slotIndex < slots.size(); slotIndex++)
+			{
+				const auto& slot{ slots[slotIndex] };
+				if (!(slot.Requirements.memoryTypeBits & requirement.memoryTypeBits))
+					continue;
+
+				const b8 overlaps{ std::any_of(slot.Occupants.begin(), slot.Occupants.end(), [&](const u32 occupant)
+				{
+					return keys[occupant].FirstPass <= keys[index].LastPass && keys[index].FirstPass <= keys[occupant].LastPass;
+				}) };
+
+				if (!overlaps)
+					break;
+			}
+
+			if (slotIndex == slots.size())
+			{
+				slots.push_back({ requirement, {} });
+			}
+			else
+			{
+				auto& merged{ slots[slotIndex].Requirements };
+				merged.size = std::max(merged.size, requirement.size);
+				merged.alignment = std::max(merged.alignment, requirement.alignment);
+				merged.memoryTypeBits &= requirement.memoryTypeBits;
+			}
+
+			slots[slotIndex].Occupants.push_back(index);
+			frame.Slots[index] = slotIndex;
+		}
+
+		for (const auto& [slotRequirements, occupants] : slots)
+		{
+			VmaAllocationCreateInfo allocInfo{};
+			allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+			VmaAllocation memory{ nullptr };
+			vmaAllocateMemory(VkCore::Get()->Allocator(), reinterpret_cast<const VkMemoryRequirements*>(&slotRequirements), &allocInfo, &memory, nullptr);
+
+			frame.Memory.push_back(memory);
+			frame.AllocatedBytes += slotRequirements.size;
+
+			for (const u32 occupant : occupants)
+				frame.Images[occupant]->BindMemory(memory);
+		}
+	}
+
+	void VkRenderGraph::ReleaseTransients(TransientFrame& frame)
+	{
+		frame.Images.clear();
+
+		for (const auto memory : frame.Memory)
+			vmaFreeMemory(VkCore::Get()->Allocator(), memory);
+
+		frame.Keys.clear();
+		frame.Slots.clear();
+		frame.Memory.clear();
+		frame.AllocatedBytes = 0;
+		frame.UnaliasedBytes = 0;
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <vma/vk_mem_alloc.h>
+
+#include "VkImage.h"
+#include "Graphics/RenderGraph.h"
+
+namespace SnowEngine
+{
+	class VkRenderGraph : public RenderGraph
+	{
+	public:
+		VkRenderGraph(u32 frameCount);
+		~VkRenderGraph() override;
+
+	protected:
+		void AllocateTransients(u32 currentFrame, const std::vector<ResourceNode*>& transients) override;
+		void RecordBarriers(const std::vector<RenderGraphBarrier>& barriers, const std::shared_ptr<CommandBuffer>& cmd) const override;
+
+	private:
+		struct UsageInfo
+		{
+			vk::PipelineStageFlags Stage;
+			vk::AccessFlags Access;
+			vk::ImageLayout Layout;
+		};
+
+		struct TransientKey
+		{
+			TransientImageDesc Desc;
+			u32 Usages;
+			u32 FirstPass;
+			u32 LastPass;
+
+			b8 operator==(const TransientKey& other) const;
+		};
+
+		struct TransientFrame
+		{
+			std::vector<TransientKey> Keys;
+			std::vector<std::unique_ptr<VkImage>> Images;
+			std::vector<u32> Slots;
+			std::vector<VmaAllocation> Memory;
+			u64 AllocatedBytes{ 0 };
+			u64 UnaliasedBytes{ 0 };
+		};
+
+		static UsageInfo GetUsageInfo(ResourceUsage usage);
+		static vk::Format GetFormat(ImageFormat format);
+		static vk::ImageUsageFlags GetImageUsage(u32 usages);
+
+		void CreateTransients(TransientFrame& frame) const;
+		static void ReleaseTransients(TransientFrame& frame);
+
+		std::vector<TransientFrame> mFrames;
+	};
+}
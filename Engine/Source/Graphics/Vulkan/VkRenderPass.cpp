@@ -1,12 +1,14 @@
 #include "VkRenderPass.h"
 
+#include <algorithm>
+
 #include "VkCore.h"
 #include "VkCommandBuffer.h"
 
 namespace SnowEngine
 {
 	VkRenderPass::VkRenderPass(std::shared_ptr<const VkSurface> surface, const b8 depth)
-		: mSurface{ std::move(surface) }, mWidth{ mSurface->Width() }, mHeight{ mSurface->Height() }, mHasDepth{ depth }
+		: mSurface{ std::move(surface) }, mWidth{ mSurface->Width() }, mHeight{ mSurface->Height() }, mSwapchainVersion{ mSurface->SwapchainVersion() }, mHasDepth{ depth }
 	{
 		CreateAttachments(mSurface->Format(), vk::ImageLayout::ePresentSrcKHR);
 		CreateSubpasses();
@@ -59,38 +61,84 @@ namespace SnowEngine
 		}
 	}
 
+	VkRenderPass::VkRenderPass(const u32 width, const u32 height)
+		: mWidth{ width }, mHeight{ height }, mHasDepth{ true }
+	{
+		//loaded and stored, a clear only affects the render area so the rest of the image survives every pass
+		vk::AttachmentDescription& depthAttachment{ mAttachments.emplace_back() };
+		depthAttachment.format = vk::Format::eD32Sfloat;
+		depthAttachment.samples = vk::SampleCountFlagBits::e1;
+		depthAttachment.loadOp = vk::AttachmentLoadOp::eClear;
+		depthAttachment.storeOp = vk::AttachmentStoreOp::eStore;
+		depthAttachment.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
+		depthAttachment.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
+		depthAttachment.initialLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+		depthAttachment.finalLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+
+		vk::AttachmentReference& depthAttachmentRef{ mReferences.emplace_back() };
+		depthAttachmentRef.attachment = 0;
+		depthAttachmentRef.layout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+
+		//the transitions in and out of the pass are left to the render graph
+		vk::SubpassDescription& subpass{ mSubpasses.emplace_back() };
+		subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
+		subpass.colorAttachmentCount = 0;
+		subpass.pDepthStencilAttachment = &mReferences[0];
+
+		CreateRenderPass();
+
+		mDepthTarget = std::make_shared<VkImage>(
+			mWidth,
+			mHeight,
+			vk::Format::eD32Sfloat,
+			vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled,
+			vk::ImageLayout::eShaderReadOnlyOptimal,
+			vk::ImageAspectFlagBits::eDepth);
+
+		mFramebuffers.resize(1);
+		CreateFramebuffer({ mDepthTarget->View() }, 0);
+	}
+
 	vk::RenderPass VkRenderPass::RenderPass() const { return mRenderPass; }
 
+	vk::Framebuffer VkRenderPass::Framebuffer(const u32 frameIndex) const { return mFramebuffers[frameIndex]; }
+
+	vk::Framebuffer VkRenderPass::CurrentFramebuffer() const { return mFramebuffers[CurrentIndex()]; }
+
 	const std::vector<std::unique_ptr<VkImage>>& VkRenderPass::Images() const { return mImages; }
 
 	b8 VkRenderPass::HasDepth() const { return mHasDepth; }
 
+	b8 VkRenderPass::HasColor() const { return !mDepthTarget; }
+
 	u32 VkRenderPass::Width() const { return mWidth; }
 
 	u32 VkRenderPass::Height() const { return mHeight; }
 
+	u32 VkRenderPass::RenderWidth() const { return std::max(static_cast<u32>(static_cast<f32>(mWidth) * mRenderScale), 1u); }
+
+	u32 VkRenderPass::RenderHeight() const { return std::max(static_cast<u32>(static_cast<f32>(mHeight) * mRenderScale), 1u); }
+
+	f32 VkRenderPass::RenderScale() const { return mRenderScale; }
+
+	void VkRenderPass::SetRenderScale(const f32 scale) { mRenderScale = std::clamp(scale, 0.0f, 1.0f); }
+
+	Image* VkRenderPass::ColorImage(const u32 frameIndex) const { return mImages.empty() ? nullptr : mImages[frameIndex].get(); }
+
+	std::shared_ptr<Image> VkRenderPass::DepthImage() const { return mDepthTarget; }
+
 	void VkRenderPass::Resize(const u32 width, const u32 height)
 	{
+		//surface passes follow the swapchain in Begin, their framebuffers are per image and not per frame
+		if (mSurface)
+			return;
+
 		mWidth = width;
 		mHeight = height;
 
 		VkSurface::BoundSurface()->SubmitPostFrameQueue([this](const u32 frameIndex)
 		{
 			VkCore::Get()->Device().destroyFramebuffer(mFramebuffers[frameIndex]);
-		
-			if (mSurface)
-			{
-				std::vector<vk::ImageView> views{ mSurface->Views()[frameIndex] };
-				if (mHasDepth)
-				{
-					CreateDepthImage(frameIndex);
-					views.emplace_back(mDepthImages[frameIndex]->View());
-				}
-
-				CreateFramebuffer(views, frameIndex);
-
-				return;
-			}
 
 			mImages[frameIndex].reset();
 
@@ -105,19 +153,25 @@ namespace SnowEngine
 		});
 	}
 
-	void VkRenderPass::Begin(const std::shared_ptr<CommandBuffer>& cmd)
+	void VkRenderPass::Begin(const std::shared_ptr<CommandBuffer>& cmd, const b8 secondaryCommands)
 	{
-		const auto& vkCmd = std::static_pointer_cast<VkCommandBuffer>(cmd);
-
-		if (mSurface && (mWidth != mSurface->Width() || mHeight != mSurface->Height()))
+		//the views change whenever the swapchain is recreated, even when the size and the image count do not
+		if (mSurface && mSwapchainVersion != mSurface->SwapchainVersion())
 		{
 			mWidth = mSurface->Width();
 			mHeight = mSurface->Height();
+			mSwapchainVersion = mSurface->SwapchainVersion();
 
-			for (u32 i{ 0 }; i < mSurface->Views().size(); i++)
-			{
-				VkCore::Get()->Device().destroyFramebuffer(mFramebuffers[i]);
+			for (const auto& framebuffer : mFramebuffers)
+				VkCore::Get()->Device().destroyFramebuffer(framebuffer);
 
+			const u32 imageCount{ mSurface->ImageCount() };
+			mFramebuffers.resize(imageCount);
+			if (mHasDepth)
+				mDepthImages.resize(imageCount);
+
+			for (u32 i{ 0 }; i < imageCount; i++)
+			{
 				std::vector<vk::ImageView> views{ mSurface->Views()[i] };
 				if (mHasDepth)
 				{
@@ -129,29 +183,66 @@ namespace SnowEngine
 			}
 		}
 
-		std::vector<vk::ClearValue> clearColors{ vk::ClearColorValue{ std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f} } };
+		BeginArea(cmd, vk::Rect2D{ { 0, 0 }, { RenderWidth(), RenderHeight() } }, secondaryCommands);
+	}
+
+	void VkRenderPass::BeginRegion(const std::shared_ptr<CommandBuffer>& cmd, const u32 x, const u32 y, const u32 width, const u32 height)
+	{
+		BeginArea(cmd, vk::Rect2D{ { static_cast<i32>(x), static_cast<i32>(y) }, { width, height } }, false);
+	}
+
+	void VkRenderPass::End(const std::shared_ptr<CommandBuffer>& cmd) const
+	{
+		const auto& vkCmd = std::static_pointer_cast<VkCommandBuffer>(cmd);
+
+		vkCmd->CurrentBuffer().endRenderPass();
+
+		//keep the tracked layouts in sync with the final layouts the render pass leaves behind
+		const u32 frameIndex{ CurrentIndex() };
+		if (mDepthTarget)
+		{
+			mDepthTarget->SetLayout(mAttachments[0].finalLayout);
+			return;
+		}
+
+		if (!mImages.empty())
+			mImages[frameIndex]->SetLayout(mAttachments[0].finalLayout);
+		if (mHasDepth)
+			mDepthImages[frameIndex]->SetLayout(mAttachments[1].finalLayout);
+	}
+
+	void VkRenderPass::BeginArea(const std::shared_ptr<CommandBuffer>& cmd, const vk::Rect2D& area, const b8 secondaryCommands) const
+	{
+		const auto& vkCmd = std::static_pointer_cast<VkCommandBuffer>(cmd);
+
+		std::vector<vk::ClearValue> clearColors{};
+		if (!mDepthTarget)
+			clearColors.emplace_back(vk::ClearColorValue{ std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f} });
 		if(mHasDepth)
 			clearColors.emplace_back(vk::ClearDepthStencilValue{ 1.0f, 0 });
 
 		vk::RenderPassBeginInfo beginInfo{};
 		beginInfo.renderPass = mRenderPass;
-		beginInfo.framebuffer = mFramebuffers[VkSurface::BoundSurface()->CurrentFrame()];
-		beginInfo.renderArea.offset = vk::Offset2D{ 0, 0 };
-		beginInfo.renderArea.extent = vk::Extent2D{ mWidth, mHeight };
+		beginInfo.framebuffer = CurrentFramebuffer();
+		beginInfo.renderArea = area;
 		beginInfo.clearValueCount = static_cast<u32>(clearColors.size());
 		beginInfo.pClearValues = clearColors.data();
 
-		vkCmd->CurrentBuffer().setViewport(0, { { 0.0f, 0.0f, static_cast<f32>(mWidth), static_cast<f32>(mHeight), 0.0f, 1.0f } });
-		vkCmd->CurrentBuffer().setScissor(0, vk::Rect2D{ {{0, 0}, mWidth, mHeight } });
+		vkCmd->CurrentBuffer().setViewport(0, { { static_cast<f32>(area.offset.x), static_cast<f32>(area.offset.y), static_cast<f32>(area.extent.width), static_cast<f32>(area.extent.height), 0.0f, 1.0f } });
+		vkCmd->CurrentBuffer().setScissor(0, area);
 
-		vkCmd->CurrentBuffer().beginRenderPass(beginInfo, vk::SubpassContents::eInline);
+		vkCmd->CurrentBuffer().beginRenderPass(beginInfo, secondaryCommands ? vk::SubpassContents::eSecondaryCommandBuffers : vk::SubpassContents::eInline);
 	}
 
-	void VkRenderPass::End(const std::shared_ptr<CommandBuffer>& cmd) const
+	/**
+	 * \brief Index of the framebuffer and attachments used this frame, surface passes have one per swapchain image.
+	 */
+	u32 VkRenderPass::CurrentIndex() const
 	{
-		const auto& vkCmd = std::static_pointer_cast<VkCommandBuffer>(cmd);
+		if (mDepthTarget)
+			return 0;
 
-		vkCmd->CurrentBuffer().endRenderPass();
+		return mSurface ? mSurface->ImageIndex() : VkSurface::BoundSurface()->CurrentFrame();
 	}
 
 	void VkRenderPass::CreateAttachments(const vk::Format format, const vk::ImageLayout layout)
@@ -12,15 +12,26 @@ namespace SnowEngine
 	public:
 		VkRenderPass(std::shared_ptr<const VkSurface> surface, b8 depth);
 		VkRenderPass(u32 frameCount, u32 width, u32 height, b8 depth);
+		VkRenderPass(u32 width, u32 height);
 
 		u32 Width() const override;
 		u32 Height() const override;
+		u32 RenderWidth() const override;
+		u32 RenderHeight() const override;
+		f32 RenderScale() const override;
+		void SetRenderScale(f32 scale) override;
+		Image* ColorImage(u32 frameIndex) const override;
+		std::shared_ptr<Image> DepthImage() const override;
 
 		vk::RenderPass RenderPass() const;
+		vk::Framebuffer Framebuffer(u32 frameIndex) const;
+		vk::Framebuffer CurrentFramebuffer() const;
 		const std::vector<std::unique_ptr<VkImage>>& Images() const;
 		b8 HasDepth() const;
+		b8 HasColor() const;
 
-		void Begin(const std::shared_ptr<CommandBuffer>& cmd) override;
+		void Begin(const std::shared_ptr<CommandBuffer>& cmd, b8 secondaryCommands = false) override;
+		void BeginRegion(const std::shared_ptr<CommandBuffer>& cmd, u32 x, u32 y, u32 width, u32 height) override;
 		void End(const std::shared_ptr<CommandBuffer>& cmd) const override;
 
 		void Resize(u32 width, u32 height);
@@ -33,6 +44,8 @@ namespace SnowEngine
 		void CreateFramebuffer(const std::vector<vk::ImageView>& views, u32 currentFrame);
 		void CreateImage(u32 currentFrame);
 		void CreateDepthImage(u32 currentFrame);
+		u32 CurrentIndex() const;
+		void BeginArea(const std::shared_ptr<CommandBuffer>& cmd, const vk::Rect2D& area, b8 secondaryCommands) const;
 
 		std::vector<vk::AttachmentDescription> mAttachments;
 		std::vector<vk::SubpassDescription> mSubpasses;
@@ -43,7 +56,10 @@ namespace SnowEngine
 		std::shared_ptr<const VkSurface> mSurface;
 		std::vector<std::unique_ptr<VkImage>> mImages;
 		std::vector<std::unique_ptr<VkImage>> mDepthImages;
+		std::shared_ptr<VkImage> mDepthTarget{ nullptr }; //the only attachment of depth only passes
 		u32 mWidth, mHeight;
+		u32 mSwapchainVersion{ 0 }; //of the surface views the framebuffers were created with
+		f32 mRenderScale{ 1.0f };
 		b8 mHasDepth;
 	};
 }
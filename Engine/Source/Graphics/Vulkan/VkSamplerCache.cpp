@@ -0,0 +1,104 @@
+#include "VkSamplerCache.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "VkCore.h"
+#include "Core/Hash.h"
+
+namespace SnowEngine
+{
+	VkSamplerCache::VkSamplerCache(const f32 maxAnisotropy)
+		: mMaxAnisotropy{ maxAnisotropy }
+	{
+	}
+
+	VkSamplerCache::~VkSamplerCache()
+	{
+		for (const auto& [hash, entries] : mSamplers)
+		{
+			for (const auto& entry : entries)
+				VkCore::Get()->Device().destroySampler(entry.Sampler);
+		}
+	}
+
+	vk::Sampler VkSamplerCache::Sampler(const SamplerDesc& desc)
+	{
+		std::lock_guard lock{ mMutex };
+
+		auto& entries{ mSamplers[Hash(desc)] };
+		for (const auto& entry : entries)
+		{
+			if (entry.Desc == desc)
+				return entry.Sampler;
+		}
+
+		const f32 anisotropy{ std::clamp(desc.Anisotropy, 1.0f, mMaxAnisotropy) };
+
+		vk::SamplerCreateInfo createInfo{};
+		createInfo.magFilter = GetFilter(desc.Filter);
+		createInfo.minFilter = GetFilter(desc.Filter);
+		createInfo.mipmapMode = desc.MipFilter == SamplerFilter::Linear ? vk::SamplerMipmapMode::eLinear : vk::SamplerMipmapMode::eNearest;
+		createInfo.addressModeU = GetAddressMode(desc.AddressU);
+		createInfo.addressModeV = GetAddressMode(desc.AddressV);
+		createInfo.addressModeW = GetAddressMode(desc.AddressW);
+		createInfo.mipLodBias = 0.0f;
+		createInfo.anisotropyEnable = anisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+		createInfo.maxAnisotropy = anisotropy;
+		createInfo.compareEnable = VK_FALSE;
+		createInfo.compareOp = vk::CompareOp::eAlways;
+		createInfo.minLod = desc.MinLod;
+		createInfo.maxLod = desc.MaxLod;
+		createInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
+
+		const vk::Sampler sampler{ VkCore::Get()->Device().createSampler(createInfo) };
+		entries.push_back({ desc, sampler });
+
+		return sampler;
+	}
+
+	u32 VkSamplerCache::SamplerCount() const
+	{
+		std::lock_guard lock{ mMutex };
+
+		u32 count{ 0 };
+		for (const auto& [hash, entries] : mSamplers)
+			count += static_cast<u32>(entries.size());
+
+		return count;
+	}
+
+	vk::Filter VkSamplerCache::GetFilter(const SamplerFilter filter)
+	{
+		switch (filter)
+		{
+		case SamplerFilter::Nearest: return vk::Filter::eNearest;
+		case SamplerFilter::Linear: return vk::Filter::eLinear;
+		}
+
+		return vk::Filter::eLinear;
+	}
+
+	vk::SamplerAddressMode VkSamplerCache::GetAddressMode(const SamplerAddressMode mode)
+	{
+		switch (mode)
+		{
+		case SamplerAddressMode::Repeat: return vk::SamplerAddressMode::eRepeat;
+		case SamplerAddressMode::MirroredRepeat: return vk::SamplerAddressMode::eMirroredRepeat;
+		case SamplerAddressMode::ClampToEdge: return vk::SamplerAddressMode::eClampToEdge;
+		case SamplerAddressMode::ClampToBorder: return vk::SamplerAddressMode::eClampToBorder;
+		}
+
+		return vk::SamplerAddressMode::eRepeat;
+	}
+
+	u64 VkSamplerCache::Hash(const SamplerDesc& desc)
+	{
+		const u32 fields[8]{ static_cast<u32>(desc.Filter), static_cast<u32>(desc.MipFilter), static_cast<u32>(desc.AddressU), static_cast<u32>(desc.AddressV), static_cast<u32>(desc.AddressW), std::bit_cast<u32>(desc.Anisotropy), std::bit_cast<u32>(desc.MinLod), std::bit_cast<u32>(desc.MaxLod) };
+
+		Hasher hash;
+		hash.Mix(fields);
+
+		return hash.Get();
+	}
+}
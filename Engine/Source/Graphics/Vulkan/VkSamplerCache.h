@@ -0,0 +1,44 @@
+#pragma once
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "Core/Types.h"
+#include "Graphics/Rhi/Image.h"
+
+namespace SnowEngine
+{
+	/**
+	 * \brief Samplers shared by every image sampled the same way, hashed by their description. The samplers live as long
+	 * as the cache, so the engine only ever creates a handful of them.
+	 */
+	class VkSamplerCache
+	{
+	public:
+		/** \param maxAnisotropy Device limit, 1 when anisotropic filtering is not enabled. */
+		VkSamplerCache(f32 maxAnisotropy);
+		~VkSamplerCache();
+
+		VkSamplerCache(const VkSamplerCache&) = delete;
+		VkSamplerCache& operator=(const VkSamplerCache&) = delete;
+
+		vk::Sampler Sampler(const SamplerDesc& desc);
+		u32 SamplerCount() const;
+
+	private:
+		struct Entry
+		{
+			SamplerDesc Desc;
+			vk::Sampler Sampler;
+		};
+
+		static vk::Filter GetFilter(SamplerFilter filter);
+		static vk::SamplerAddressMode GetAddressMode(SamplerAddressMode mode);
+		static u64 Hash(const SamplerDesc& desc);
+
+		std::unordered_map<u64, std::vector<Entry>> mSamplers;
+		mutable std::mutex mMutex;
+		f32 mMaxAnisotropy;
+	};
+}
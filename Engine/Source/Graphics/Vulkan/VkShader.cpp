@@ -1,42 +1,17 @@
 #include "VkShader.h"
-#include <fstream>
-#include <iostream>
-#include <shaderc/shaderc.hpp>
-#include <spirv_cross/spirv_glsl.hpp>
+#include <chrono>
 
 #include "VkCore.h"
+#include "VkLayoutCache.h"
+#include "VkShaderBundle.h"
+#include "Core/Logger.h"
+
+#ifndef SNOW_COOKED_SHADERS
+#include "VkShaderCompiler.h"
+#endif
 
 namespace SnowEngine
 {
-
-	static std::string ReadFile(const std::filesystem::path& path)
-	{
-		std::ifstream file{ path, std::ios::ate | std::ios::binary };
-		if (!file.is_open())
-			return "";
-		
-		const u64 fileSize{ static_cast<u64>(file.tellg()) };
-		std::string buffer(fileSize, ' ');
-
-		file.seekg(0);
-		file.read(buffer.data(), fileSize);
-
-		file.close();
-
-		return buffer;
-	}
-
-	static shaderc_shader_kind GetShaderKind(const ShaderType type)
-	{
-		switch (type)
-		{
-			case ShaderType::Vertex: return shaderc_vertex_shader;
-			case ShaderType::Fragment: return shaderc_fragment_shader;
-			case ShaderType::Compute: return shaderc_compute_shader;
-			default: return shaderc_glsl_infer_from_source;
-		}
-	}
-
 	static vk::ShaderStageFlagBits GetShaderStage(const ShaderType type)
 	{
 		switch (type)
@@ -48,48 +23,30 @@ namespace SnowEngine
 		}
 	}
 
-	::VkDescriptorSetLayout VkDescriptorSetLayout::CreateLayout() const
+	vk::DescriptorSetLayout VkDescriptorSetLayout::Layout() const
 	{
 		std::vector<vk::DescriptorSetLayoutBinding> bindings{};
 		bindings.reserve(Resources.size());
 		for (const auto& [binding, resource] : Resources)
 			bindings.push_back(resource.LayoutBinding);
 
-		vk::DescriptorSetLayoutCreateInfo createInfo{};
-		createInfo.bindingCount = static_cast<u32>(bindings.size());
-		createInfo.pBindings = bindings.data();
-
-		return VkCore::Get()->Device().createDescriptorSetLayout(createInfo);
+		return VkCore::Get()->LayoutCache().SetLayout(bindings);
 	}
 
 	VkShader::VkShader(const GraphicShaderSource& source)
 	{
 		const auto& [vertex, fragment, others] = source;
 
-		{
-			const std::vector<u32> spv{ Compile(vertex) };
-			CreateModule(spv, GetShaderStage(std::get<1>(vertex)));
-			CreateReflection(spv, GetShaderStage(std::get<1>(vertex)));
-		}
-		{
-			const std::vector<u32> spv{ Compile(fragment) };
-			CreateModule(spv, GetShaderStage(std::get<1>(fragment)));
-			CreateReflection(spv, GetShaderStage(std::get<1>(fragment)));
-		}
+		AddStage(vertex);
+		AddStage(fragment);
 
 		for (const auto& other : others)
-		{
-			const std::vector<u32> spv{ Compile(other) };
-			CreateModule(spv, GetShaderStage(std::get<1>(other)));
-			CreateReflection(spv, GetShaderStage(std::get<1>(other)));
-		}
+			AddStage(other);
 	}
 
 	VkShader::VkShader(const ComputeShaderSource& source)
 	{
-		const std::vector<u32> spv{ Compile(source.Comp) };
-		CreateModule(spv, vk::ShaderStageFlagBits::eCompute);
-		CreateReflection(spv, vk::ShaderStageFlagBits::eCompute);
+		AddStage(source.Comp, source.Defines);
 	}
 
 	std::vector<vk::PipelineShaderStageCreateInfo> VkShader::ShaderStageInfos() const
@@ -114,6 +71,38 @@ namespace SnowEngine
 
 	const std::map<set, VkDescriptorSetLayout>& VkShader::Layouts() const { return mDescriptorSetLayouts; }
 
+	const vk::PushConstantRange& VkShader::PushConstants() const { return mPushConstants; }
+
+	/**
+	 * \brief Loads the stage from the shader cache, compiling and reflecting it only when the source, its includes or
+	 * the defines changed since it was cached. Builds running on cooked shaders take it from the shader bundle instead.
+	 */
+	void VkShader::AddStage(const shaderSource& source, const std::vector<std::string>& defines)
+	{
+		const auto begin{ std::chrono::steady_clock::now() };
+
+		const auto& [path, type] = source;
+		VkCompiledStage compiled{};
+
+#ifdef SNOW_COOKED_SHADERS
+		const b8 hit{ VkShaderBundle::Load(VkShaderBundle::Key(path, type, defines), compiled) };
+		if (!hit)
+			LOG_ERROR("Shader %s is missing from the shader bundle", path.filename().string().c_str());
+#else
+		const shaderSources sources{ VkShaderCompiler::Sources(path) };
+		const u64 key{ VkShaderCompiler::Key(sources, type, defines) };
+
+		const b8 hit{ VkShaderCache::Load(key, compiled) };
+		if (!hit && VkShaderCompiler::Compile(source, sources.front().second, defines, compiled))
+			VkShaderCache::Store(key, compiled);
+#endif
+
+		CreateModule(compiled.Spirv, GetShaderStage(type));
+		AddReflection(compiled, GetShaderStage(type));
+
+		VkShaderCache::Record(hit, std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - begin).count());
+	}
+
 	void VkShader::CreateModule(const std::vector<u32>& spv, const vk::ShaderStageFlagBits stage)
 	{
 		vk::ShaderModuleCreateInfo createInfo{};
@@ -125,111 +114,42 @@ namespace SnowEngine
 		mModules.emplace_back(module, stage);
 	}
 
-	void VkShader::CreateReflection(const std::vector<u32>& spv, const vk::ShaderStageFlagBits stage)
+	/**
+	 * \brief Merges the reflection of a stage into the layouts of the shader, the first stage declaring a binding
+	 * defines it.
+	 */
+	void VkShader::AddReflection(const VkCompiledStage& compiled, const vk::ShaderStageFlagBits stage)
 	{
-		const spirv_cross::Compiler compiler{ spv };
-		spirv_cross::ShaderResources resources{ compiler.get_shader_resources() };
-
-		for (const auto& resource : resources.uniform_buffers)
+		for (const auto& resource : compiled.Resources)
 		{
-			const binding binding{ compiler.get_decoration(resource.id, spv::Decoration::DecorationBinding) };
-			const set set{ compiler.get_decoration(resource.id, spv::Decoration::DecorationDescriptorSet) };
-
-			const spirv_cross::SPIRType& type{ compiler.get_type(resource.base_type_id) };
-			const u32 size{ static_cast<u32>(compiler.get_declared_struct_size(type)) };
-
 			vk::DescriptorSetLayoutBinding layoutBinding{};
-			layoutBinding.binding = binding;
+			layoutBinding.binding = resource.Binding;
 			layoutBinding.descriptorCount = 1;
-			layoutBinding.descriptorType = vk::DescriptorType::eUniformBuffer;
+			layoutBinding.descriptorType = resource.DescriptorType;
 			layoutBinding.stageFlags = stage;
 
 			VkResource res;
 			res.LayoutBinding = layoutBinding;
-			res.Name = resource.name;
-			res.Size = size;
-			res.Type = VkResourceType::Uniform;
+			res.Name = resource.Name;
+			res.Size = resource.Size;
+			res.Type = resource.Type;
 
-			if (!mDescriptorSetLayouts.contains(set))
+			if (!mDescriptorSetLayouts.contains(resource.Set))
 			{
-				mDescriptorSetLayouts.insert({ set, {} });
-				mDescriptorSetLayouts.at(set).SetIndex = set;
+				mDescriptorSetLayouts.insert({ resource.Set, {} });
+				mDescriptorSetLayouts.at(resource.Set).SetIndex = resource.Set;
 			}
 
-			if (!mDescriptorSetLayouts.at(set).Resources.contains(binding))
-				mDescriptorSetLayouts.at(set).Resources.insert({ binding, res });
+			if (!mDescriptorSetLayouts.at(resource.Set).Resources.contains(resource.Binding))
+				mDescriptorSetLayouts.at(resource.Set).Resources.insert({ resource.Binding, res });
 		}
-		
-		for (const auto& resource : resources.sampled_images)
-		{
-			const binding binding{ compiler.get_decoration(resource.id, spv::Decoration::DecorationBinding) };
-			const set set{ compiler.get_decoration(resource.id, spv::Decoration::DecorationDescriptorSet) };
-
-			vk::DescriptorSetLayoutBinding layoutBinding{};
-			layoutBinding.binding = binding;
-			layoutBinding.descriptorCount = 1;
-			layoutBinding.descriptorType = vk::DescriptorType::eCombinedImageSampler;
-			layoutBinding.stageFlags = stage;
 
-			VkResource res;
-			res.LayoutBinding = layoutBinding;
-			res.Name = resource.name;
-			res.Type = VkResourceType::Image;
-
-			if (!mDescriptorSetLayouts.contains(set))
-			{
-				mDescriptorSetLayouts.insert({ set, {} });
-				mDescriptorSetLayouts.at(set).SetIndex = set;
-			}
-
-			if (!mDescriptorSetLayouts.at(set).Resources.contains(binding))
-				mDescriptorSetLayouts.at(set).Resources.insert({ binding, res });
-		}
-
-		for (const auto& resource : resources.storage_buffers)
+		//all stages share a single range starting at offset 0, sized to the largest block
+		if (compiled.PushConstantSize)
 		{
-			const binding binding{ compiler.get_decoration(resource.id, spv::DecorationBinding) };
-			const set set{ compiler.get_decoration(resource.id, spv::DecorationDescriptorSet) };
-
-			const spirv_cross::SPIRType& type{ compiler.get_type(resource.base_type_id) };
-			const u32 size{ static_cast<u32>(compiler.get_declared_struct_size(type)) };
-
-			vk::DescriptorSetLayoutBinding layoutBinding{};
-			layoutBinding.binding = binding;
-			layoutBinding.descriptorCount = 1;
-			layoutBinding.descriptorType = vk::DescriptorType::eStorageBuffer;
-			layoutBinding.stageFlags = stage;
-
-			VkResource res;
-			res.LayoutBinding = layoutBinding;
-			res.Name = resource.name;
-			res.Size = size;
-			res.Type = VkResourceType::StorageBuffer;
-
-			if (!mDescriptorSetLayouts.contains(set))
-			{
-				mDescriptorSetLayouts.insert({ set, {} });
-				mDescriptorSetLayouts.at(set).SetIndex = set;
-			}
-
-			if (!mDescriptorSetLayouts.at(set).Resources.contains(binding))
-				mDescriptorSetLayouts.at(set).Resources.insert({ binding, res });
+			mPushConstants.offset = 0;
+			mPushConstants.size = std::max(mPushConstants.size, compiled.PushConstantSize);
+			mPushConstants.stageFlags |= stage;
 		}
 	}
-
-	std::vector<u32> VkShader::Compile(const shaderSource& source)
-	{
-		const auto& [path, type] = source;
-		const std::string code{ ReadFile(path) };
-
-		const shaderc::Compiler compiler;
-		const shaderc::SpvCompilationResult result{ compiler.CompileGlslToSpv(code, GetShaderKind(type), path.filename().string().c_str()) };
-		if (result.GetCompilationStatus() != shaderc_compilation_status_success)
-		{
-			std::cerr << result.GetErrorMessage() << std::endl;
-			return {};
-		}
-
-		return { result.cbegin(), result.cend() };
-	}
 }
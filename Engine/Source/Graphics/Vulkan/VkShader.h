@@ -2,6 +2,7 @@
 #include <filesystem>
 #include <map>
 #include <vulkan/vulkan.hpp>
+#include "VkShaderCache.h"
 #include "Graphics/Rhi/Shader.h"
 #include "Core/Types.h"
 
@@ -10,13 +11,6 @@ namespace SnowEngine
 	using binding = u32;
 	using set = u32;
 
-	enum class VkResourceType : u32
-	{
-		Uniform,
-		Image,
-		StorageBuffer
-	};
-
 	struct VkResource
 	{
 		VkResourceType Type;
@@ -30,7 +24,8 @@ namespace SnowEngine
 		std::map<binding, VkResource> Resources;
 		set SetIndex;
 
-		::VkDescriptorSetLayout CreateLayout() const;
+		/** \brief Handle shared by every identical layout, owned by the layout cache. */
+		vk::DescriptorSetLayout Layout() const;
 	};
 
 	class VkShader : public Shader
@@ -41,15 +36,16 @@ namespace SnowEngine
 
 		std::vector<vk::PipelineShaderStageCreateInfo> ShaderStageInfos() const;
 		const std::map<set, VkDescriptorSetLayout>& Layouts() const;
+		const vk::PushConstantRange& PushConstants() const;
 
 	private:
+		void AddStage(const shaderSource& source, const std::vector<std::string>& defines = {});
 		void CreateModule(const std::vector<u32>& spv, vk::ShaderStageFlagBits stage);
-		void CreateReflection(const std::vector<u32>& spv, vk::ShaderStageFlagBits stage);
-
-		static std::vector<u32> Compile(const shaderSource& source);
+		void AddReflection(const VkCompiledStage& compiled, vk::ShaderStageFlagBits stage);
 
 		using shaderInfo = std::tuple<vk::ShaderModule, vk::ShaderStageFlagBits>;
 		std::vector<shaderInfo> mModules;
 		std::map<set, VkDescriptorSetLayout> mDescriptorSetLayouts;
+		vk::PushConstantRange mPushConstants{};
 	};
 }
@@ -0,0 +1,117 @@
+#include "VkShaderBundle.h"
+
+#include <fstream>
+
+#include "Core/Hash.h"
+#include "Core/Logger.h"
+
+namespace SnowEngine
+{
+	std::mutex VkShaderBundle::sMutex{};
+	std::unordered_map<u64, VkCompiledStage> VkShaderBundle::sStages{};
+	b8 VkShaderBundle::sRead{ false };
+
+	u64 VkShaderBundle::Key(const std::filesystem::path& path, const ShaderType type, const std::vector<std::string>& defines)
+	{
+		Hasher hash;
+		hash.Mix(path.filename().generic_string());
+
+		const u32 stage{ static_cast<u32>(type) };
+		hash.Mix(stage);
+
+		for (const auto& define : defines)
+			hash.Mix(define);
+
+		return hash.Get();
+	}
+
+	b8 VkShaderBundle::Load(const u64 key, VkCompiledStage& stage)
+	{
+		std::lock_guard lock{ sMutex };
+		if (!sRead)
+		{
+			Read();
+			sRead = true;
+		}
+
+		const auto it{ sStages.find(key) };
+		if (it == sStages.end())
+			return false;
+
+		stage = it->second;
+		return true;
+	}
+
+	/**
+	 * \brief Writes the header, a table of the keys and offsets of the stages and then the stages themselves.
+	 */
+	b8 VkShaderBundle::Write(const std::filesystem::path& path, const std::vector<std::pair<u64, VkCompiledStage>>& stages)
+	{
+		std::error_code error{};
+		std::filesystem::create_directories(path.parent_path(), error);
+
+		std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+		if (!file.is_open())
+			return false;
+
+		FileHeader header{};
+		header.Magic = sMagic;
+		header.Version = sVersion;
+		header.StageCount = static_cast<u32>(stages.size());
+		header.CacheVersion = VkShaderCache::sVersion;
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		//the table is written once the offsets are known
+		std::vector<Entry> entries(stages.size());
+		file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+
+		for (u64 i{ 0 }; i < stages.size(); i++)
+		{
+			entries[i].Key = stages[i].first;
+			entries[i].Offset = static_cast<u64>(file.tellp());
+			VkShaderCache::WriteStage(file, stages[i].second);
+		}
+
+		file.seekp(sizeof(header));
+		file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+
+		return static_cast<b8>(file);
+	}
+
+	void VkShaderBundle::Read()
+	{
+		std::ifstream file{ sBundlePath, std::ios::binary };
+		if (!file.is_open())
+		{
+			LOG_ERROR("Shader bundle %s not found, run the shader cooker", sBundlePath);
+			return;
+		}
+
+		FileHeader header{};
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!file || header.Magic != sMagic || header.Version != sVersion || header.CacheVersion != VkShaderCache::sVersion)
+		{
+			LOG_ERROR("Shader bundle %s was cooked by another version, run the shader cooker", sBundlePath);
+			return;
+		}
+
+		std::vector<Entry> entries(header.StageCount);
+		file.read(reinterpret_cast<char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+
+		for (const auto& [key, offset] : entries)
+		{
+			file.seekg(static_cast<std::streamoff>(offset));
+
+			VkCompiledStage stage{};
+			if (!file || !VkShaderCache::ReadStage(file, stage))
+			{
+				LOG_ERROR("Shader bundle %s is truncated", sBundlePath);
+				sStages.clear();
+				return;
+			}
+
+			sStages.emplace(key, std::move(stage));
+		}
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "VkShaderCache.h"
+#include "Core/Types.h"
+#include "Graphics/Rhi/Shader.h"
+
+namespace SnowEngine
+{
+	/**
+	 * \brief Single file holding every stage compiled ahead of time by the shader cooker. Builds defining
+	 * SNOW_COOKED_SHADERS create their shaders from it and do not link shaderc nor SPIRV-Cross.
+	 */
+	class VkShaderBundle
+	{
+	public:
+		VkShaderBundle() = delete;
+
+		/**
+		 * \brief Name of a stage in the bundle, made of its file name, its stage and its defines. The directory is left
+		 * out so the cooked stages do not depend on where the sources were.
+		 */
+		static u64 Key(const std::filesystem::path& path, ShaderType type, const std::vector<std::string>& defines);
+
+		/** \brief Finds a stage in the bundle, which is read the first time a stage is requested. */
+		static b8 Load(u64 key, VkCompiledStage& stage);
+		static b8 Write(const std::filesystem::path& path, const std::vector<std::pair<u64, VkCompiledStage>>& stages);
+
+		static constexpr const char* sBundlePath{ "D:/Dev/SnowEngine/Engine/Cache/Shaders.bundle" };
+
+	private:
+		struct FileHeader
+		{
+			u32 Magic;
+			u32 Version;
+			u32 StageCount;
+			u32 CacheVersion; //stages are serialized in the format of the shader cache
+		};
+
+		struct Entry
+		{
+			u64 Key;
+			u64 Offset; //from the start of the file
+		};
+
+		static void Read();
+
+		static std::mutex sMutex;
+		static std::unordered_map<u64, VkCompiledStage> sStages;
+		static b8 sRead;
+
+		static constexpr u32 sMagic{ 0x42535353 }; //"SSSB"
+		static constexpr u32 sVersion{ 1 };
+	};
+}
@@ -0,0 +1,152 @@
+#include "VkShaderCache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "Core/Logger.h"
+
+namespace SnowEngine
+{
+	std::mutex VkShaderCache::sMutex{};
+	ShaderCacheStats VkShaderCache::sStats{};
+
+	static constexpr const char* sShaderCacheDirectory{ "D:/Dev/SnowEngine/Engine/Cache/Shaders" };
+
+	/**
+	 * \brief Reads the stage stored under the key.
+	 * \return False when it is not cached or the file does not match the key and the format.
+	 */
+	b8 VkShaderCache::Load(const u64 key, VkCompiledStage& stage)
+	{
+		std::ifstream file{ FilePath(key), std::ios::binary };
+		if (!file.is_open())
+			return false;
+
+		FileHeader header{};
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!file || header.Magic != sMagic || header.Version != sVersion || header.Key != key)
+			return false;
+
+		if (!ReadStage(file, stage))
+		{
+			LOG_WARNING("Shader cache entry %016llx is truncated, compiling again", key);
+			return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * \brief Stores the stage under the key, through a temporary file so a concurrent reader never sees half an entry.
+	 * The temporary file is named after the thread, stages compiled concurrently may share a key.
+	 */
+	void VkShaderCache::Store(const u64 key, const VkCompiledStage& stage)
+	{
+		const std::filesystem::path path{ FilePath(key) };
+
+		std::error_code error{};
+		std::filesystem::create_directories(path.parent_path(), error);
+
+		std::filesystem::path temporary{ path };
+		temporary += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+
+		{
+			std::ofstream file{ temporary, std::ios::binary | std::ios::trunc };
+
+			FileHeader header{};
+			header.Magic = sMagic;
+			header.Version = sVersion;
+			header.Key = key;
+
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			WriteStage(file, stage);
+
+			if (!file)
+				return;
+		}
+
+		std::filesystem::rename(temporary, path, error);
+	}
+
+	/**
+	 * \brief Reads a stage written by WriteStage.
+	 * \return False when the stream ends before the stage does, the stage is left empty.
+	 */
+	b8 VkShaderCache::ReadStage(std::istream& stream, VkCompiledStage& stage)
+	{
+		StageHeader header{};
+		stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!stream)
+			return false;
+
+		stage.Spirv.resize(header.SpirvWords);
+		stream.read(reinterpret_cast<char*>(stage.Spirv.data()), static_cast<std::streamsize>(header.SpirvWords * sizeof(u32)));
+
+		stage.Resources.resize(header.ResourceCount);
+		for (auto& resource : stage.Resources)
+		{
+			u32 fields[6]{};
+			stream.read(reinterpret_cast<char*>(fields), sizeof(fields));
+
+			resource.Set = fields[0];
+			resource.Binding = fields[1];
+			resource.Type = static_cast<VkResourceType>(fields[2]);
+			resource.DescriptorType = static_cast<vk::DescriptorType>(fields[3]);
+			resource.Size = fields[4];
+			resource.Name.resize(fields[5]);
+			stream.read(resource.Name.data(), fields[5]);
+		}
+
+		stage.PushConstantSize = header.PushConstantSize;
+
+		if (!stream)
+		{
+			stage = {};
+			return false;
+		}
+
+		return true;
+	}
+
+	void VkShaderCache::WriteStage(std::ostream& stream, const VkCompiledStage& stage)
+	{
+		StageHeader header{};
+		header.SpirvWords = static_cast<u32>(stage.Spirv.size());
+		header.ResourceCount = static_cast<u32>(stage.Resources.size());
+		header.PushConstantSize = stage.PushConstantSize;
+
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		stream.write(reinterpret_cast<const char*>(stage.Spirv.data()), static_cast<std::streamsize>(stage.Spirv.size() * sizeof(u32)));
+
+		for (const auto& resource : stage.Resources)
+		{
+			const u32 fields[6]{ resource.Set, resource.Binding, static_cast<u32>(resource.Type), static_cast<u32>(resource.DescriptorType), resource.Size, static_cast<u32>(resource.Name.size()) };
+			stream.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+			stream.write(resource.Name.data(), static_cast<std::streamsize>(resource.Name.size()));
+		}
+	}
+
+	ShaderCacheStats VkShaderCache::Stats()
+	{
+		std::lock_guard lock{ sMutex };
+		return sStats;
+	}
+
+	void VkShaderCache::Record(const b8 hit, const f64 time)
+	{
+		std::lock_guard lock{ sMutex };
+		sStats.Stages++;
+		sStats.Hits += hit ? 1 : 0;
+		sStats.SetupTime += time;
+	}
+
+	std::filesystem::path VkShaderCache::FilePath(const u64 key)
+	{
+		char name[32]{};
+		std::snprintf(name, sizeof(name), "%016llx.spv", static_cast<unsigned long long>(key));
+
+		return std::filesystem::path{ sShaderCacheDirectory } / name;
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <filesystem>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "Core/Types.h"
+#include "Graphics/Rhi/Shader.h"
+
+namespace SnowEngine
+{
+	enum class VkResourceType : u32
+	{
+		Uniform,
+		Image,
+		StorageBuffer
+	};
+
+	struct VkReflectedResource
+	{
+		u32 Set;
+		u32 Binding;
+		VkResourceType Type;
+		vk::DescriptorType DescriptorType;
+		u32 Size;
+		std::string Name;
+	};
+
+	/** \brief Spir-v of a single stage together with what reflecting it found. */
+	struct VkCompiledStage
+	{
+		std::vector<u32> Spirv;
+		std::vector<VkReflectedResource> Resources;
+		u32 PushConstantSize{ 0 };
+	};
+
+	/**
+	 * \brief Content addressed cache of compiled stages. A stage is stored under a hash of its source, of every file it
+	 * includes, of its defines, of its stage and of the compiler, so a cached stage never needs shaderc nor SPIRV-Cross.
+	 */
+	class VkShaderCache
+	{
+	public:
+		VkShaderCache() = delete;
+
+		/** \param key Computed by VkShaderCompiler::Key. */
+		static b8 Load(u64 key, VkCompiledStage& stage);
+		static void Store(u64 key, const VkCompiledStage& stage);
+
+		/** \brief Serialized form of a stage, shared by the cache entries and the cooked shader bundle. */
+		static b8 ReadStage(std::istream& stream, VkCompiledStage& stage);
+		static void WriteStage(std::ostream& stream, const VkCompiledStage& stage);
+
+		static ShaderCacheStats Stats();
+		static void Record(b8 hit, f64 time);
+
+		static constexpr u32 sVersion{ 2 }; //bumped whenever the compile options, the reflection or the format change
+
+	private:
+		struct FileHeader
+		{
+			u32 Magic;
+			u32 Version;
+			u64 Key;
+		};
+
+		struct StageHeader
+		{
+			u32 SpirvWords;
+			u32 ResourceCount;
+			u32 PushConstantSize;
+		};
+
+		static std::filesystem::path FilePath(u64 key);
+
+		static std::mutex sMutex;
+		static ShaderCacheStats sStats;
+
+		static constexpr u32 sMagic{ 0x43535353 }; //"SSSC"
+	};
+}
@@ -0,0 +1,218 @@
+#include "VkShaderCompiler.h"
+
+#include <fstream>
+#include <iostream>
+#include <shaderc/shaderc.hpp>
+#include <spirv_cross/spirv_glsl.hpp>
+
+#include "Core/Hash.h"
+
+namespace SnowEngine
+{
+	static std::string ReadFile(const std::filesystem::path& path)
+	{
+		std::ifstream file{ path, std::ios::ate | std::ios::binary };
+		if (!file.is_open())
+			return "";
+		
+		const u64 fileSize{ static_cast<u64>(file.tellg()) };
+		std::string buffer(fileSize, ' ');
+
+		file.seekg(0);
+		file.read(buffer.data(), fileSize);
+
+		file.close();
+
+		return buffer;
+	}
+
+	/**
+	 * \brief Path of the file an include directive names, quoted includes are looked up next to the including file.
+	 */
+	static std::filesystem::path ResolveInclude(const std::filesystem::path& requesting, const std::string& name)
+	{
+		return (requesting.parent_path() / name).lexically_normal();
+	}
+
+	/**
+	 * \brief Appends every file the code includes, recursively, so the cache key changes when any of them does.
+	 */
+	static void CollectIncludes(const std::filesystem::path& path, const std::string& code, shaderSources& sources, const u32 depth)
+	{
+		if (depth >= 16)
+			return;
+
+		u64 position{ 0 };
+		while ((position = code.find("#include", position)) != std::string::npos)
+		{
+			position += 8;
+
+			const u64 begin{ code.find_first_of("\"<", position) };
+			const u64 lineEnd{ code.find('\n', position) };
+			if (begin == std::string::npos || begin > lineEnd)
+				continue;
+
+			const u64 end{ code.find_first_of("\">", begin + 1) };
+			if (end == std::string::npos || end > lineEnd)
+				continue;
+
+			const std::filesystem::path include{ ResolveInclude(path, code.substr(begin + 1, end - begin - 1)) };
+
+			b8 known{ false };
+			for (const auto& [source, text] : sources)
+				known |= source == include;
+
+			if (known)
+				continue;
+
+			sources.emplace_back(include, ReadFile(include));
+			CollectIncludes(include, sources.back().second, sources, depth + 1);
+		}
+	}
+
+	/**
+	 * \brief Resolves the includes of the shaders for shaderc, relative to the file requesting them.
+	 */
+	class Includer final : public shaderc::CompileOptions::IncluderInterface
+	{
+	public:
+		shaderc_include_result* GetInclude(const char* requestedSource, shaderc_include_type type, const char* requestingSource, size_t includeDepth) override
+		{
+			auto* include{ new Include{} };
+			include->Path = ResolveInclude(requestingSource, requestedSource).string();
+
+			//shaderc reports an include with an empty name as not found, the content is the error message
+			if (std::filesystem::exists(include->Path))
+				include->Code = ReadFile(include->Path);
+			else
+			{
+				include->Code = "Cannot open " + include->Path;
+				include->Path.clear();
+			}
+
+			include->Result.source_name = include->Path.c_str();
+			include->Result.source_name_length = include->Path.size();
+			include->Result.content = include->Code.c_str();
+			include->Result.content_length = include->Code.size();
+			include->Result.user_data = include;
+
+			return &include->Result;
+		}
+
+		void ReleaseInclude(shaderc_include_result* data) override
+		{
+			delete static_cast<Include*>(data->user_data);
+		}
+
+	private:
+		struct Include
+		{
+			shaderc_include_result Result{};
+			std::string Path;
+			std::string Code;
+		};
+	};
+
+	static shaderc_shader_kind GetShaderKind(const ShaderType type)
+	{
+		switch (type)
+		{
+			case ShaderType::Vertex: return shaderc_vertex_shader;
+			case ShaderType::Fragment: return shaderc_fragment_shader;
+			case ShaderType::Compute: return shaderc_compute_shader;
+			default: return shaderc_glsl_infer_from_source;
+		}
+	}
+
+	shaderSources VkShaderCompiler::Sources(const std::filesystem::path& path)
+	{
+		shaderSources sources{ { path, ReadFile(path) } };
+		CollectIncludes(path, sources.front().second, sources, 0);
+
+		return sources;
+	}
+
+	/**
+	 * \brief FNV-1a over the sources, the defines, the stage and the compiler.
+	 */
+	u64 VkShaderCompiler::Key(const shaderSources& sources, const ShaderType type, const std::vector<std::string>& defines)
+	{
+		Hasher hash;
+
+		u32 spirvVersion{ 0 };
+		u32 spirvRevision{ 0 };
+		shaderc_get_spv_version(&spirvVersion, &spirvRevision);
+
+		const u32 words[]{ VkShaderCache::sVersion, spirvVersion, spirvRevision, static_cast<u32>(type) };
+		hash.Mix(words);
+
+		for (const auto& define : defines)
+			hash.Mix(define);
+
+		for (const auto& [path, code] : sources)
+		{
+			hash.Mix(path.generic_string());
+			hash.Mix(code);
+		}
+
+		return hash.Get();
+	}
+
+	b8 VkShaderCompiler::Compile(const shaderSource& source, const std::string& code, const std::vector<std::string>& defines, VkCompiledStage& stage)
+	{
+		const auto& [path, type] = source;
+
+		//subgroup operations need spir-v 1.3, the device is created for vulkan 1.2 anyway
+		shaderc::CompileOptions options{};
+		options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
+		options.SetIncluder(std::make_unique<Includer>());
+		for (const auto& define : defines)
+			options.AddMacroDefinition(define);
+
+		const shaderc::Compiler compiler;
+		const shaderc::SpvCompilationResult result{ compiler.CompileGlslToSpv(code, GetShaderKind(type), path.string().c_str(), options) };
+		if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+		{
+			std::cerr << result.GetErrorMessage() << std::endl;
+			return false;
+		}
+
+		stage = {};
+		stage.Spirv = { result.cbegin(), result.cend() };
+		Reflect(stage);
+
+		return true;
+	}
+
+	void VkShaderCompiler::Reflect(VkCompiledStage& stage)
+	{
+		const spirv_cross::Compiler compiler{ stage.Spirv };
+		spirv_cross::ShaderResources resources{ compiler.get_shader_resources() };
+
+		const auto add = [&](const spirv_cross::Resource& resource, const VkResourceType type, const vk::DescriptorType descriptorType, const b8 sized)
+		{
+			VkReflectedResource& reflected{ stage.Resources.emplace_back() };
+			reflected.Set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+			reflected.Binding = compiler.get_decoration(resource.id, spv::DecorationBinding);
+			reflected.Type = type;
+			reflected.DescriptorType = descriptorType;
+			reflected.Size = sized ? static_cast<u32>(compiler.get_declared_struct_size(compiler.get_type(resource.base_type_id))) : 0;
+			reflected.Name = resource.name;
+		};
+
+		for (const auto& resource : resources.uniform_buffers)
+			add(resource, VkResourceType::Uniform, vk::DescriptorType::eUniformBufferDynamic, true);
+
+		for (const auto& resource : resources.sampled_images)
+			add(resource, VkResourceType::Image, vk::DescriptorType::eCombinedImageSampler, false);
+
+		for (const auto& resource : resources.storage_buffers)
+			add(resource, VkResourceType::StorageBuffer, vk::DescriptorType::eStorageBuffer, true);
+
+		for (const auto& resource : resources.push_constant_buffers)
+		{
+			const u32 size{ static_cast<u32>(compiler.get_declared_struct_size(compiler.get_type(resource.base_type_id))) };
+			stage.PushConstantSize = std::max(stage.PushConstantSize, size);
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "VkShaderCache.h"
+#include "Core/Types.h"
+#include "Graphics/Rhi/Shader.h"
+
+namespace SnowEngine
+{
+	using shaderSources = std::vector<std::pair<std::filesystem::path, std::string>>;
+
+	/**
+	 * \brief Glsl to spir-v compilation and reflection, the only part of the renderer depending on shaderc and
+	 * SPIRV-Cross. Left out of builds running on cooked shaders, it is also compiled into the shader cooker.
+	 */
+	class VkShaderCompiler
+	{
+	public:
+		VkShaderCompiler() = delete;
+
+		/** \brief Path and text of the source followed by every file it includes, recursively. */
+		static shaderSources Sources(const std::filesystem::path& path);
+		/** \brief Hash of everything the compiled stage depends on, used to address the shader cache. */
+		static u64 Key(const shaderSources& sources, ShaderType type, const std::vector<std::string>& defines);
+
+		/**
+		 * \brief Compiles and reflects a stage.
+		 * \return False when the stage failed to compile, the errors are logged.
+		 */
+		static b8 Compile(const shaderSource& source, const std::string& code, const std::vector<std::string>& defines, VkCompiledStage& stage);
+
+	private:
+		static void Reflect(VkCompiledStage& stage);
+	};
+}
@@ -1,32 +1,41 @@
 #include "VkSurface.h"
 
+#include <algorithm>
+
 #include "VkCore.h"
 #include "VkCommandBuffer.h"
+#include "Core/Input.h"
+#include "VkDescriptorAllocator.h"
+#include "VkUniformAllocator.h"
 
 namespace SnowEngine
 {
 	VkSurface* VkSurface::sBoundSurface{ nullptr };
 
-	VkSurface::VkSurface(std::shared_ptr<const Window> window)
-		: mWindow{std::move(window) }
+	VkSurface::VkSurface(std::shared_ptr<const Window> window, const u32 framesInFlight)
+		: mFramesInFlight{ std::clamp(framesInFlight, 1u, sMaxFramesInFlight) }, mWindow{ std::move(window) }
 	{
 		CreateSurface();
 		CreateSurfaceSettings();
 		CreateSwapchain();
 		CreateFrameData();
 		CreateSyncObjects();
+
+		VkCore::Get()->CreateUniformAllocator(mFramesInFlight);
 	}
 
 	u32 VkSurface::ImageCount() const { return mImageCount; }
 
+	u32 VkSurface::FramesInFlight() const { return mFramesInFlight; }
+
 	vk::Format VkSurface::Format() const { return mSurfaceFormat.format; }
 
 	std::vector<vk::ImageView> VkSurface::Views() const
 	{
 		std::vector<vk::ImageView> views;
-		views.reserve(mFrames.size());
-		for (const auto& frame : mFrames)
-			views.push_back(frame.ImageView);
+		views.reserve(mImages.size());
+		for (const auto& image : mImages)
+			views.push_back(image.ImageView);
 
 		return views;
 	}
@@ -37,42 +46,104 @@ namespace SnowEngine
 
 	std::shared_ptr<const Window> VkSurface::GetWindow() const { return mWindow; }
 
-	vk::Semaphore VkSurface::ImageAvailableSemaphore() const { return mFrames[mCurrentPresentFrame].ImageAvailable; }
+	vk::Semaphore VkSurface::ImageAvailableSemaphore() const { return mFrames[mCurrentFrame].ImageAvailable; }
 
-	u32 VkSurface::CurrentFrame() const { return mCurrentCpuFrame; }
+	vk::Semaphore VkSurface::RenderFinishedSemaphore() const { return mImages[mImageIndex].RenderFinished; }
 
-	void VkSurface::Begin()
+	u32 VkSurface::CurrentFrame() const { return mCurrentFrame; }
+
+	u32 VkSurface::ImageIndex() const { return mImageIndex; }
+
+	u32 VkSurface::SwapchainVersion() const { return mSwapchainVersion; }
+
+	LatencyMode VkSurface::GetLatencyMode() const { return mLatencyMode; }
+
+	b8 VkSurface::SupportsLatencyMode(const LatencyMode mode) const
 	{
-		sBoundSurface = this;
-		
-		try
+		return std::find(mPresentModes.begin(), mPresentModes.end(), GetPresentMode(mode)) != mPresentModes.end();
+	}
+
+	b8 VkSurface::SetLatencyMode(const LatencyMode mode)
+	{
+		if (!SupportsLatencyMode(mode))
+			return false;
+
+		mLatencyMode = mode;
+		ResetLatency();
+
+		if (GetPresentMode(mode) != mPresentMode)
 		{
-			vk::Result result = VkCore::Get()->Device().acquireNextImageKHR(mSwapchain, std::numeric_limits<u64>::max(), mFrames[mCurrentPresentFrame].ImageAvailable, nullptr, &mCurrentCpuFrame);
+			mPresentMode = GetPresentMode(mode);
+			Resize();
 		}
-		catch (const vk::OutOfDateKHRError&)
+
+		return true;
+	}
+
+	const LatencyStats& VkSurface::Latency() const { return mLatency; }
+
+	void VkSurface::ResetLatency() { mLatency = {}; }
+
+	void VkSurface::Pace()
+	{
+		if (mLatencyMode == LatencyMode::JustInTime)
 		{
-			Resize();
+			//End already moved to the next slot
+			const u32 previousFrame{ (mCurrentFrame + mFramesInFlight - 1) % mFramesInFlight };
+			if (const auto submitted{ mFrames[previousFrame].Submitted.lock() })
+				submitted->Wait(previousFrame);
 		}
 
+		mSampleTime = std::chrono::steady_clock::now();
+		mPaced = true;
+	}
+
+	void VkSurface::Begin()
+	{
+		sBoundSurface = this;
+
+		if (!mPaced)
+			mSampleTime = std::chrono::steady_clock::now();
+		mHasInput = Input::TakeFirstEvent(mInputTime);
+
+		if (const auto submitted{ mFrames[mCurrentFrame].Submitted.lock() })
+			submitted->Wait(mCurrentFrame);
+		VkCore::Get()->RetireFrame(mFramesInFlight);
+
+		AcquireImage();
+
 		FlushPostSubmitQueue();
+
+		VkCore::Get()->UniformAllocator().Reset(mCurrentFrame);
+		VkCore::Get()->DescriptorAllocator().Reset(mCurrentFrame);
 	}
 
 	void VkSurface::End(const std::shared_ptr<const CommandBuffer>& commandBuffer)
 	{
-		const auto waitSemaphore = std::static_pointer_cast<const VkCommandBuffer>(commandBuffer)->FinishedSemaphore(mCurrentCpuFrame);
+		const vk::Semaphore waitSemaphore{ mImages[mImageIndex].RenderFinished };
 
 		vk::PresentInfoKHR presentInfo;
 		presentInfo.waitSemaphoreCount = 1;
 		presentInfo.pWaitSemaphores = &waitSemaphore;
 		presentInfo.swapchainCount = 1;
 		presentInfo.pSwapchains = &mSwapchain;
-		presentInfo.pImageIndices = &mCurrentCpuFrame;
+		presentInfo.pImageIndices = &mImageIndex;
 
-		const vk::Result result = VkCore::Get()->Queues().Present.second.presentKHR(presentInfo);
-		if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR)
+		try
+		{
+			const vk::Result result = VkCore::Get()->Queues().Present.second.presentKHR(presentInfo);
+			if (result == vk::Result::eSuboptimalKHR)
+				Resize();
+		}
+		catch (const vk::OutOfDateKHRError&)
+		{
 			Resize();
+		}
+
+		MeasureLatency();
 
-		mCurrentPresentFrame = (mCurrentPresentFrame + 1) % mFrames.size() - 1;
+		mFrames[mCurrentFrame].Submitted = std::static_pointer_cast<const VkCommandBuffer>(commandBuffer);
+		mCurrentFrame = (mCurrentFrame + 1) % mFramesInFlight;
 
 		sBoundSurface = nullptr;
 	}
@@ -84,6 +155,33 @@ namespace SnowEngine
 
 	VkSurface* VkSurface::BoundSurface() { return sBoundSurface; }
 
+	vk::PresentModeKHR VkSurface::GetPresentMode(const LatencyMode mode)
+	{
+		switch (mode)
+		{
+		case LatencyMode::Fifo: return vk::PresentModeKHR::eFifo;
+		case LatencyMode::Mailbox: return vk::PresentModeKHR::eMailbox;
+		case LatencyMode::FifoRelaxed: return vk::PresentModeKHR::eFifoRelaxed;
+		case LatencyMode::JustInTime: return vk::PresentModeKHR::eFifo; //the pacing is done by Pace
+		}
+
+		return vk::PresentModeKHR::eFifo;
+	}
+
+	void VkSurface::AcquireImage()
+	{
+		try
+		{
+			const vk::Result result = VkCore::Get()->Device().acquireNextImageKHR(mSwapchain, std::numeric_limits<u64>::max(), mFrames[mCurrentFrame].ImageAvailable, nullptr, &mImageIndex);
+		}
+		catch (const vk::OutOfDateKHRError&)
+		{
+			//nothing was signalled, so the semaphore can be used again with the new swapchain
+			Resize();
+			AcquireImage();
+		}
+	}
+
 	void VkSurface::CreateSurface()
 	{
 		VkSurfaceKHR surface;
@@ -113,17 +211,9 @@ namespace SnowEngine
 			}
 		}
 
-		mPresentMode = vk::PresentModeKHR::eFifo;
-		for (const auto& presentMode : presentModes)
-		{
-			if (presentMode == vk::PresentModeKHR::eMailbox)
-			{
-				mPresentMode = presentMode;
-				break;
-			}
-		}
-
-		mImageCount = capabilities.minImageCount;
+		mPresentModes = presentModes;
+		mLatencyMode = SupportsLatencyMode(LatencyMode::Mailbox) ? LatencyMode::Mailbox : LatencyMode::Fifo;
+		mPresentMode = GetPresentMode(mLatencyMode);
 	}
 
 	void VkSurface::CreateSwapchain()
@@ -143,9 +233,14 @@ namespace SnowEngine
 		const std::vector<u32> qeues = { VkCore::Get()->Queues().Graphics.first, VkCore::Get()->Queues().Present.first };
 		const b8 sharedQueue{ qeues[0] == qeues[1] };
 
+		//at least one image per frame in flight, so acquiring does not hold back the frames the cpu may record ahead
+		u32 imageCount{ std::max(capabilities.minImageCount, mFramesInFlight) };
+		if (capabilities.maxImageCount)
+			imageCount = std::min(imageCount, capabilities.maxImageCount);
+
 		vk::SwapchainCreateInfoKHR createInfo{};
 		createInfo.surface = mSurface;
-		createInfo.minImageCount = mImageCount;
+		createInfo.minImageCount = imageCount;
 		createInfo.imageFormat = mSurfaceFormat.format;
 		createInfo.imageColorSpace = mSurfaceFormat.colorSpace;
 		createInfo.imageExtent = mExtent;
@@ -165,8 +260,9 @@ namespace SnowEngine
 
 	void VkSurface::CreateFrameData()
 	{
-		mFrames.resize(mImageCount);
+		//the implementation may create more images than requested
 		const auto images{ VkCore::Get()->Device().getSwapchainImagesKHR(mSwapchain) };
+		mImageCount = static_cast<u32>(images.size());
 
 		vk::ImageViewCreateInfo viewCreateInfo{};
 		viewCreateInfo.viewType = vk::ImageViewType::e2D;
@@ -181,15 +277,23 @@ namespace SnowEngine
 		viewCreateInfo.subresourceRange.baseArrayLayer = 0;
 		viewCreateInfo.subresourceRange.layerCount = 1;
 
-		u32 i{ 0 };
-		for (auto& frame : mFrames)
+		const vk::SemaphoreCreateInfo semaphoreCreateInfo{};
+
+		const u32 previousCount{ static_cast<u32>(mImages.size()) };
+		for (u32 i{ mImageCount }; i < previousCount; i++)
+			VkCore::Get()->Device().destroySemaphore(mImages[i].RenderFinished);
+
+		mImages.resize(mImageCount);
+		for (u32 i{ 0 }; i < mImageCount; i++)
 		{
-			frame.Image = images[i];
+			ImageData& image{ mImages[i] };
+			image.Image = images[i];
 
-			viewCreateInfo.image = frame.Image;
-			frame.ImageView = VkCore::Get()->Device().createImageView(viewCreateInfo);
+			viewCreateInfo.image = image.Image;
+			image.ImageView = VkCore::Get()->Device().createImageView(viewCreateInfo);
 
-			i++;
+			if (i >= previousCount)
+				image.RenderFinished = VkCore::Get()->Device().createSemaphore(semaphoreCreateInfo);
 		}
 	}
 
@@ -197,30 +301,60 @@ namespace SnowEngine
 	{
 		const vk::SemaphoreCreateInfo semaphoreCreateInfo{};
 
-		for (auto& [im, v, imageAvailable] : mFrames)
-			imageAvailable = VkCore::Get()->Device().createSemaphore(semaphoreCreateInfo);
+		mFrames.resize(mFramesInFlight);
+		for (auto& frame : mFrames)
+			frame.ImageAvailable = VkCore::Get()->Device().createSemaphore(semaphoreCreateInfo);
 	}
 
 	void VkSurface::FlushPostSubmitQueue()
 	{
 		for (u32 i{ 0 }; i < mPostSubmitQueue.size(); i++) {
 			auto& [count, func] = mPostSubmitQueue[i];
-			func(mCurrentCpuFrame);
+			func(mCurrentFrame);
 			count++;
-			if (count == mImageCount) {
+			if (count == mFramesInFlight) {
 				mPostSubmitQueue.erase(mPostSubmitQueue.begin() + i);
 				i--;
 			}
 		}
 	}
 
+	/**
+	 * \brief Adds the frame that was just queued for presentation to the latency statistics. Queueing is the last point
+	 * visible without present timing extensions, the time the image waits for the display is not included.
+	 */
+	void VkSurface::MeasureLatency()
+	{
+		const auto presented{ std::chrono::steady_clock::now() };
+		const auto milliseconds = [presented](const std::chrono::steady_clock::time_point time)
+		{
+			return std::chrono::duration<f64, std::milli>(presented - time).count();
+		};
+
+		mLatency.Frames++;
+		mLatency.SampleToPresent += (milliseconds(mSampleTime) - mLatency.SampleToPresent) / mLatency.Frames;
+
+		if (mHasInput)
+		{
+			const f64 latency{ milliseconds(mInputTime) };
+			mLatency.InputFrames++;
+			mLatency.InputToPresent += (latency - mLatency.InputToPresent) / mLatency.InputFrames;
+			mLatency.MaxInputToPresent = std::max(mLatency.MaxInputToPresent, latency);
+		}
+
+		mPaced = false;
+	}
+
 	void VkSurface::Resize()
 	{
 		VkCore::Get()->Device().waitIdle();
 
+		for (const auto& image : mImages)
+			VkCore::Get()->Device().destroyImageView(image.ImageView);
 		VkCore::Get()->Device().destroySwapchainKHR(mSwapchain);
 
 		CreateSwapchain();
 		CreateFrameData();
+		mSwapchainVersion++;
 	}
 }
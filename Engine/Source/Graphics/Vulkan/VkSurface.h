@@ -1,4 +1,5 @@
 #pragma once
+#include <chrono>
 #include <functional>
 #include <vulkan/vulkan.hpp>
 #include "Graphics/Rhi/Surface.h"
@@ -6,13 +7,18 @@
 
 namespace SnowEngine
 {
+	class VkCommandBuffer;
+
 	class VkSurface : public Surface
 	{
 	public:
-		VkSurface(std::shared_ptr<const Window> window);
+		VkSurface(std::shared_ptr<const Window> window, u32 framesInFlight);
 
 		u32 ImageCount() const override;
+		u32 FramesInFlight() const override;
 		u32 CurrentFrame() const override;
+		u32 ImageIndex() const; //swapchain image acquired by Begin
+		u32 SwapchainVersion() const; //changes every time the swapchain and its views are recreated
 
 		u32 Width() const;
 		u32 Height() const;
@@ -20,7 +26,15 @@ namespace SnowEngine
 		std::vector<vk::ImageView> Views() const;
 		std::shared_ptr<const Window> GetWindow() const;
 		vk::Semaphore ImageAvailableSemaphore() const;
+		vk::Semaphore RenderFinishedSemaphore() const;
+
+		LatencyMode GetLatencyMode() const override;
+		b8 SupportsLatencyMode(LatencyMode mode) const override;
+		b8 SetLatencyMode(LatencyMode mode) override;
+		const LatencyStats& Latency() const override;
+		void ResetLatency() override;
 
+		void Pace() override;
 		void Begin() override;
 		void End(const std::shared_ptr<const CommandBuffer>& commandBuffer) override;
 
@@ -29,29 +43,51 @@ namespace SnowEngine
 		static VkSurface* BoundSurface();
 
 	private:
+		static vk::PresentModeKHR GetPresentMode(LatencyMode mode);
+
 		void CreateSurface();
 		void CreateSurfaceSettings();
 		void CreateSwapchain();
 		void CreateFrameData();
 		void CreateSyncObjects();
+		void AcquireImage();
 		void FlushPostSubmitQueue();
 		void Resize();
+		void MeasureLatency();
 
-		struct FrameData
+		//presentation of an image waits on its own semaphore, it can still be pending when the frame slot comes around again
+		struct ImageData
 		{
 			vk::Image Image;
 			vk::ImageView ImageView;
+			vk::Semaphore RenderFinished;
+		};
+
+		//the acquire semaphore is reused once the submission that waited on it has completed
+		struct FrameData
+		{
 			vk::Semaphore ImageAvailable;
+			std::weak_ptr<const VkCommandBuffer> Submitted;
 		};
 
+		std::vector<ImageData> mImages;
 		std::vector<FrameData> mFrames;
 		vk::SurfaceKHR mSurface;
+		std::vector<vk::PresentModeKHR> mPresentModes;
 		vk::PresentModeKHR mPresentMode;
+		LatencyMode mLatencyMode{ LatencyMode::Fifo };
+		LatencyStats mLatency{};
+		std::chrono::steady_clock::time_point mSampleTime{};
+		std::chrono::steady_clock::time_point mInputTime{};
+		b8 mPaced{ false };
+		b8 mHasInput{ false }; //the current frame read input events, the first one arrived at mInputTime
 		vk::SurfaceFormatKHR mSurfaceFormat;
 		vk::Extent2D mExtent;
 		u32 mImageCount;
-		u32 mCurrentPresentFrame{ 0 };
-		u32 mCurrentCpuFrame;
+		u32 mFramesInFlight;
+		u32 mCurrentFrame{ 0 };
+		u32 mImageIndex{ 0 };
+		u32 mSwapchainVersion{ 0 };
 		vk::SwapchainKHR mSwapchain;
 		std::shared_ptr<const Window> mWindow;
 		std::vector<std::pair<u32, std::function<void(u32 frameIndex)>>> mPostSubmitQueue;
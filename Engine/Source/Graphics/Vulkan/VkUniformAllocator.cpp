@@ -0,0 +1,50 @@
+#include "VkUniformAllocator.h"
+
+#include <algorithm>
+
+#include "VkCore.h"
+#include "Core/Logger.h"
+
+namespace SnowEngine
+{
+	VkUniformAllocator::VkUniformAllocator(const u32 frameSize, const u32 frameCount)
+		: VkBuffer(frameSize * frameCount, vk::BufferUsageFlagBits::eUniformBuffer, VMA_MEMORY_USAGE_CPU_TO_GPU),
+		  mFrameSize{ frameSize }, mFrameCount{ frameCount }
+	{
+		mAlignment = static_cast<u32>(VkCore::Get()->PhysicalDevice().getProperties().limits.minUniformBufferOffsetAlignment);
+	}
+
+	u32 VkUniformAllocator::Alignment() const { return mAlignment; }
+
+	void VkUniformAllocator::Reset(const u32 frameIndex)
+	{
+		mFrameStart = (frameIndex % mFrameCount) * mFrameSize;
+		mHead = mFrameStart;
+		mOverflowed = false;
+	}
+
+	/**
+	 * \brief Copies data into the current frame region, sizes are rounded up to the alignment so every offset handed out
+	 * stays aligned without synchronizing the threads.
+	 * \return The offset of the data inside the buffer, to be used as a dynamic offset.
+	 */
+	u32 VkUniformAllocator::Allocate(const void* data, const u32 size)
+	{
+		const u32 alignedSize{ (size + mAlignment - 1) & ~(mAlignment - 1) };
+		const u32 offset{ mHead.fetch_add(alignedSize) };
+
+		//live uniforms of the frame are never overwritten, the overflowing ones clobber each other in the last block
+		const u32 overflowStart{ mFrameStart + mFrameSize - sOverflowSize };
+		if (offset + size > overflowStart)
+		{
+			if (!mOverflowed.exchange(true))
+				LOG_ERROR("Uniform allocator out of memory: %u bytes requested, the frame region holds %u bytes", size, mFrameSize - sOverflowSize);
+
+			Write(data, std::min(size, sOverflowSize), overflowStart);
+			return overflowStart;
+		}
+
+		Write(data, size, offset);
+		return offset;
+	}
+}
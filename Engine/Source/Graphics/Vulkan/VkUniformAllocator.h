@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+#include <vulkan/vulkan.hpp>
+
+#include "VkBuffers.h"
+#include "Core/Types.h"
+
+namespace SnowEngine
+{
+	/**
+	 * \brief Linear per-frame allocator for uniform data, bound through dynamic offsets.
+	 * Every frame in flight owns a region of a single host-visible buffer which is rewound when the frame begins,
+	 * so uniform data only lives for the frame it was written in and a set must be given its uniforms again every frame
+	 * it is bound in. Allocating is lock free, sets are updated from the recording threads.
+	 */
+	class VkUniformAllocator : public VkBuffer
+	{
+	public:
+		VkUniformAllocator(u32 frameSize, u32 frameCount);
+
+		u32 Alignment() const;
+
+		void Reset(u32 frameIndex);
+		/** \brief Data that does not fit in the region is reported and written to a block shared by every such allocation. */
+		u32 Allocate(const void* data, u32 size);
+
+	private:
+		u32 mFrameSize;
+		u32 mFrameCount;
+		u32 mAlignment;
+		u32 mFrameStart{ 0 };
+		std::atomic<u32> mHead{ 0 };
+		std::atomic<b8> mOverflowed{ false }; //reported once per frame
+
+		static constexpr u32 sOverflowSize{ 64 * 1024 }; //kept at the end of every region, the largest uniform range devices offer
+	};
+}
@@ -4,12 +4,23 @@
 #include "Core/Input.h"
 #include "Core/Logger.h"
 #include "Core/Scene.h"
+#include "Core/ThreadPool.h"
 #include "Core/Window.h"
 
+#include "Graphics/Compute/Histogram.h"
+#include "Graphics/Compute/PrefixSum.h"
+#include "Graphics/Compute/RadixSort.h"
+#include "Graphics/Compute/StreamCompaction.h"
+#include "Graphics/ClusteredLighting.h"
+#include "Graphics/DynamicResolution.h"
+#include "Graphics/ParticleSystem.h"
+#include "Graphics/ShadowMaps.h"
+#include "Graphics/RenderGraph.h"
 #include "Graphics/SceneRenderer.h"
 #include "Graphics/Rhi/Buffers.h"
 #include "Graphics/Rhi/Core.h"
 #include "Graphics/Rhi/DescriptorSet.h"
+#include "Graphics/Rhi/GeometryPool.h"
 #include "Graphics/Rhi/Gui.h"
 #include "Graphics/Rhi/Image.h"
 #include "Graphics/Rhi/Pipeline.h"
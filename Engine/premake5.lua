@@ -48,3 +48,13 @@ project "SnowEngine"
             "%{VULKAN_SDK}/Lib/spirv-cross-glsl.lib",
         }
 
+    --shaders come precompiled from the bundle written by the shader cooker, shaderc and SPIRV-Cross are not linked
+    filter "configurations:Shipping"
+        defines { "NDEBUG", "SNOW_COOKED_SHADERS" }
+        optimize "On"
+        dependson { "ShaderCooker" }
+        removefiles { "Source/Graphics/Vulkan/VkShaderCompiler.cpp" }
+        prebuildcommands
+        {
+            '"%{wks.location}/bin/%{cfg.buildcfg}/ShaderCooker" "%{prj.location}/Resources/Shaders" "%{prj.location}/Cache/Shaders.bundle"',
+        }
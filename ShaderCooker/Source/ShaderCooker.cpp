@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "Core/Types.h"
+#include "Graphics/Vulkan/VkShaderBundle.h"
+#include "Graphics/Vulkan/VkShaderCompiler.h"
+
+using namespace SnowEngine;
+
+static b8 GetShaderType(const std::filesystem::path& path, ShaderType& type)
+{
+	const std::string extension{ path.extension().string() };
+	if (extension == ".vert")
+		type = ShaderType::Vertex;
+	else if (extension == ".frag")
+		type = ShaderType::Fragment;
+	else if (extension == ".comp")
+		type = ShaderType::Compute;
+	else
+		return false;
+
+	return true;
+}
+
+/**
+ * \brief Define sets the stage is cooked with, the plain stage followed by one set for every "//cook:" line listing
+ * the macros of a variant.
+ */
+static std::vector<std::vector<std::string>> GetVariants(const std::string& code)
+{
+	std::vector<std::vector<std::string>> variants{ {} };
+
+	std::istringstream lines{ code };
+	for (std::string line; std::getline(lines, line);)
+	{
+		if (!line.starts_with("//cook:"))
+			continue;
+
+		std::istringstream defines{ line.substr(7) };
+		auto& variant{ variants.emplace_back() };
+		for (std::string define; defines >> define;)
+			variant.push_back(define);
+	}
+
+	return variants;
+}
+
+/**
+ * \brief Compiles every stage of a directory ahead of time into the shader bundle loaded by builds defining
+ * SNOW_COOKED_SHADERS.
+ * Usage: ShaderCooker <shader directory> <bundle>
+ */
+int main(int argc, char** argv)
+{
+	if (argc != 3)
+	{
+		std::cerr << "Usage: ShaderCooker <shader directory> <bundle>" << std::endl;
+		return 1;
+	}
+
+	const std::filesystem::path directory{ argv[1] };
+	const std::filesystem::path bundle{ argv[2] };
+
+	std::vector<std::filesystem::path> paths{};
+	for (const auto& entry : std::filesystem::directory_iterator{ directory })
+	{
+		if (ShaderType type{}; entry.is_regular_file() && GetShaderType(entry.path(), type))
+			paths.push_back(entry.path());
+	}
+
+	//sorted so cooking the same sources always yields the same bundle
+	std::sort(paths.begin(), paths.end());
+
+	std::vector<std::pair<u64, VkCompiledStage>> stages{};
+	b8 failed{ false };
+	for (const auto& path : paths)
+	{
+		ShaderType type{};
+		GetShaderType(path, type);
+
+		const shaderSources sources{ VkShaderCompiler::Sources(path) };
+		for (const auto& defines : GetVariants(sources.front().second))
+		{
+			VkCompiledStage stage{};
+			if (!VkShaderCompiler::Compile({ path, type }, sources.front().second, defines, stage))
+			{
+				std::cerr << "Failed to cook " << path.filename().string() << std::endl;
+				failed = true;
+				continue;
+			}
+
+			stages.emplace_back(VkShaderBundle::Key(path, type, defines), std::move(stage));
+		}
+	}
+
+	if (failed)
+		return 1;
+
+	if (!VkShaderBundle::Write(bundle, stages))
+	{
+		std::cerr << "Failed to write " << bundle.string() << std::endl;
+		return 1;
+	}
+
+	std::cout << "Cooked " << stages.size() << " stages into " << bundle.string() << std::endl;
+	return 0;
+}
@@ -0,0 +1,46 @@
+project "ShaderCooker"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++20"
+
+    targetdir "%{wks.location}/bin/%{cfg.buildcfg}"
+    objdir "%{wks.location}/bin/%{cfg.buildcfg}/obj"
+
+    VULKAN_SDK = os.getenv("VULKAN_SDK")
+
+    --only the compilation half of the renderer, the cooker never creates a device
+    files
+    {
+        "Source/**.h",
+        "Source/**.cpp",
+        "../Engine/Source/Graphics/Vulkan/VkShaderBundle.cpp",
+        "../Engine/Source/Graphics/Vulkan/VkShaderCache.cpp",
+        "../Engine/Source/Graphics/Vulkan/VkShaderCompiler.cpp",
+    }
+
+    includedirs
+    {
+        "../Engine/Source/",
+        "Source/",
+        "%{VULKAN_SDK}/Include/",
+    }
+
+    filter "configurations:Debug"
+        defines { "DEBUG" }
+        symbols "On"
+        links
+        {
+            "%{VULKAN_SDK}/Lib/shaderc_sharedd.lib",
+            "%{VULKAN_SDK}/Lib/spirv-cross-cored.lib",
+            "%{VULKAN_SDK}/Lib/spirv-cross-glsld.lib",
+        }
+
+    filter "configurations:Release or Shipping"
+        defines { "NDEBUG" }
+        optimize "On"
+        links
+        {
+            "%{VULKAN_SDK}/Lib/shaderc_shared.lib",
+            "%{VULKAN_SDK}/Lib/spirv-cross-core.lib",
+            "%{VULKAN_SDK}/Lib/spirv-cross-glsl.lib",
+        }
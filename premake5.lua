@@ -1,9 +1,10 @@
 workspace "SnowEngine"
     architecture "x64"
-    configurations { "Debug", "Release" }
+    configurations { "Debug", "Release", "Shipping" }
 
 include "Engine"
 include "Editor"
+include "ShaderCooker"
 
 group "External"
     include "Engine/External/glfw"